@@ -1,496 +1,626 @@
-/**
- * 
- * @file   Ploter.h
- * @author c T
- * @brief  f[^ROtŕ\B
- * 
- *///---------------------------------------------------------------------------
-#if 0
-#define     _WIN32_WINNT    0x0400
-#endif
-#include    "Ploter/Ploter.h"
-#include    "Resource/ResForm.h"
-
-
-LRESULT  CALLBACK  mainWindowProcedure( HWND,  UINT,  WPARAM,  LPARAM );
-
-
-/**
- *
- * @brief t@C_CAȌi[B
- *
- *///---------------------------------------------------------------------------
-struct FileDialogInfo {
-    
-    const char*    mFilterList;          //  tB^XgB
-    const char*    mDefaultExtension;    //  gqB
-    const char*    mTitle;               //  _CAÕ^CgB
-};
-
-
-namespace {
-    
-    HINSTANCE    current;        //  ݂̃vZX̃CX^XnhB
-    int          commandShow;    //  EBhȄԁB
-    
-    
-    const FileDialogInfo    openPlotFile  =  {
-        
-        "f[^t@C(*.txt)\0*.txt\0*.*\0*.*\0\0",
-        "txt",
-        "t@CJ"
-    };
-}
-
-
-/**
- *
- * @brief G[bZ[W`B
- *
- *///---------------------------------------------------------------------------
-class Exception {
-    
-  public:
-    
-    Exception( const std::string&  type,   const std::string&  cause )  :
-        
-        mMessage( "Error : "  +  type  +  "  --  "  +  cause )
-    {}
-    
-    
-    BOOL  operator ()( void ) const {
-        
-        MessageBox( 0,  mMessage.c_str(),  "Error",  MB_OK );
-        
-        return  FALSE;
-    }
-    
-  private:
-    
-    std::string    mMessage;     //  G[bZ[WB
-};
-
-
-/**
- *
- * @brief EBhE`B
- *
- *///---------------------------------------------------------------------------
-class Window {
-    
-  public:
-    
-    Window( WNDPROC  windowProcedure,   const char*  menuName,   const char*  className )  throw( Exception )  :
-        
-        mMenuName ( menuName  ),
-        mClassName( className )
-    {
-        WNDCLASSEX     windowClass;
-        
-        
-        windowClass.cbSize         =  sizeof( WNDCLASSEX );
-        windowClass.style          =  CS_HREDRAW  |  CS_VREDRAW;
-        windowClass.lpfnWndProc    =  windowProcedure;
-        windowClass.cbClsExtra     =  0;
-        windowClass.cbWndExtra     =  0;
-        windowClass.hInstance      =  ::current;
-        windowClass.hbrBackground  =  static_cast< HBRUSH >( GetStockObject( WHITE_BRUSH ) );
-        windowClass.lpszMenuName   =  static_cast< LPCSTR >( mMenuName                     );
-        windowClass.lpszClassName  =  static_cast< LPCSTR >( mClassName                    );
-        
-        
-        windowClass.hIcon = static_cast<HICON>(
-            
-            LoadImage(
-                
-                0,
-                MAKEINTRESOURCE(IDI_APPLICATION),
-                IMAGE_ICON,
-                0,0,
-                LR_DEFAULTSIZE | LR_SHARED
-            )
-        );
-        windowClass.hCursor = static_cast<HCURSOR>(
-            
-            LoadImage(
-                
-                0,
-                MAKEINTRESOURCE(IDC_ARROW),
-                IMAGE_CURSOR,
-                0,0,
-                LR_DEFAULTSIZE | LR_SHARED
-            )
-        );
-        windowClass.hIconSm = static_cast<HICON>(
-            
-            LoadImage(
-                
-                0,
-                MAKEINTRESOURCE(IDI_APPLICATION),
-                IMAGE_ICON,
-                0,0,
-                LR_DEFAULTSIZE | LR_SHARED
-            )
-        );
-        
-        
-        if ( ! RegisterClassEx( &windowClass ) ) {
-            
-            throw  Exception( "EBhENXsłB",  mClassName );
-        }
-    }
-    
-    
-    void  create( const char*  title,   std::size_t  width,   std::size_t  height ) const throw( Exception ) {
-        
-        HWND    window(
-            
-            CreateWindow(
-                
-                mClassName,
-                title,
-                WS_OVERLAPPEDWINDOW,
-                CW_USEDEFAULT,
-                CW_USEDEFAULT,
-                width,
-                height,
-                0,
-                0,
-                ::current,
-                0
-            )
-        );
-        
-        
-        if ( ! window ) {
-            
-            throw  Exception( "EBhEɎs܂B",  mClassName );
-        }
-        
-        
-        ShowWindow  ( window,  ::commandShow );
-        UpdateWindow( window                 );
-    }
-    
-  private:
-    
-    const char*    mMenuName;       //  j[\[X̖OB
-    const char*    mClassName;      //  EBhENX̖OB
-};
-
-
-/**
- *
- * @brief OpenGLp̃_OReLXg`B
- *
- *///---------------------------------------------------------------------------
-class OpenGL {
-    
-  public:
-    
-    OpenGL( void ) {
-        
-        memset( &mPixelFormat,  0,  sizeof( PIXELFORMATDESCRIPTOR ) );
-        
-        
-        mPixelFormat.nSize       =  sizeof( PIXELFORMATDESCRIPTOR );
-        mPixelFormat.nVersion    =  1;
-        mPixelFormat.dwFlags     =  PFD_DRAW_TO_WINDOW  |  PFD_SUPPORT_OPENGL  |  PFD_DOUBLEBUFFER;
-        mPixelFormat.iPixelType  =  PFD_TYPE_RGBA;
-        mPixelFormat.cColorBits  =  24;
-        mPixelFormat.iLayerType  =  PFD_MAIN_PLANE;
-    }
-    
-    
-    HGLRC  operator ()( HDC  deviceContext ) const {
-        
-        SetPixelFormat(
-            
-            deviceContext,
-            ChoosePixelFormat( deviceContext,  &mPixelFormat ),
-            &mPixelFormat
-        );
-        
-        return  wglCreateContext( deviceContext );
-    }
-    
-  private:
-    
-    PIXELFORMATDESCRIPTOR    mPixelFormat;    //  sNZtH[}bg̐ݒB
-};
-
-
-/**
- *
- * @brief t@C_CAO`B
- *
- *///---------------------------------------------------------------------------
-class FileDialogBase {
-    
-  public:
-    
-    const char*  getFilePath( void ) const {
-        
-        return  mFilePath;
-    }
-    
-  protected:
-    
-    FileDialogBase( HWND  window,   DWORD  flags,   const FileDialogInfo&  info ) {
-        
-        memset( &mOpenFileName,  0,  sizeof( OPENFILENAME ) );
-        
-        
-        mOpenFileName.lStructSize     =  sizeof( OPENFILENAME );
-        mOpenFileName.hwndOwner       =  window;
-        mOpenFileName.lpstrFilter     =  info.mFilterList;
-        mOpenFileName.lpstrFile       =  mFilePath;
-        mOpenFileName.lpstrFileTitle  =  mFileTitle;
-        mOpenFileName.nMaxFile        =  MAX_PATH;
-        mOpenFileName.nMaxFileTitle   =  MAX_PATH;
-        mOpenFileName.hInstance       =  0;
-        mOpenFileName.lpfnHook        =  0;
-        mOpenFileName.Flags           =  flags;
-        mOpenFileName.lpstrDefExt     =  info.mDefaultExtension;
-        mOpenFileName.lpstrTitle      =  info.mTitle;
-        
-        
-      #if( _WIN32_WINNT  >=  0x0500 )
-        
-        mOpenFileName.pvReserved  =  0;
-        
-      #endif
-    }
-    
-    
-    void  initialize( void ) {
-        
-        *mFilePath   =  0;
-        *mFileTitle  =  0;
-    }
-    
-    
-    OPENFILENAME    mOpenFileName;      //  t@C_CAOB
-    char            mFilePath [257];    //  t@C̃pXB
-    char            mFileTitle[257];    //  t@C̃^CgB
-};
-
-
-/**
- *
- * @brief I[vt@C_CAO`B
- *
- *///---------------------------------------------------------------------------
-class OpenFileDialog  :  public FileDialogBase {
-    
-  public:
-    
-    OpenFileDialog( HWND  window,   const FileDialogInfo&  info )  :
-        
-        FileDialogBase(
-            
-            window,
-            OFN_HIDEREADONLY | OFN_FILEMUSTEXIST,
-            info
-        )
-    {}
-    
-    
-    bool  operator ()( void ) {
-        
-        initialize();
-        
-        return  GetOpenFileName( &mOpenFileName );
-    }
-};
-
-
-/**
- *
- * @brief C`B
- *
- *///---------------------------------------------------------------------------
-class Main {
-    
-  public:
-    
-    Main( void )  :  mMainWindow( mainWindowProcedure,  "IDM_MENU",  "main" ) {
-        
-        mMainWindow.create( "OpenGL 3D Graph",  640, 480 );
-    }
-    
-    
-    int  operator ()( void ) {
-        
-        try                            {  sendMessage();  }
-        catch( Exception&  exception ) {  exception  ();  }
-        
-        return  static_cast<int>( mMessage.wParam );
-    }
-    
-  private:
-    
-    void  sendMessage( void ) {
-        
-        while ( isLoop() ) {
-            
-            TranslateMessage( &mMessage );
-            DispatchMessage ( &mMessage );
-        }
-    }
-    
-    
-    BOOL  getMessege( void ) {
-        
-        return  mState = GetMessage( &mMessage,  0,0,0 );
-    }
-    
-    
-    BOOL  isLoop( void ) throw( Exception ) {
-        
-        if ( getMessege() == -1 ) {
-            
-            throw  Exception( "bZ[Wsł",  "-1" );
-        }
-        
-        return  mState;
-    }
-    
-    
-    MSG       mMessage;      //  bZ[WB
-    BOOL      mState;        //  bZ[W擾̏ԁB
-    Window    mMainWindow;   //  CEBhEB
-};
-
-
-/**
- *
- * @brief CEBhẼvV[W`B
- *
- *///---------------------------------------------------------------------------
-class MainWindowProcedure {
-    
-  public:
-    
-    MainWindowProcedure( HWND  window )  :
-        
-        mWindow          ( window                     ),
-        mDeviceContext   ( GetDC   ( mWindow        ) ),
-        mRenderingContext( OpenGL()( mDeviceContext ) )
-    {
-        paint();
-    }
-    
-    
-    LRESULT  operator ()( UINT  message,   WPARAM  wParameter,   LPARAM  lParameter ) {
-        
-        switch ( message ) {
-            
-          case  WM_PAINT   : paint  ();              break;
-          case  WM_SIZE    : size   ();              break;
-          case  WM_DESTROY : destroy();              break;
-          case  WM_COMMAND : command( wParameter );  break;
-            
-          default:
-            
-            return  DefWindowProc( mWindow,  message,  wParameter,  lParameter );
-        }
-        
-        return  0;
-    }
-    
-  private:
-    
-    void  command( WPARAM  wParameter ) {
-        
-        switch ( LOWORD( wParameter ) ) {
-            
-          case  IDM_OPEN : open();  break;
-          case  IDM_EXIT : exit();  break;
-            
-        }
-    }
-    
-    
-    void  paint( void ) {
-        
-        PAINTSTRUCT  paint;    //  `B
-        
-        BeginPaint( mWindow,  &paint );  {
-            
-            wglMakeCurrent( mDeviceContext,  mRenderingContext );
-            SwapBuffers   ( mDeviceContext                     );
-            
-        }  EndPaint( mWindow,  &paint );
-    }
-    
-    
-    void  size( void ) {
-        
-        GetClientRect ( mWindow,                 &mClientTerritory       );
-        mPloter.resize( mClientTerritory.right,  mClientTerritory.bottom );
-    }
-    
-    
-    void  destroy( void ) const {
-        
-        wglMakeCurrent  ( 0,0                      );
-        wglDeleteContext( mRenderingContext        );
-        ReleaseDC       ( mWindow,  mDeviceContext );
-        PostQuitMessage ( 0                        );
-    }
-    
-    
-    void  open( void ) {
-        
-        OpenFileDialog  openPlotFile( mWindow, ::openPlotFile );    //  vbgt@CJB
-        
-        if ( openPlotFile() ) {
-            
-            mPloter.set( openPlotFile.getFilePath() );
-            
-            this->size(); SendMessage( mWindow, WM_PAINT, 0,0 );
-        }
-    }
-    
-    
-    void  exit( void ) const {
-        
-        SendMessage( mWindow,  WM_DESTROY,  0, 0 );
-    }
-    
-    
-    HWND            mWindow;              //  EBhEnhB
-    HDC             mDeviceContext;       //  foCXReLXgnhB
-    HGLRC           mRenderingContext;    //  _OReLXgnhB
-    RECT            mClientTerritory;     //  NCAg͈̈̔́B
-    Ploter::Ploter  mPloter;              //  `ΏہB
-};
-
-
-/**
- *
- * @brief C֐B
- *
- *///---------------------------------------------------------------------------
-int  WINAPI  WinMain( HINSTANCE  current,   HINSTANCE,   LPSTR,   int  commandShow ) {
-    
-    ::current      =  current;
-    ::commandShow  =  commandShow;
-    
-    try                            {  return  Main()();     }
-    catch( Exception&  exception ) {  return  exception();  }
-}
-
-
-/**
- *
- * @brief CEBhẼEBhEvV[WB
- *
- *///---------------------------------------------------------------------------
-LRESULT  CALLBACK  mainWindowProcedure( HWND  window,   UINT  message,   WPARAM  wParameter,   LPARAM  lParameter ) {
-    
-    static  MainWindowProcedure    procedure( window );
-    
-    return  procedure( message,  wParameter,  lParameter );
-}
+/**
+ * 
+ * @file   Ploter.h
+ * @author 村田 裕一
+ * @brief  データを３次元グラフで表示する。
+ * 
+ *///---------------------------------------------------------------------------
+#if 0
+#define     _WIN32_WINNT    0x0400
+#endif
+#include    "Ploter/Ploter.h"
+#include    "Ploter/GLRenderSink.h"
+#include    "Resource/ResForm.h"
+
+
+LRESULT  CALLBACK  mainWindowProcedure( HWND,  UINT,  WPARAM,  LPARAM );
+
+
+/**
+ *
+ * @brief ファイルダイアログの情報を格納する。
+ *
+ *///---------------------------------------------------------------------------
+struct FileDialogInfo {
+    
+    const char*    mFilterList;          //  フィルタリスト。
+    const char*    mDefaultExtension;    //  初期拡張子。
+    const char*    mTitle;               //  ダイアログのタイトル。
+};
+
+
+namespace {
+    
+    HINSTANCE    current;        //  現在のプロセスのインスタンスハンドル。
+    int          commandShow;    //  ウィンドウの状態。
+    
+    const UINT   WM_OPTION_CHANGED  =  WM_APP + 1;    //  オプションファイルが更新されたことを表すメッセージ。
+    const UINT   WM_REFINED         =  WM_APP + 2;    //  グラフを1段細かくし終えたことを表すメッセージ。wParamは依頼の番号。
+    const UINT   REFINE_TIMER       =  1;             //  グラフを段階的に細かく描き直し始めるタイマの識別子。
+    const UINT   REFINE_DELAY       =  300;           //  ウィンドウの大きさが変わらなくなってから細かくし始めるまでの時間[ms]。
+    
+    
+    const FileDialogInfo    openPlotFile  =  {
+        
+        "データファイル(*.txt;*.3dg)\0*.txt;*.3dg\0*.*\0*.*\0\0",
+        "txt",
+        "ファイルを開く"
+    };
+}
+
+
+/**
+ *
+ * @brief エラーメッセージを定義。
+ *
+ *///---------------------------------------------------------------------------
+class Exception {
+    
+  public:
+    
+    Exception( const std::string&  type,   const std::string&  cause )  :
+        
+        mMessage( "Error : "  +  type  +  "  --  "  +  cause )
+    {}
+    
+    
+    BOOL  operator ()( void ) const {
+        
+        MessageBox( 0,  mMessage.c_str(),  "Error",  MB_OK );
+        
+        return  FALSE;
+    }
+    
+  private:
+    
+    std::string    mMessage;     //  エラーメッセージ。
+};
+
+
+/**
+ *
+ * @brief ウィンドウを定義。
+ *
+ *///---------------------------------------------------------------------------
+class Window {
+    
+  public:
+    
+    Window( WNDPROC  windowProcedure,   const char*  menuName,   const char*  className )  throw( Exception )  :
+        
+        mMenuName ( menuName  ),
+        mClassName( className )
+    {
+        WNDCLASSEX     windowClass;
+        
+        
+        windowClass.cbSize         =  sizeof( WNDCLASSEX );
+        windowClass.style          =  CS_HREDRAW  |  CS_VREDRAW;
+        windowClass.lpfnWndProc    =  windowProcedure;
+        windowClass.cbClsExtra     =  0;
+        windowClass.cbWndExtra     =  0;
+        windowClass.hInstance      =  ::current;
+        windowClass.hbrBackground  =  static_cast< HBRUSH >( GetStockObject( WHITE_BRUSH ) );
+        windowClass.lpszMenuName   =  static_cast< LPCSTR >( mMenuName                     );
+        windowClass.lpszClassName  =  static_cast< LPCSTR >( mClassName                    );
+        
+        
+        windowClass.hIcon = static_cast<HICON>(
+            
+            LoadImage(
+                
+                0,
+                MAKEINTRESOURCE(IDI_APPLICATION),
+                IMAGE_ICON,
+                0,0,
+                LR_DEFAULTSIZE | LR_SHARED
+            )
+        );
+        windowClass.hCursor = static_cast<HCURSOR>(
+            
+            LoadImage(
+                
+                0,
+                MAKEINTRESOURCE(IDC_ARROW),
+                IMAGE_CURSOR,
+                0,0,
+                LR_DEFAULTSIZE | LR_SHARED
+            )
+        );
+        windowClass.hIconSm = static_cast<HICON>(
+            
+            LoadImage(
+                
+                0,
+                MAKEINTRESOURCE(IDI_APPLICATION),
+                IMAGE_ICON,
+                0,0,
+                LR_DEFAULTSIZE | LR_SHARED
+            )
+        );
+        
+        
+        if ( ! RegisterClassEx( &windowClass ) ) {
+            
+            throw  Exception( "ウィンドウクラスが不正です。",  mClassName );
+        }
+    }
+    
+    
+    void  create( const char*  title,   std::size_t  width,   std::size_t  height ) const throw( Exception ) {
+        
+        HWND    window(
+            
+            CreateWindow(
+                
+                mClassName,
+                title,
+                WS_OVERLAPPEDWINDOW,
+                CW_USEDEFAULT,
+                CW_USEDEFAULT,
+                width,
+                height,
+                0,
+                0,
+                ::current,
+                0
+            )
+        );
+        
+        
+        if ( ! window ) {
+            
+            throw  Exception( "ウィンドウ生成に失敗しました。",  mClassName );
+        }
+        
+        
+        ShowWindow  ( window,  ::commandShow );
+        UpdateWindow( window                 );
+    }
+    
+  private:
+    
+    const char*    mMenuName;       //  メニューリソースの名前。
+    const char*    mClassName;      //  ウィンドウクラスの名前。
+};
+
+
+/**
+ *
+ * @brief OpenGL用のレンダリングコンテキストを定義。
+ *
+ *///---------------------------------------------------------------------------
+class OpenGL {
+    
+  public:
+    
+    OpenGL( void ) {
+        
+        memset( &mPixelFormat,  0,  sizeof( PIXELFORMATDESCRIPTOR ) );
+        
+        
+        mPixelFormat.nSize       =  sizeof( PIXELFORMATDESCRIPTOR );
+        mPixelFormat.nVersion    =  1;
+        mPixelFormat.dwFlags     =  PFD_DRAW_TO_WINDOW  |  PFD_SUPPORT_OPENGL  |  PFD_DOUBLEBUFFER;
+        mPixelFormat.iPixelType  =  PFD_TYPE_RGBA;
+        mPixelFormat.cColorBits  =  24;
+        mPixelFormat.iLayerType  =  PFD_MAIN_PLANE;
+    }
+    
+    
+    HGLRC  operator ()( HDC  deviceContext ) const {
+        
+        SetPixelFormat(
+            
+            deviceContext,
+            ChoosePixelFormat( deviceContext,  &mPixelFormat ),
+            &mPixelFormat
+        );
+        
+        return  wglCreateContext( deviceContext );
+    }
+    
+  private:
+    
+    PIXELFORMATDESCRIPTOR    mPixelFormat;    //  ピクセルフォーマットの設定。
+};
+
+
+/**
+ *
+ * @brief ファイルダイアログを定義。
+ *
+ *///---------------------------------------------------------------------------
+class FileDialogBase {
+    
+  public:
+    
+    const char*  getFilePath( void ) const {
+        
+        return  mFilePath;
+    }
+    
+  protected:
+    
+    FileDialogBase( HWND  window,   DWORD  flags,   const FileDialogInfo&  info ) {
+        
+        memset( &mOpenFileName,  0,  sizeof( OPENFILENAME ) );
+        
+        
+        mOpenFileName.lStructSize     =  sizeof( OPENFILENAME );
+        mOpenFileName.hwndOwner       =  window;
+        mOpenFileName.lpstrFilter     =  info.mFilterList;
+        mOpenFileName.lpstrFile       =  mFilePath;
+        mOpenFileName.lpstrFileTitle  =  mFileTitle;
+        mOpenFileName.nMaxFile        =  MAX_PATH;
+        mOpenFileName.nMaxFileTitle   =  MAX_PATH;
+        mOpenFileName.hInstance       =  0;
+        mOpenFileName.lpfnHook        =  0;
+        mOpenFileName.Flags           =  flags;
+        mOpenFileName.lpstrDefExt     =  info.mDefaultExtension;
+        mOpenFileName.lpstrTitle      =  info.mTitle;
+        
+        
+      #if( _WIN32_WINNT  >=  0x0500 )
+        
+        mOpenFileName.pvReserved  =  0;
+        
+      #endif
+    }
+    
+    
+    void  initialize( void ) {
+        
+        *mFilePath   =  0;
+        *mFileTitle  =  0;
+    }
+    
+    
+    OPENFILENAME    mOpenFileName;      //  ファイルダイアログ。
+    char            mFilePath [257];    //  ファイルのパス名。
+    char            mFileTitle[257];    //  ファイルのタイトル名。
+};
+
+
+/**
+ *
+ * @brief オープンファイルダイアログを定義。
+ *
+ *///---------------------------------------------------------------------------
+class OpenFileDialog  :  public FileDialogBase {
+    
+  public:
+    
+    OpenFileDialog( HWND  window,   const FileDialogInfo&  info )  :
+        
+        FileDialogBase(
+            
+            window,
+            OFN_HIDEREADONLY | OFN_FILEMUSTEXIST,
+            info
+        )
+    {}
+    
+    
+    bool  operator ()( void ) {
+        
+        initialize();
+        
+        return  GetOpenFileName( &mOpenFileName );
+    }
+};
+
+
+/**
+ *
+ * @brief メイン処理を定義。
+ *
+ *///---------------------------------------------------------------------------
+class Main {
+    
+  public:
+    
+    Main( void )  :  mMainWindow( mainWindowProcedure,  "IDM_MENU",  "main" ) {
+        
+        mMainWindow.create( "OpenGL 3D Graph",  640, 480 );
+    }
+    
+    
+    int  operator ()( void ) {
+        
+        try                            {  sendMessage();  }
+        catch( Exception&  exception ) {  exception  ();  }
+        
+        return  static_cast<int>( mMessage.wParam );
+    }
+    
+  private:
+    
+    void  sendMessage( void ) {
+        
+        while ( isLoop() ) {
+            
+            TranslateMessage( &mMessage );
+            DispatchMessage ( &mMessage );
+        }
+    }
+    
+    
+    BOOL  getMessege( void ) {
+        
+        return  mState = GetMessage( &mMessage,  0,0,0 );
+    }
+    
+    
+    BOOL  isLoop( void ) throw( Exception ) {
+        
+        if ( getMessege() == -1 ) {
+            
+            throw  Exception( "メッセージが不正です",  "-1" );
+        }
+        
+        return  mState;
+    }
+    
+    
+    MSG       mMessage;      //  メッセージ。
+    BOOL      mState;        //  メッセージ取得の状態。
+    Window    mMainWindow;   //  メインウィンドウ。
+};
+
+
+/**
+ *
+ * @brief メインウィンドウのプロシージャを定義。
+ *
+ *///---------------------------------------------------------------------------
+class MainWindowProcedure {
+    
+  public:
+    
+    MainWindowProcedure( HWND  window )  :
+        
+        mWindow          ( window                     ),
+        mDeviceContext   ( GetDC   ( mWindow        ) ),
+        mRenderingContext( OpenGL()( mDeviceContext ) ),
+        mIsRefining      ( false                      ),
+        mIsRefined       ( false                      ),
+        mIsSizeChanged   ( false                      ),
+        mRefineNumber    ( 0                          )
+    {
+        mPloter.setSink( boost::shared_ptr<Ploter::RenderSink>( new Ploter::GLRenderSink ) );
+        
+        int  interval  =  Ploter::Option("option").getInt( "watchInterval", 0 );
+        
+        if ( interval > 0 ) {
+            
+            mOptionWatcher.start( interval,  &MainWindowProcedure::notifyOption,  mWindow );
+        }
+        
+        paint();
+    }
+    
+    
+    LRESULT  operator ()( UINT  message,   WPARAM  wParameter,   LPARAM  lParameter ) {
+        
+        switch ( message ) {
+            
+          case  WM_PAINT   : paint       ();              break;
+          case  WM_SIZE    : size        ();              break;
+          case  WM_DESTROY : destroy     ();              break;
+          case  WM_COMMAND : command     ( wParameter );  break;
+          case  WM_TIMER   : startRefine ();              break;
+          case  WM_REFINED : finishRefine( wParameter );  break;
+            
+          case  WM_OPTION_CHANGED :  size();  InvalidateRect( mWindow,  0,  FALSE );  break;
+            
+          default:
+            
+            return  DefWindowProc( mWindow,  message,  wParameter,  lParameter );
+        }
+        
+        return  0;
+    }
+    
+  private:
+    
+    void  command( WPARAM  wParameter ) {
+        
+        switch ( LOWORD( wParameter ) ) {
+            
+          case  IDM_OPEN : open();  break;
+          case  IDM_EXIT : exit();  break;
+            
+        }
+    }
+    
+    
+    void  paint( void ) {
+        
+        PAINTSTRUCT  paint;    //  描画情報。
+        
+        BeginPaint( mWindow,  &paint );  {
+            
+            wglMakeCurrent( mDeviceContext,  mRenderingContext );
+            SwapBuffers   ( mDeviceContext                     );
+            
+        }  EndPaint( mWindow,  &paint );
+    }
+    
+    
+    void  size( void ) {
+        
+        KillTimer( mWindow,  REFINE_TIMER );
+        
+        if ( mIsRefining ) {
+            
+            mIsSizeChanged = true;
+            
+            return;
+        }
+        
+        GetClientRect ( mWindow,                 &mClientTerritory       );
+        mPloter.resize( mClientTerritory.right,  mClientTerritory.bottom );
+        
+        showArenaPeak();
+        
+        SetTimer( mWindow,  REFINE_TIMER,  REFINE_DELAY,  0 );
+    }
+    
+    
+    void  startRefine( void ) {
+        
+        KillTimer( mWindow,  REFINE_TIMER );
+        
+        if ( mIsRefining ) {  return;  }
+        
+        mRefineNumber++;
+        
+        mIsRefining = mRefineThread.start( &MainWindowProcedure::refine,  this );
+    }
+    
+    
+    static void  refine( void*  procedure ) {
+        
+        MainWindowProcedure*  self = static_cast<MainWindowProcedure*>( procedure );
+        
+        self->mIsRefined = self->mPloter.prepareRefine();
+        
+        PostMessage( self->mWindow,  WM_REFINED,  self->mRefineNumber,  0 );
+    }
+    
+    
+    void  finishRefine( WPARAM  refineNumber ) {
+        
+        if ( ! mIsRefining || refineNumber != mRefineNumber ) {  return;  }
+        
+        mRefineThread.join();
+        
+        mIsRefining = false;
+        
+        if ( mIsSizeChanged ) {
+            
+            mIsSizeChanged = false;
+            
+            size();
+        }
+        else if ( mIsRefined ) {
+            
+            mPloter.draw();
+            
+            startRefine();
+        }
+        
+        InvalidateRect( mWindow,  0,  FALSE );
+    }
+    
+    
+    void  cancelRefine( void ) {
+        
+        KillTimer( mWindow,  REFINE_TIMER );
+        
+        mRefineThread.join();
+        
+        mIsRefining    = false;
+        mIsSizeChanged = false;
+    }
+    
+    
+    void  showArenaPeak( void ) const {
+        
+        if ( Ploter::Option("graph").getInt( "isShowArenaPeak", 0 ) ) {
+            
+            std::ostringstream  title;    //  タイトル。
+            
+            title  <<  "OpenGL 3D Graph - 一時領域 "  <<  ( mPloter.getArenaPeak() + 1023 ) / 1024  <<  "KB";
+            
+            SetWindowText( mWindow,  title.str().c_str() );
+        }
+    }
+    
+    
+    static void  notifyOption( void*  window ) {
+        
+        PostMessage( static_cast<HWND>( window ),  WM_OPTION_CHANGED,  0, 0 );
+    }
+    
+    
+    void  destroy( void ) {
+        
+        mOptionWatcher.stop();
+        
+        cancelRefine();
+        
+        wglMakeCurrent  ( 0,0                      );
+        wglDeleteContext( mRenderingContext        );
+        ReleaseDC       ( mWindow,  mDeviceContext );
+        PostQuitMessage ( 0                        );
+    }
+    
+    
+    void  open( void ) {
+        
+        OpenFileDialog  openPlotFile( mWindow, ::openPlotFile );    //  プロットファイルを開く。
+        
+        if ( openPlotFile() ) {
+            
+            cancelRefine();
+            
+            if ( ! mPloter.set( openPlotFile.getFilePath() ) ) {
+                
+                Exception( "データファイルを読み込めません。",  openPlotFile.getFilePath() )();
+                
+                return;
+            }
+            
+            this->size(); SendMessage( mWindow, WM_PAINT, 0,0 );
+        }
+    }
+    
+    
+    void  exit( void ) const {
+        
+        SendMessage( mWindow,  WM_DESTROY,  0, 0 );
+    }
+    
+    
+    HWND                   mWindow;              //  ウィンドウハンドル。
+    HDC                    mDeviceContext;       //  デバイスコンテキストハンドル。
+    HGLRC                  mRenderingContext;    //  レンダリングコンテキストハンドル。
+    RECT                   mClientTerritory;     //  クライアント領域の範囲。
+    Ploter::Ploter         mPloter;              //  描画対象。
+    Ploter::OptionWatcher  mOptionWatcher;       //  オプションファイルの監視。
+    Ploter::Thread         mRefineThread;        //  グラフを細かくするスレッド。
+    bool                   mIsRefining;          //  グラフを細かくするスレッドが動いているか。
+    volatile bool          mIsRefined;           //  スレッドがグラフを1段細かくしたか。
+    bool                   mIsSizeChanged;       //  細かくしている間にウィンドウの大きさが変わったか。
+    WPARAM                 mRefineNumber;        //  グラフを細かくする依頼の番号。
+};
+
+
+/**
+ *
+ * @brief メイン関数。
+ *
+ *///---------------------------------------------------------------------------
+int  WINAPI  WinMain( HINSTANCE  current,   HINSTANCE,   LPSTR,   int  commandShow ) {
+    
+    ::current      =  current;
+    ::commandShow  =  commandShow;
+    
+    try                            {  return  Main()();     }
+    catch( Exception&  exception ) {  return  exception();  }
+}
+
+
+/**
+ *
+ * @brief メインウィンドウのウィンドウプロシージャ。
+ *
+ *///---------------------------------------------------------------------------
+LRESULT  CALLBACK  mainWindowProcedure( HWND  window,   UINT  message,   WPARAM  wParameter,   LPARAM  lParameter ) {
+    
+    static  MainWindowProcedure    procedure( window );
+    
+    return  procedure( message,  wParameter,  lParameter );
+}
@@ -0,0 +1,295 @@
+/**
+ * @file   Arena.h
+ * @author 村田 裕一
+ * @brief  1回の描画の間だけ使う一時領域を、まとめて確保・解放するクラスを定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_ARENA_H
+#define  INCLUDED_ARENA_H
+
+#include  <vector>
+#include  <algorithm>
+#include  <limits>
+#include  <new>
+#include  <boost/utility.hpp>
+
+namespace Ploter {
+    
+    /**
+     * @brief 1回の描画の一時領域。確保は現在のブロックの末尾を進めるだけで、resetで全て解放する。
+     *        MAXIMUM_REUSEバイト以下の領域は個別に解放すると大きさごとの空きリストに戻し、同じ大きさの確保に使い回す。
+     *        ブロックが足りなくなった場合は新しいブロックを足し、resetの時に使った大きさの1つのブロックにまとめるので、
+     *        同じ規模の描画が続く間は新たに確保しない。
+     *        排他はしないので、1つのスレッドからだけ使う。別のスレッドではgetChildで得た子の一時領域を使う。
+     *///---------------------------------------------------------------------------
+    class FrameArena : boost::noncopyable {
+        
+      public:
+        
+        /**
+         * @brief 確保する領域の境界。
+         *///---------------------------------------------------------------------------
+        enum { ALIGNMENT = 16, MINIMUM_BLOCK = 64 * 1024, MAXIMUM_REUSE = 256 };
+        
+        FrameArena(void) : offset(0), used(0), peak(0) { std::fill( this->freeLists, this->freeLists + FREE_LIST_NUMBER, static_cast<FreeNode *>(0) ); }
+        ~FrameArena(void);
+        
+        /**
+         * @brief bytesバイトの領域を確保する。同じ大きさの空きがあればそれを使う。
+         *///---------------------------------------------------------------------------
+        void *  allocate( std::size_t bytes ) {
+            
+            bytes = FrameArena::round(bytes);
+            
+            if ( bytes <= MAXIMUM_REUSE && this->freeLists[ bytes / ALIGNMENT - 1 ] ) {
+                
+                FreeNode *  node = this->freeLists[ bytes / ALIGNMENT - 1 ];
+                
+                this->freeLists[ bytes / ALIGNMENT - 1 ] = node->next;
+                
+                return  node;
+            }
+            
+            if ( this->blocks.empty() || this->offset + bytes > this->blocks.back().size ) { this->addBlock(bytes); }
+            
+            void *  pointer = this->blocks.back().data + this->offset;
+            
+            this->offset += bytes;
+            this->used   += bytes;
+            this->peak    = std::max( this->peak, this->used );
+            
+            return  pointer;
+        }
+        
+        /**
+         * @brief allocateでbytesバイトとして確保したpointerを解放する。
+         *        MAXIMUM_REUSEバイト以下なら空きリストに戻し、それより大きい領域はresetまで残す。
+         *///---------------------------------------------------------------------------
+        void  deallocate( void * pointer,  std::size_t bytes ) {
+            
+            bytes = FrameArena::round(bytes);
+            
+            if ( bytes > MAXIMUM_REUSE ) { return; }
+            
+            FreeNode *  node = static_cast<FreeNode *>(pointer);
+            
+            node->next = this->freeLists[ bytes / ALIGNMENT - 1 ];
+            
+            this->freeLists[ bytes / ALIGNMENT - 1 ] = node;
+        }
+        
+        /**
+         * @brief 確保した全ての領域を解放する。ブロックが複数ある場合は、その合計の大きさの1つのブロックにまとめる。
+         *        子の一時領域も同じようにする。確保した領域を参照するものは、呼ぶ前に全て破棄しておくこと。
+         *///---------------------------------------------------------------------------
+        void  reset(void) {
+            
+            for ( std::size_t k=0;  k < this->children.size();  k++ ) { this->children[k]->reset(); }
+            
+            std::fill( this->freeLists, this->freeLists + FREE_LIST_NUMBER, static_cast<FreeNode *>(0) );
+            
+            if ( this->blocks.size() > 1 ) {
+                
+                std::size_t  capacity = this->getCapacity();
+                
+                this->release();
+                this->addBlock( capacity );
+            }
+            
+            this->offset = 0;
+            this->used   = 0;
+        }
+        
+        /**
+         * @brief 最大使用量を今の使用量に戻す。子の一時領域も同じようにする。描画の初めに呼び、getPeakを1回の描画の値にする。
+         *///---------------------------------------------------------------------------
+        void  resetPeak(void) {
+            
+            for ( std::size_t k=0;  k < this->children.size();  k++ ) { this->children[k]->resetPeak(); }
+            
+            this->peak = this->used;
+        }
+        
+        /**
+         * @brief 何も確保していない場合に、少なくともbytesバイトのブロックを用意する。
+         *///---------------------------------------------------------------------------
+        void  reserve( std::size_t bytes ) {
+            
+            if ( this->used > 0 || bytes <= this->getCapacity() ) { return; }
+            
+            this->release();
+            this->addBlock( bytes );
+        }
+        
+        /**
+         * @brief k番目の子の一時領域。別のスレッドで確保する場合に、スレッドごとに別の子を使う。
+         *        子は初めて求められた時に作るので、スレッドを起動する前に呼ぶこと。
+         *///---------------------------------------------------------------------------
+        FrameArena &  getChild( std::size_t k ) {
+            
+            while ( this->children.size() <= k ) { this->children.push_back( new FrameArena ); }
+            
+            return  *this->children[k];
+        }
+        
+        /**
+         * @brief 1回の描画でブロックから切り出した大きさの最大値[バイト]に、子の最大値を足したもの。領域の大きさを決める目安にする。
+         *///---------------------------------------------------------------------------
+        std::size_t  getPeak(void) const {
+            
+            std::size_t  total = this->peak;
+            
+            for ( std::size_t k=0;  k < this->children.size();  k++ ) { total += this->children[k]->getPeak(); }
+            
+            return  total;
+        }
+        
+      private:
+        
+        enum { FREE_LIST_NUMBER = MAXIMUM_REUSE / ALIGNMENT };
+        
+        /**
+         * @brief 空きリストの要素。解放された領域の先頭に置く。
+         *///---------------------------------------------------------------------------
+        struct FreeNode {
+            
+            FreeNode *  next;
+        };
+        
+        /**
+         * @brief bytesをALIGNMENTの倍数に切り上げる。0バイトはALIGNMENTバイトにする。
+         *///---------------------------------------------------------------------------
+        static std::size_t  round( std::size_t bytes ) {
+            
+            return  ( std::max<std::size_t>( bytes, 1 ) + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+        }
+        
+        /**
+         * @brief ブロック。
+         *///---------------------------------------------------------------------------
+        struct Block {
+            
+            char *       data;
+            std::size_t  size;
+        };
+        
+        /**
+         * @brief 少なくともbytesバイトで、直前のブロックの2倍以上の大きさのブロックを足す。
+         *///---------------------------------------------------------------------------
+        void  addBlock( std::size_t bytes ) {
+            
+            Block  block;
+            
+            block.size = std::max<std::size_t>( bytes, MINIMUM_BLOCK );
+            
+            if ( ! this->blocks.empty() ) { block.size = std::max( block.size, 2 * this->blocks.back().size ); }
+            
+            block.data = static_cast<char *>( ::operator new( block.size ) );
+            
+            this->blocks.push_back(block);
+            this->offset = 0;
+        }
+        
+        /**
+         * @brief 全てのブロックを解放する。
+         *///---------------------------------------------------------------------------
+        void  release(void) {
+            
+            for ( std::size_t k=0;  k < this->blocks.size();  k++ ) { ::operator delete( this->blocks[k].data ); }
+            
+            this->blocks.clear();
+            this->offset = 0;
+        }
+        
+        /**
+         * @brief 全てのブロックの大きさの合計。
+         *///---------------------------------------------------------------------------
+        std::size_t  getCapacity(void) const {
+            
+            std::size_t  capacity = 0;
+            
+            for ( std::size_t k=0;  k < this->blocks.size();  k++ ) { capacity += this->blocks[k].size; }
+            
+            return  capacity;
+        }
+        
+        std::vector<Block>         blocks;
+        std::size_t                offset;
+        std::size_t                used;
+        std::size_t                peak;
+        FreeNode *                 freeLists[FREE_LIST_NUMBER];
+        std::vector<FrameArena *>  children;
+    };
+    
+    inline FrameArena::~FrameArena(void) {
+        
+        for ( std::size_t k=0;  k < this->children.size();  k++ ) { delete this->children[k]; }
+        
+        this->release();
+    }
+    
+    
+    /**
+     * @brief FrameArenaから確保するアロケータ。解放はFrameArenaに任せ、小さな領域は使い回される。
+     *        FrameArenaを指定しない場合は、通常のnew・deleteで確保・解放する。
+     *///---------------------------------------------------------------------------
+    template<class T>
+    class ArenaAllocator {
+        
+      public:
+        
+        typedef T                 value_type;
+        typedef T *               pointer;
+        typedef const T *         const_pointer;
+        typedef T &               reference;
+        typedef const T &         const_reference;
+        typedef std::size_t       size_type;
+        typedef std::ptrdiff_t    difference_type;
+        
+        template<class U> struct rebind { typedef ArenaAllocator<U> other; };
+        
+        ArenaAllocator( FrameArena * arena_ = 0 ) : arena( arena_) {}
+        
+        template<class U>
+        ArenaAllocator( const ArenaAllocator<U> & other ) : arena( other.getArena() ) {}
+        
+        pointer        address( reference       value ) const { return &value; }
+        const_pointer  address( const_reference value ) const { return &value; }
+        
+        /**
+         * @brief number個の要素の領域を確保する。
+         *///---------------------------------------------------------------------------
+        pointer  allocate( size_type number,  const void * = 0 ) {
+            
+            std::size_t  bytes = number * sizeof(T);
+            
+            return  static_cast<pointer>( this->arena ? this->arena->allocate(bytes) : ::operator new(bytes) );
+        }
+        
+        /**
+         * @brief number個の要素の領域を解放する。
+         *///---------------------------------------------------------------------------
+        void  deallocate( pointer pointer_,  size_type number ) {
+            
+            if ( this->arena ) { this->arena->deallocate( pointer_, number * sizeof(T) ); }
+            else               { ::operator delete( pointer_); }
+        }
+        
+        size_type  max_size(void) const { return std::numeric_limits<size_type>::max() / sizeof(T); }
+        
+        void  construct( pointer pointer_,  const T & value ) { new( pointer_) T(value); }
+        void  destroy  ( pointer pointer_                   ) { pointer_->~T(); }
+        
+        FrameArena *  getArena(void) const { return this->arena; }
+        
+      private:
+        
+        FrameArena *  arena;
+    };
+    
+    template<class T, class U>
+    inline bool  operator ==( const ArenaAllocator<T> & a,  const ArenaAllocator<U> & b ) { return a.getArena() == b.getArena(); }
+    
+    template<class T, class U>
+    inline bool  operator !=( const ArenaAllocator<T> & a,  const ArenaAllocator<U> & b ) { return a.getArena() != b.getArena(); }
+}
+#endif
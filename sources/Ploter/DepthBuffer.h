@@ -0,0 +1,245 @@
+/**
+ * @file   DepthBuffer.h
+ * @author 村田 裕一
+ * @brief  格子の面を画素ごとの奥行きに描き込み、線分の見える部分を求めるクラスを定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_DEPTH_BUFFER_H
+#define  INCLUDED_DEPTH_BUFFER_H
+
+#include  <vector>
+#include  <cmath>
+#include  <limits>
+#include  "Utility.h"
+
+namespace Ploter {
+    
+    /**
+     * @brief 格子の各升目を2つの三角形に分けて画素ごとに描き込み、最も手前の三角形を記録するクラス。
+     *        奥行きは大きいほど手前とする。
+     *        線分の点は、その画素で最も手前の三角形の平面と奥行きを比べる。
+     *        線分は隣り合う三角形の辺上にあるので、平面と比べれば画素の中心の奥行きと比べるより誤差が小さい。
+     *        手間は三角形の数と画素の数の和に比例し、格子の細かさによらず上限がある。
+     *///---------------------------------------------------------------------------
+    class DepthBuffer {
+        
+      public:
+        
+        DepthBuffer(void) : points(0), depths(0), columnNumber(0), origin(0), width(0), size(0) {}
+        
+        /**
+         * @brief 行ごとにcolumnNumber_個ずつ並ぶ画面上の点points_と奥行きdepths_の格子を、
+         *        origin_から始まる長さextentの正方形の範囲について、1画素の幅をwidth_として描き込む。
+         *        points_とdepths_は次に設定するまで参照する。
+         *///---------------------------------------------------------------------------
+        void  set( const PointArray & points_,  const ElementArray & depths_,  std::size_t columnNumber_,
+                   Element origin_,  Element extent,  Element width_) {
+            
+            this->points       = &points_;
+            this->depths       = &depths_;
+            this->columnNumber = columnNumber_;
+            this->origin       = origin_;
+            this->width        = width_;
+            this->size         = ( width_ > 0 ) ? static_cast<std::size_t>( std::ceil( extent / width_ ) ) : 0;
+            
+            this->nearest .assign( this->size * this->size, -std::numeric_limits<Element>::infinity() );
+            this->triangle.assign( this->size * this->size, -1 );
+            
+            if ( this->size == 0 || this->columnNumber < 2 ) { return; }
+            
+            std::size_t  rowNumber = points_.size() / this->columnNumber;
+            
+            for ( std::size_t j=0;  j+1 < rowNumber;  j++ ) {
+                
+                for ( std::size_t i=0;  i+1 < this->columnNumber;  i++ ) {
+                    
+                    long  cell = static_cast<long>( j * ( this->columnNumber - 1 ) + i );
+                    
+                    this->rasterize( 2*cell     );
+                    this->rasterize( 2*cell + 1 );
+                }
+            }
+        }
+        
+        /**
+         * @brief setで渡した点のbeginIndex番目とendIndex番目を結ぶ線分の見える部分を、
+         *        始点を0・終点を1とする媒介変数の区間の列としてpiecesに設定する。線分は1画素ごとに調べる。
+         *        描き込んでいない場合は全体を見えるとする。
+         *///---------------------------------------------------------------------------
+        void  clip( Index beginIndex,  Index endIndex,  RangeList & pieces ) const {
+            
+            pieces.clear();
+            
+            if ( this->size == 0 ) { pieces.push_back( Range(0,1) );  return; }
+            
+            const Point2 &  begin = (*this->points)[ beginIndex ];
+            const Point2 &  end   = (*this->points)[ endIndex   ];
+            
+            Element  d1 = (*this->depths)[ beginIndex ];
+            Element  d2 = (*this->depths)[ endIndex   ];
+            Element  dx = end(X) - begin(X);
+            Element  dy = end(Y) - begin(Y);
+            
+            if ( !( d1 - d1 == 0 && d2 - d2 == 0 && dx - dx == 0 && dy - dy == 0 ) ) { return; }   // NaNと∞は描かない。
+            
+            std::size_t  n    = std::max<std::size_t>( 1, static_cast<std::size_t>( std::ceil( std::max( std::fabs(dx), std::fabs(dy) ) / this->width ) ) );
+            Element      half = 0.5 / n;
+            bool         isOpen = false;
+            Element      first  = 0;
+            
+            for ( std::size_t k=0;  k <= n;  k++ ) {
+                
+                Element  t     = static_cast<Element>(k) / n;
+                Point2   point = {{ begin(X) + t * dx,  begin(Y) + t * dy }};
+                
+                bool  isVisible = this->isVisible( point, d1 + t * ( d2 - d1 ) );
+                
+                if      (   isVisible && ! isOpen ) { first = std::max<Element>( 0, t - half );  isOpen = true; }
+                else if ( ! isVisible &&   isOpen ) { pieces.push_back( Range( first, t - half ) );  isOpen = false; }
+            }
+            
+            if ( isOpen ) { pieces.push_back( Range( first, 1 ) ); }
+        }
+        
+      private:
+        
+        /**
+         * @brief 三角形indexを描き込む。升目cellの三角形は2*cellと2*cell+1。
+         *///---------------------------------------------------------------------------
+        void  rasterize( long index ) {
+            
+            std::size_t  vertex[3];
+            
+            this->getVertex( index, vertex );
+            
+            const Point2 &  a = (*this->points)[ vertex[0] ];
+            const Point2 &  b = (*this->points)[ vertex[1] ];
+            const Point2 &  c = (*this->points)[ vertex[2] ];
+            
+            Element  minimumX = std::min( a(X), std::min( b(X), c(X) ) ),  maximumX = std::max( a(X), std::max( b(X), c(X) ) );
+            Element  minimumY = std::min( a(Y), std::min( b(Y), c(Y) ) ),  maximumY = std::max( a(Y), std::max( b(Y), c(Y) ) );
+            
+            if ( !( minimumX - maximumX <= 0 && minimumY - maximumY <= 0 ) ) { return; }   // NaNを含む。
+            
+            long  firstX = this->toPixel( minimumX, true  ),  lastX = this->toPixel( maximumX, false );
+            long  firstY = this->toPixel( minimumY, true  ),  lastY = this->toPixel( maximumY, false );
+            
+            // 範囲の外に出た三角形は、画像の中の画素だけを描き込む。
+            firstX = std::max<long>( firstX, 0 );  lastX = std::min<long>( lastX, static_cast<long>( this->size ) - 1 );
+            firstY = std::max<long>( firstY, 0 );  lastY = std::min<long>( lastY, static_cast<long>( this->size ) - 1 );
+            
+            if ( firstX > lastX || firstY > lastY ) { return; }
+            
+            for ( long y=firstY;  y <= lastY;  y++ ) {
+                
+                for ( long x=firstX;  x <= lastX;  x++ ) {
+                    
+                    Point2   center = {{ this->origin + ( x + 0.5 ) * this->width,  this->origin + ( y + 0.5 ) * this->width }};
+                    Element  u, v;
+                    
+                    if ( ! this->getBarycentric( vertex, center, u, v ) || u < 0 || v < 0 || u + v > 1 ) { continue; }
+                    
+                    Element  depth = this->interpolate( vertex, u, v );
+                    
+                    std::size_t  pixel = y * this->size + x;
+                    
+                    if ( depth > this->nearest[pixel] ) { this->nearest[pixel] = depth;  this->triangle[pixel] = index; }
+                }
+            }
+        }
+        
+        /**
+         * @brief 奥行きdepthの点pointが、その画素で最も手前の三角形より手前(1画素の幅まで許す)にあるかどうか。
+         *        範囲外の点は見えるとする。
+         *///---------------------------------------------------------------------------
+        bool  isVisible( const Point2 & point,  Element depth ) const {
+            
+            Element  x = std::floor( ( point(X) - this->origin ) / this->width );
+            Element  y = std::floor( ( point(Y) - this->origin ) / this->width );
+            
+            if ( !( 0 <= x && x < this->size && 0 <= y && y < this->size ) ) { return true; }
+            
+            long  index = this->triangle[ static_cast<std::size_t>(y) * this->size + static_cast<std::size_t>(x) ];
+            
+            if ( index < 0 ) { return true; }
+            
+            std::size_t  vertex[3];
+            Element      u, v;
+            
+            this->getVertex( index, vertex );
+            
+            if ( ! this->getBarycentric( vertex, point, u, v ) ) { return true; }
+            
+            return  depth >= this->interpolate( vertex, u, v ) - this->width;
+        }
+        
+        /**
+         * @brief 三角形indexの頂点の番号をvertexに設定する。
+         *///---------------------------------------------------------------------------
+        void  getVertex( long index,  std::size_t vertex[3] ) const {
+            
+            std::size_t  cell = static_cast<std::size_t>( index / 2 );
+            std::size_t  j    = cell / ( this->columnNumber - 1 );
+            std::size_t  i    = cell % ( this->columnNumber - 1 );
+            std::size_t  v00  = j * this->columnNumber + i;
+            std::size_t  v11  = v00 + this->columnNumber + 1;
+            
+            vertex[0] = v00;
+            vertex[1] = ( index % 2 == 0 ) ? v00 + 1 : v11;
+            vertex[2] = ( index % 2 == 0 ) ? v11     : v00 + this->columnNumber;
+        }
+        
+        /**
+         * @brief 三角形vertexに対するpointの重心座標(u,v)を求める。三角形が潰れている場合はfalseを返す。
+         *///---------------------------------------------------------------------------
+        bool  getBarycentric( const std::size_t vertex[3],  const Point2 & point,  Element & u,  Element & v ) const {
+            
+            const Point2 &  a = (*this->points)[ vertex[0] ];
+            const Point2 &  b = (*this->points)[ vertex[1] ];
+            const Point2 &  c = (*this->points)[ vertex[2] ];
+            
+            Element  determinant = ( b(X) - a(X) ) * ( c(Y) - a(Y) ) - ( c(X) - a(X) ) * ( b(Y) - a(Y) );
+            
+            if ( determinant == 0 ) { return false; }
+            
+            u = ( ( point(X) - a(X) ) * ( c(Y) - a(Y) ) - ( c(X) - a(X) ) * ( point(Y) - a(Y) ) ) / determinant;
+            v = ( ( b(X) - a(X) ) * ( point(Y) - a(Y) ) - ( point(X) - a(X) ) * ( b(Y) - a(Y) ) ) / determinant;
+            
+            return true;
+        }
+        
+        /**
+         * @brief 三角形vertexの重心座標(u,v)での奥行き。
+         *///---------------------------------------------------------------------------
+        Element  interpolate( const std::size_t vertex[3],  Element u,  Element v ) const {
+            
+            const ElementArray &  d = *this->depths;
+            
+            return  d[ vertex[0] ] + u * ( d[ vertex[1] ] - d[ vertex[0] ] ) + v * ( d[ vertex[2] ] - d[ vertex[0] ] );
+        }
+        
+        /**
+         * @brief 位置positionの画素の番号。isFirstなら中心がposition以上の最初の画素、そうでなければ中心がposition以下の最後の画素。
+         *        範囲外の番号は[-1,size]に収める。
+         *///---------------------------------------------------------------------------
+        long  toPixel( Element position,  bool isFirst ) const {
+            
+            Element  k = ( position - this->origin ) / this->width - 0.5;
+            
+            k = isFirst ? std::ceil(k) : std::floor(k);
+            k = std::max<Element>( k, -1 );
+            k = std::min<Element>( k, static_cast<Element>( this->size ) );
+            
+            return  static_cast<long>(k);
+        }
+        
+        const PointArray *    points;
+        const ElementArray *  depths;
+        std::size_t           columnNumber;
+        Element               origin;
+        Element               width;
+        std::size_t           size;
+        ElementArray          nearest;
+        std::vector<long>     triangle;
+    };
+}
+#endif
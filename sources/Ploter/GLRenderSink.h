@@ -0,0 +1,79 @@
+/**
+ * @file   GLRenderSink.h
+ * @author 村田 裕一
+ * @brief  OpenGLで描く描画先を定義したファイル。OpenGLを使うのはこのファイルだけなので、ウィンドウを持つ実行ファイルだけが取り込む。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_GL_RENDER_SINK_H
+#define  INCLUDED_GL_RENDER_SINK_H
+
+#ifdef   _WIN32
+#include  <windows.h>
+#endif
+#include  <gl/gl.h>
+#include  "RenderSink.h"
+
+namespace Ploter {
+    
+    /**
+     * @brief OpenGLで描く描画先。描画の前に、描画するコンテキストをカレントにしておくこと。
+     *///---------------------------------------------------------------------------
+    class GLRenderSink : public RenderSink {
+        
+      public:
+        
+        /**
+         * @brief ウィンドウの左下(x,y)から1辺sizeの正方形をビューポートにする。
+         *///---------------------------------------------------------------------------
+        void  setViewport( int x,  int y,  int size ) {
+            
+            glViewport( x, y, size, size );
+        }
+        
+        /**
+         * @brief 背景を塗り、[minimum,maximum]を正射影し、不透明度による合成を有効にする。
+         *///---------------------------------------------------------------------------
+        void  beginFrame( const RGBA & background,  Element minimum,  Element maximum ) {
+            
+            glClearColor( background.r, background.g, background.b, background.a );
+            glClear     ( GL_COLOR_BUFFER_BIT );
+            
+            glLoadIdentity();
+            glOrtho( minimum, maximum,  minimum, maximum,  -10.0, 10.0 );
+            
+            glEnable   ( GL_BLEND );
+            glBlendFunc( GL_SRC_ALPHA,  GL_ONE_MINUS_SRC_ALPHA );
+        }
+        
+        /**
+         * @brief 描き方を設定してから、線分を頂点配列として1回で描く。色は描き方ごとに1つなので、頂点ごとには持たない。
+         *///---------------------------------------------------------------------------
+        void  drawLines( const PointArray & points,  const LineStyle & style ) {
+            
+            glColor4d( style.color.r, style.color.g, style.color.b, style.color.a );
+            
+            if ( style.stipple != LineStyle::SOLID ) { glEnable ( GL_LINE_STIPPLE );  glLineStipple( 1, style.stipple ); }
+            else                                     { glDisable( GL_LINE_STIPPLE );                                 }
+            
+            if ( style.isSmooth ) { glEnable ( GL_LINE_SMOOTH );  glHint( GL_LINE_SMOOTH_HINT, GL_NICEST ); }
+            else                  { glDisable( GL_LINE_SMOOTH );                                           }
+            
+            if ( points.size() < 2 ) { return; }
+            
+            glEnableClientState ( GL_VERTEX_ARRAY );
+            glVertexPointer     ( 2, GL_DOUBLE, sizeof(Point2), points[0].element );
+            glDrawArrays        ( GL_LINES, 0, static_cast<GLsizei>( points.size() / 2 * 2 ) );
+            glDisableClientState( GL_VERTEX_ARRAY );
+        }
+        
+        /**
+         * @brief 破線・滑らかな線・合成を無効にして、描画の状態を元に戻す。
+         *///---------------------------------------------------------------------------
+        void  endFrame(void) {
+            
+            glDisable( GL_LINE_STIPPLE );
+            glDisable( GL_LINE_SMOOTH  );
+            glDisable( GL_BLEND        );
+        }
+    };
+}
+#endif
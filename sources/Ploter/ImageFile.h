@@ -0,0 +1,307 @@
+/**
+ * @file   ImageFile.h
+ * @author 村田 裕一
+ * @brief  RGBA各8ビットの画像を、PPM・PNG形式のファイルに書き込む関数を定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_IMAGE_FILE_H
+#define  INCLUDED_IMAGE_FILE_H
+
+#include  <vector>
+#include  <string>
+#include  <fstream>
+#include  <algorithm>
+#include  <cctype>
+
+namespace Ploter {
+    
+    /**
+     * @brief 幅width・高さheightの画像pixels(上の行から順に、1画素につきR・G・B・Aの4バイト)を
+     *        PPM形式(P6)でファイルfileNameに書き込む。不透明度は書き込まない。書き込みに失敗した場合はfalseを返す。
+     *///---------------------------------------------------------------------------
+    inline bool  writePPM( const char * fileName,  int width,  int height,  const std::vector<unsigned char> & pixels ) {
+        
+        std::ofstream  file( fileName, std::ios::binary );
+        
+        if ( ! file ) { return false; }
+        
+        file << "P6\n" << width << " " << height << "\n255\n";
+        
+        std::vector<unsigned char>  row( 3 * width );
+        
+        for ( int y=0;  y < height;  y++ ) {
+            
+            for ( int x=0;  x < width;  x++ ) {
+                
+                std::copy( &pixels[ 4 * ( y * width + x ) ],  &pixels[ 4 * ( y * width + x ) ] + 3,  &row[ 3 * x ] );
+            }
+            
+            if ( width > 0 ) { file.write( reinterpret_cast<const char *>( &row[0] ), row.size() ); }
+        }
+        
+        return  file.good();
+    }
+    
+    
+    namespace Detail {
+        
+        /**
+         * @brief PNGのチャンクのCRC32。
+         *///---------------------------------------------------------------------------
+        inline unsigned long  crc32( const std::vector<unsigned char> & data ) {
+            
+            static unsigned long  table[256];
+            static bool           isInitialized = false;
+            
+            if ( ! isInitialized ) {
+                
+                for ( unsigned long n=0;  n < 256;  n++ ) {
+                    
+                    unsigned long  c = n;
+                    
+                    for ( int k=0;  k < 8;  k++ ) { c = ( c & 1 ) ? 0xEDB88320UL ^ ( c >> 1 ) : c >> 1; }
+                    
+                    table[n] = c;
+                }
+                
+                isInitialized = true;
+            }
+            
+            unsigned long  crc = 0xFFFFFFFFUL;
+            
+            for ( std::size_t k=0;  k < data.size();  k++ ) { crc = table[ ( crc ^ data[k] ) & 0xFF ] ^ ( crc >> 8 ); }
+            
+            return  crc ^ 0xFFFFFFFFUL;
+        }
+        
+        /**
+         * @brief 32ビットの値をビッグエンディアンでbytesに加える。
+         *///---------------------------------------------------------------------------
+        inline void  pushBack32( std::vector<unsigned char> & bytes,  unsigned long value ) {
+            
+            bytes.push_back( static_cast<unsigned char>( value >> 24 & 0xFF ) );
+            bytes.push_back( static_cast<unsigned char>( value >> 16 & 0xFF ) );
+            bytes.push_back( static_cast<unsigned char>( value >>  8 & 0xFF ) );
+            bytes.push_back( static_cast<unsigned char>( value       & 0xFF ) );
+        }
+        
+        /**
+         * @brief 種類typeでデータがdataのPNGのチャンクをpngに加える。
+         *///---------------------------------------------------------------------------
+        inline void  pushBackChunk( std::vector<unsigned char> & png,  const char * type,  const std::vector<unsigned char> & data ) {
+            
+            std::vector<unsigned char>  chunk( type, type + 4 );
+            
+            chunk.insert( chunk.end(), data.begin(), data.end() );
+            
+            pushBack32( png, data.size() );
+            png.insert( png.end(), chunk.begin(), chunk.end() );
+            pushBack32( png, crc32( chunk ) );
+        }
+        
+        /**
+         * @brief deflateの固定ハフマン符号で圧縮する。
+         *        一致は直前の1バイトか1画素(4バイト)の繰り返しだけを探す。
+         *        背景が大部分を占めるグラフの画像はこれで十分に小さくなる。
+         *///---------------------------------------------------------------------------
+        class FixedDeflater {
+            
+          public:
+            
+            FixedDeflater( std::vector<unsigned char> & output_) : output( output_), buffer(0), bitNumber(0) {}
+            
+            /**
+             * @brief dataを1つのブロックに圧縮する。
+             *///---------------------------------------------------------------------------
+            void  deflate( const std::vector<unsigned char> & data ) {
+                
+                this->writeBits( 1, 1 );   // 最後のブロック
+                this->writeBits( 1, 2 );   // 固定ハフマン符号
+                
+                std::size_t  k = 0;
+                
+                while ( k < data.size() ) {
+                    
+                    std::size_t  distance = 0,  length = 0;
+                    
+                    for ( std::size_t d=1;  d <= 4;  d += 3 ) {
+                        
+                        if ( k < d ) { continue; }
+                        
+                        std::size_t  n = 0;
+                        
+                        while ( n < 258 && k+n < data.size() && data[k+n] == data[k+n-d] ) { n++; }
+                        
+                        if ( n > length ) { length = n;  distance = d; }
+                    }
+                    
+                    if ( length >= 3 ) { this->writeMatch( length, distance );  k += length; }
+                    else               { this->writeSymbol( data[k] );         k++;          }
+                }
+                
+                this->writeSymbol(256);
+                
+                if ( this->bitNumber > 0 ) { this->output.push_back( static_cast<unsigned char>( this->buffer ) ); }
+            }
+            
+          private:
+            
+            /**
+             * @brief valueの下位numberビットを、下位のビットから順に書く。
+             *///---------------------------------------------------------------------------
+            void  writeBits( unsigned long value,  int number ) {
+                
+                for ( int k=0;  k < number;  k++ ) { this->writeBit( value >> k & 1 ); }
+            }
+            
+            /**
+             * @brief ハフマン符号codeの下位numberビットを、上位のビットから順に書く。
+             *///---------------------------------------------------------------------------
+            void  writeCode( unsigned long code,  int number ) {
+                
+                for ( int k=number-1;  k >= 0;  k-- ) { this->writeBit( code >> k & 1 ); }
+            }
+            
+            /**
+             * @brief 1ビット書く。
+             *///---------------------------------------------------------------------------
+            void  writeBit( unsigned long bit ) {
+                
+                this->buffer |= bit << this->bitNumber;
+                
+                if ( ++this->bitNumber == 8 ) {
+                    
+                    this->output.push_back( static_cast<unsigned char>( this->buffer ) );
+                    this->buffer    = 0;
+                    this->bitNumber = 0;
+                }
+            }
+            
+            /**
+             * @brief リテラル・長さの記号symbolを書く。
+             *///---------------------------------------------------------------------------
+            void  writeSymbol( unsigned int symbol ) {
+                
+                if      ( symbol < 144 ) { this->writeCode( 0x30  + symbol,         8 ); }
+                else if ( symbol < 256 ) { this->writeCode( 0x190 + symbol - 144,   9 ); }
+                else if ( symbol < 280 ) { this->writeCode(         symbol - 256,   7 ); }
+                else                     { this->writeCode( 0xC0  + symbol - 280,   8 ); }
+            }
+            
+            /**
+             * @brief 長さlength(3～258)、距離distance(1～4)の一致を書く。
+             *///---------------------------------------------------------------------------
+            void  writeMatch( std::size_t length,  std::size_t distance ) {
+                
+                static const unsigned int  bases [29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                          35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+                static const int           extras[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                          3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+                
+                int  code = 28;
+                
+                while ( bases[code] > length ) { code--; }
+                
+                this->writeSymbol( 257 + code );
+                this->writeBits  ( length - bases[code], extras[code] );
+                this->writeCode  ( distance - 1, 5 );
+            }
+            
+            std::vector<unsigned char> &  output;
+            unsigned long                 buffer;
+            int                           bitNumber;
+        };
+    }
+    
+    
+    /**
+     * @brief 幅width・高さheightの画像pixels(上の行から順に、1画素につきR・G・B・Aの4バイト)を
+     *        PNG形式(RGBA各8ビット)でファイルfileNameに書き込む。書き込みに失敗した場合はfalseを返す。
+     *///---------------------------------------------------------------------------
+    inline bool  writePNG( const char * fileName,  int width,  int height,  const std::vector<unsigned char> & pixels ) {
+        
+        std::vector<unsigned char>  header;
+        
+        Detail::pushBack32( header, width  );
+        Detail::pushBack32( header, height );
+        
+        header.push_back(8);   // ビット深度
+        header.push_back(6);   // RGBA
+        header.push_back(0);
+        header.push_back(0);
+        header.push_back(0);
+        
+        
+        std::vector<unsigned char>  raw;
+        
+        raw.reserve( ( 4 * width + 1 ) * height );
+        
+        for ( int y=0;  y < height;  y++ ) {
+            
+            raw.push_back(0);   // フィルタなし
+            raw.insert( raw.end(),  pixels.begin() + 4 * y * width,  pixels.begin() + 4 * ( y + 1 ) * width );
+        }
+        
+        
+        std::vector<unsigned char>  data;
+        
+        data.push_back(0x78);
+        data.push_back(0x01);
+        
+        Detail::FixedDeflater( data ).deflate( raw );
+        
+        unsigned long  a = 1,  b = 0;
+        
+        for ( std::size_t k=0;  k < raw.size();  k++ ) {
+            
+            a = ( a + raw[k] ) % 65521;
+            b = ( b + a      ) % 65521;
+        }
+        
+        Detail::pushBack32( data, b << 16 | a );
+        
+        
+        static const unsigned char  signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        
+        std::vector<unsigned char>  png( signature, signature + 8 );
+        
+        Detail::pushBackChunk( png, "IHDR", header                        );
+        Detail::pushBackChunk( png, "IDAT", data                          );
+        Detail::pushBackChunk( png, "IEND", std::vector<unsigned char>()  );
+        
+        std::ofstream  file( fileName, std::ios::binary );
+        
+        if ( ! file ) { return false; }
+        
+        file.write( reinterpret_cast<const char *>( &png[0] ), png.size() );
+        
+        return  file.good();
+    }
+    
+    
+    /**
+     * @brief ファイル名fileNameの拡張子を、先頭の'.'を含めて小文字で返す。拡張子がない場合は空の文字列を返す。
+     *///---------------------------------------------------------------------------
+    inline std::string  getExtension( const std::string & fileName ) {
+        
+        std::string::size_type  dot = fileName.find_last_of('.');
+        
+        if ( dot == std::string::npos || fileName.find_first_of( "/\\", dot ) != std::string::npos ) { return std::string(); }
+        
+        std::string  extension = fileName.substr(dot);
+        
+        std::transform( extension.begin(), extension.end(), extension.begin(), ::tolower );
+        
+        return  extension;
+    }
+    
+    
+    /**
+     * @brief ファイル名の拡張子が.ppmの場合はPPM形式、それ以外はPNG形式で画像を書き込む。
+     *///---------------------------------------------------------------------------
+    inline bool  writeImage( const std::string & fileName,  int width,  int height,  const std::vector<unsigned char> & pixels ) {
+        
+        if ( getExtension(fileName) == ".ppm" ) { return writePPM( fileName.c_str(), width, height, pixels ); }
+        else                                    { return writePNG( fileName.c_str(), width, height, pixels ); }
+    }
+}
+#endif
@@ -0,0 +1,281 @@
+/**
+ * @file   Kernel.h
+ * @author 村田 裕一
+ * @brief  格子の頂点をまとめて座標変換する関数郡を定義したファイル。
+ *         SSE2/AVXが使える場合は実行時に選択し、使えない場合はスカラ演算で処理する。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_KERNEL_H
+#define  INCLUDED_KERNEL_H
+
+#include  <cstddef>
+#include  "Utility.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define   PLOTER_USE_SSE2
+#include  <emmintrin.h>
+#endif
+
+#if defined(PLOTER_USE_SSE2) && defined(__GNUC__) && ( __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) )
+#define   PLOTER_USE_AVX
+#include  <immintrin.h>
+#endif
+
+namespace Ploter {
+    
+    /**
+     * @brief 利用できるSIMD命令の種類。
+     *///---------------------------------------------------------------------------
+    enum { SIMD_NONE, SIMD_SSE2, SIMD_AVX };
+    
+    
+    /**
+     * @brief CPUが対応しているSIMD命令の種類を調べる。
+     *///---------------------------------------------------------------------------
+    inline int  detectSimd(void) {
+        
+      #if defined(PLOTER_USE_AVX)
+        
+        __builtin_cpu_init();
+        
+        if ( __builtin_cpu_supports("avx" ) ) { return SIMD_AVX;  }
+        if ( __builtin_cpu_supports("sse2") ) { return SIMD_SSE2; }
+        
+        return SIMD_NONE;
+        
+      #elif defined(PLOTER_USE_SSE2) && ( defined(__x86_64__) || defined(_MSC_VER) )
+        
+        return SIMD_SSE2;
+        
+      #elif defined(PLOTER_USE_SSE2) && defined(__GNUC__)
+        
+        unsigned int  a, b, c, d;
+        
+        __asm__ __volatile__( "cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(1) );
+        
+        return  ( d & (1u << 26) ) ? SIMD_SSE2 : SIMD_NONE;
+        
+      #else
+        
+        return SIMD_NONE;
+        
+      #endif
+    }
+    
+    
+    /**
+     * @brief アフィン変換screenで、第j行のi0列目からのn個の頂点(i,j,z[k])を画面へ写し、
+     *        out[k]に格納する関数の型。
+     *///---------------------------------------------------------------------------
+    typedef void (*TransformKernel)( const Affine2 & screen,  Element i0,  Element j,
+                                     const Element * z,  std::size_t n,  Point2 * out );
+    
+    
+    /**
+     * @brief スカラ演算による座標変換。
+     *///---------------------------------------------------------------------------
+    inline void  transformRowScalar( const Affine2 & screen,  Element i0,  Element j,
+                                     const Element * z,  std::size_t n,  Point2 * out ) {
+        
+        const Element  (&a)[2][4] = screen.element;
+        
+        for ( std::size_t k=0;  k < n;  k++ ) {
+            
+            Element  i = i0 + k;
+            
+            out[k](X) = a[X][X]*i + a[X][Y]*j + a[X][Z]*z[k] + a[X][W];
+            out[k](Y) = a[Y][X]*i + a[Y][Y]*j + a[Y][Z]*z[k] + a[Y][W];
+        }
+    }
+    
+    
+  #ifdef PLOTER_USE_SSE2
+    
+    /**
+     * @brief SSE2による座標変換。2頂点ずつ処理する。演算の順序はスカラ演算と同じ。
+     *///---------------------------------------------------------------------------
+    inline void  transformRowSse2( const Affine2 & screen,  Element i0,  Element j,
+                                   const Element * z,  std::size_t n,  Point2 * out ) {
+        
+        const Element  (&a)[2][4] = screen.element;
+        
+        const __m128d  xx = _mm_set1_pd( a[X][X]   ),  yx = _mm_set1_pd( a[Y][X]   );
+        const __m128d  xy = _mm_set1_pd( a[X][Y]*j ),  yy = _mm_set1_pd( a[Y][Y]*j );
+        const __m128d  xz = _mm_set1_pd( a[X][Z]   ),  yz = _mm_set1_pd( a[Y][Z]   );
+        const __m128d  xw = _mm_set1_pd( a[X][W]   ),  yw = _mm_set1_pd( a[Y][W]   );
+        const __m128d  step = _mm_set1_pd(2);
+        
+        __m128d      i = _mm_set_pd( i0+1, i0 );
+        std::size_t  k = 0;
+        
+        for ( ;  k+2 <= n;  k += 2, i = _mm_add_pd( i, step ) ) {
+            
+            __m128d  vz = _mm_loadu_pd( z+k );
+            __m128d  vx = _mm_add_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd(xx,i), xy ), _mm_mul_pd(xz,vz) ), xw );
+            __m128d  vy = _mm_add_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd(yx,i), yy ), _mm_mul_pd(yz,vz) ), yw );
+            
+            _mm_storeu_pd( out[k  ].element, _mm_unpacklo_pd( vx, vy ) );
+            _mm_storeu_pd( out[k+1].element, _mm_unpackhi_pd( vx, vy ) );
+        }
+        
+        transformRowScalar( screen, i0+k, j, z+k, n-k, out+k );
+    }
+    
+    
+    /**
+     * @brief SSE2による座標変換。結果をキャッシュを通さずにメモリへ書き込む。
+     *        キャッシュに収まらない大きな格子では、書き込み先の読み込みを省ける分だけ速い。
+     *        outは16バイト境界に揃っていること。書き終えたら_mm_sfenceを呼ぶこと。
+     *///---------------------------------------------------------------------------
+    inline void  transformRowStream( const Affine2 & screen,  Element i0,  Element j,
+                                     const Element * z,  std::size_t n,  Point2 * out ) {
+        
+        const Element  (&a)[2][4] = screen.element;
+        
+        const __m128d  xx = _mm_set1_pd( a[X][X]   ),  yx = _mm_set1_pd( a[Y][X]   );
+        const __m128d  xy = _mm_set1_pd( a[X][Y]*j ),  yy = _mm_set1_pd( a[Y][Y]*j );
+        const __m128d  xz = _mm_set1_pd( a[X][Z]   ),  yz = _mm_set1_pd( a[Y][Z]   );
+        const __m128d  xw = _mm_set1_pd( a[X][W]   ),  yw = _mm_set1_pd( a[Y][W]   );
+        const __m128d  step = _mm_set1_pd(2);
+        
+        __m128d      i = _mm_set_pd( i0+1, i0 );
+        std::size_t  k = 0;
+        
+        for ( ;  k+2 <= n;  k += 2, i = _mm_add_pd( i, step ) ) {
+            
+            __m128d  vz = _mm_loadu_pd( z+k );
+            __m128d  vx = _mm_add_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd(xx,i), xy ), _mm_mul_pd(xz,vz) ), xw );
+            __m128d  vy = _mm_add_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd(yx,i), yy ), _mm_mul_pd(yz,vz) ), yw );
+            
+            _mm_stream_pd( out[k  ].element, _mm_unpacklo_pd( vx, vy ) );
+            _mm_stream_pd( out[k+1].element, _mm_unpackhi_pd( vx, vy ) );
+        }
+        
+        transformRowScalar( screen, i0+k, j, z+k, n-k, out+k );
+    }
+    
+  #endif
+    
+    
+  #ifdef PLOTER_USE_AVX
+    
+    /**
+     * @brief AVXによる座標変換。4頂点ずつ処理する。演算の順序はスカラ演算と同じ。
+     *///---------------------------------------------------------------------------
+    __attribute__((target("avx")))
+    inline void  transformRowAvx( const Affine2 & screen,  Element i0,  Element j,
+                                  const Element * z,  std::size_t n,  Point2 * out ) {
+        
+        const Element  (&a)[2][4] = screen.element;
+        
+        const __m256d  xx = _mm256_set1_pd( a[X][X]   ),  yx = _mm256_set1_pd( a[Y][X]   );
+        const __m256d  xy = _mm256_set1_pd( a[X][Y]*j ),  yy = _mm256_set1_pd( a[Y][Y]*j );
+        const __m256d  xz = _mm256_set1_pd( a[X][Z]   ),  yz = _mm256_set1_pd( a[Y][Z]   );
+        const __m256d  xw = _mm256_set1_pd( a[X][W]   ),  yw = _mm256_set1_pd( a[Y][W]   );
+        const __m256d  step = _mm256_set1_pd(4);
+        
+        __m256d      i = _mm256_set_pd( i0+3, i0+2, i0+1, i0 );
+        std::size_t  k = 0;
+        
+        for ( ;  k+4 <= n;  k += 4, i = _mm256_add_pd( i, step ) ) {
+            
+            __m256d  vz = _mm256_loadu_pd( z+k );
+            __m256d  vx = _mm256_add_pd( _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd(xx,i), xy ), _mm256_mul_pd(xz,vz) ), xw );
+            __m256d  vy = _mm256_add_pd( _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd(yx,i), yy ), _mm256_mul_pd(yz,vz) ), yw );
+            
+            __m256d  even = _mm256_unpacklo_pd( vx, vy );  // x0 y0 x2 y2
+            __m256d  odd  = _mm256_unpackhi_pd( vx, vy );  // x1 y1 x3 y3
+            
+            _mm256_storeu_pd( out[k  ].element, _mm256_permute2f128_pd( even, odd, 0x20 ) );
+            _mm256_storeu_pd( out[k+2].element, _mm256_permute2f128_pd( even, odd, 0x31 ) );
+        }
+        
+        transformRowScalar( screen, i0+k, j, z+k, n-k, out+k );
+    }
+    
+  #endif
+    
+    
+    /**
+     * @brief CPUに合った座標変換の関数を選ぶ。
+     *///---------------------------------------------------------------------------
+    inline TransformKernel  selectTransformKernel(void) {
+        
+        switch ( detectSimd() ) {
+            
+          #ifdef PLOTER_USE_AVX
+          case SIMD_AVX:   return &transformRowAvx;
+          #endif
+          #ifdef PLOTER_USE_SSE2
+          case SIMD_SSE2:  return &transformRowSse2;
+          #endif
+          default:         return &transformRowScalar;
+        }
+    }
+    
+    
+    /**
+     * @brief 格子objectの各頂点(i,j,z)の行列affineによる奥行き(第3成分)をdepthsに格納する。
+     *///---------------------------------------------------------------------------
+    inline void  transformDepth( const Matrix& affine,  const GridStore& object,  ElementArray& depths ) {
+        
+        depths.resize( object.getSize() );
+        
+        Element *  depth = depths.empty() ? 0 : &depths[0];
+        
+        for ( Index j=0;  j < object.getRowNumber();  j++ ) {
+            
+            const Element *  z = object.row(j);
+            
+            for ( Index i=0;  i < object.getColumnNumber();  i++ ) {
+                
+                *depth++ = affine(Z,X)*i + affine(Z,Y)*j + affine(Z,Z)*z[i] + affine(Z,W);
+            }
+        }
+    }
+    
+    
+    /**
+     * @brief 結果をキャッシュを通さずに書き込む格子の大きさ[バイト]の下限。
+     *        これより小さい格子は、続く処理がキャッシュから読めるように通常の書き込みで写す。
+     *///---------------------------------------------------------------------------
+    const std::size_t  STREAM_THRESHOLD = 32 << 20;
+    
+    
+    /**
+     * @brief 格子objectの各頂点(i,j,z)を行列affineで画面へ写し、targetに格納する。
+     *///---------------------------------------------------------------------------
+    inline void  transform( const Matrix& affine,  const GridStore& object,  PointArray& target ) {
+        
+        static const TransformKernel  kernel = selectTransformKernel();
+        
+        const Affine2  screen = toScreen( affine );
+        
+        target.resize( object.getSize() );
+        
+        if ( target.empty() ) { return; }
+        
+        Point2 *         point  = &target[0];
+        TransformKernel  chosen = kernel;
+        
+      #ifdef PLOTER_USE_SSE2
+        
+        bool  isStream = ( kernel != &transformRowScalar ) && target.size() * sizeof(Point2) >= STREAM_THRESHOLD
+                                                            && reinterpret_cast<std::size_t>(point) % 16 == 0;
+        
+        if ( isStream ) { chosen = &transformRowStream; }
+        
+      #endif
+        
+        for ( Index j=0;  j < object.getRowNumber();  j++, point += object.getColumnNumber() ) {
+            
+            chosen( screen, 0, j, object.row(j), object.getColumnNumber(), point );
+        }
+        
+      #ifdef PLOTER_USE_SSE2
+        
+        if ( isStream ) { _mm_sfence(); }
+        
+      #endif
+    }
+}
+#endif
@@ -0,0 +1,659 @@
+/**
+ * @file   Loader.h
+ * @author 村田 裕一
+ * @brief  データファイルを読み込むクラス郡を定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_LOADER_H
+#define  INCLUDED_LOADER_H
+
+#include  <cstring>
+#include  <fstream>
+#include  <vector>
+#include  <boost/utility.hpp>
+#include  "Utility.h"
+#include  "Thread.h"
+
+#ifndef  _WIN32
+#include  <fcntl.h>
+#include  <unistd.h>
+#include  <sys/stat.h>
+#include  <sys/mman.h>
+#endif
+
+namespace Ploter {
+    
+    /**
+     * @brief 10の累乗の表。仮数が2^53以下ならば、この範囲で誤差なく計算できる。
+     *///---------------------------------------------------------------------------
+    const double  POWER_OF_TEN[] = {
+        
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    
+    
+    /**
+     * @brief 空白(改行を除く)を読み飛ばす。
+     *///---------------------------------------------------------------------------
+    inline void  skipBlank( const char *& p,  const char * end ) {
+        
+        while ( p != end && ( *p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f' ) ) { ++p; }
+    }
+    
+    
+    /**
+     * @brief [p,end)の先頭の数値をvalueに読み込み、pを数値の直後に進める。
+     *        ロケールに依存せず、小数点は常に'.'として扱う。
+     *///---------------------------------------------------------------------------
+    inline bool  parseElement( const char *& p,  const char * end,  Element & value ) {
+        
+        const char *        current  = p;
+        bool                negative = false;
+        unsigned long long  mantissa = 0;
+        int                 digits   = 0;
+        int                 exponent = 0;
+        bool                isNumber = false;
+        
+        if ( current != end && ( *current == '-' || *current == '+' ) ) { negative = ( *current++ == '-' ); }
+        
+        for ( ;  current != end && '0' <= *current && *current <= '9';  ++current ) {
+            
+            isNumber = true;
+            
+            if      ( digits < 19 ) { mantissa = mantissa * 10 + ( *current - '0' );  digits += ( mantissa != 0 ); }
+            else                    { ++exponent; }
+        }
+        
+        if ( current != end && *current == '.' ) {
+            
+            for ( ++current;  current != end && '0' <= *current && *current <= '9';  ++current ) {
+                
+                isNumber = true;
+                
+                if ( digits < 19 ) { mantissa = mantissa * 10 + ( *current - '0' );  digits += ( mantissa != 0 );  --exponent; }
+            }
+        }
+        
+        if ( ! isNumber ) { return false; }
+        
+        if ( current != end && ( *current == 'e' || *current == 'E' ) ) {
+            
+            const char *  mark        = current++;
+            bool          isNegative  = false;
+            int           number      = 0;
+            
+            if ( current != end && ( *current == '-' || *current == '+' ) ) { isNegative = ( *current++ == '-' ); }
+            
+            if ( current == end || *current < '0' || '9' < *current ) {
+                
+                current = mark;
+                
+            } else {
+                
+                for ( ;  current != end && '0' <= *current && *current <= '9';  ++current ) {
+                    
+                    if ( number < 10000 ) { number = number * 10 + ( *current - '0' ); }
+                }
+                
+                exponent += isNegative ? -number : number;
+            }
+        }
+        
+        if ( mantissa == 0 ) {
+            
+            value = 0;
+            
+        } else if ( mantissa <= ( 1ULL << 53 ) && -22 <= exponent && exponent <= 22 ) {
+            
+            value = ( exponent < 0 ) ? static_cast<Element>(mantissa) / POWER_OF_TEN[-exponent]
+                                     : static_cast<Element>(mantissa) * POWER_OF_TEN[ exponent];
+            
+        } else {
+            
+            long double  result = static_cast<long double>(mantissa);
+            long double  scale  = 10;
+            
+            if      ( exponent >  400 ) { exponent =  400; }
+            else if ( exponent < -400 ) { exponent = -400; }
+            
+            for ( int n = ( exponent < 0 ) ? -exponent : exponent;  n != 0;  n >>= 1, scale *= scale ) {
+                
+                if ( n & 1 ) { result = ( exponent < 0 ) ? result / scale : result * scale; }
+            }
+            
+            value = static_cast<Element>(result);
+        }
+        
+        if ( negative ) { value = -value; }
+        
+        p = current;
+        
+        return true;
+    }
+    
+    
+    /**
+     * @brief 読み込み専用でメモリにマップしたファイルを表すクラス。
+     *///---------------------------------------------------------------------------
+    class MappedFile : noncopyable {
+        
+      public:
+        
+      #ifdef _WIN32
+        
+        MappedFile(void) : address(0), size(0), file(INVALID_HANDLE_VALUE), mapping(0) {}
+        
+      #else
+        
+        MappedFile(void) : address(0), size(0), descriptor(-1) {}
+        
+      #endif
+        
+        ~MappedFile(void) { this->close(); }
+        
+        /**
+         * @brief pathが指すファイルをマップする。
+         *///---------------------------------------------------------------------------
+        bool  open( const char * path ) {
+            
+            this->close();
+            
+          #ifdef _WIN32
+            
+            this->file = CreateFile( path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0 );
+            
+            if ( this->file == INVALID_HANDLE_VALUE ) { return false; }
+            
+            DWORD  high = 0;
+            DWORD  low  = GetFileSize( this->file, &high );
+            
+            this->size = static_cast<std::size_t>( ( static_cast<unsigned long long>(high) << 32 ) | low );
+            
+            if ( this->size == 0 ) { return true; }
+            
+            this->mapping = CreateFileMapping( this->file, 0, PAGE_READONLY, 0, 0, 0 );
+            
+            if ( this->mapping == 0 ) { this->close();  return false; }
+            
+            this->address = static_cast<const char *>( MapViewOfFile( this->mapping, FILE_MAP_READ, 0, 0, 0 ) );
+            
+          #else
+            
+            struct stat  status;
+            
+            this->descriptor = ::open( path, O_RDONLY );
+            
+            if ( this->descriptor < 0 || fstat( this->descriptor, &status ) != 0 ) { this->close();  return false; }
+            
+            this->size = static_cast<std::size_t>( status.st_size );
+            
+            if ( this->size == 0 ) { return true; }
+            
+            void *  address = mmap( 0, this->size, PROT_READ, MAP_PRIVATE, this->descriptor, 0 );
+            
+            this->address = ( address == MAP_FAILED ) ? 0 : static_cast<const char *>(address);
+            
+          #endif
+            
+            if ( this->address == 0 ) { this->close();  return false; }
+            
+            return true;
+        }
+        
+        /**
+         * @brief マップを解除する。
+         *///---------------------------------------------------------------------------
+        void  close(void) {
+            
+          #ifdef _WIN32
+            
+            if ( this->address != 0                    ) { UnmapViewOfFile( this->address ); }
+            if ( this->mapping != 0                    ) { CloseHandle    ( this->mapping ); }
+            if ( this->file    != INVALID_HANDLE_VALUE ) { CloseHandle    ( this->file    ); }
+            
+            this->mapping = 0;
+            this->file    = INVALID_HANDLE_VALUE;
+            
+          #else
+            
+            if ( this->address    != 0 ) { munmap( const_cast<char *>(this->address), this->size ); }
+            if ( this->descriptor >= 0 ) { ::close( this->descriptor ); }
+            
+            this->descriptor = -1;
+            
+          #endif
+            
+            this->address = 0;
+            this->size    = 0;
+        }
+        
+        /**
+         * @brief アクセッサ。
+         *///---------------------------------------------------------------------------
+        const char *  begin  (void) const { return this->address;              }
+        const char *  end    (void) const { return this->address + this->size; }
+        std::size_t   getSize(void) const { return this->size;                 }
+        
+      private:
+        
+        const char *  address;
+        std::size_t   size;
+        
+      #ifdef _WIN32
+        
+        HANDLE        file;
+        HANDLE        mapping;
+        
+      #else
+        
+        int           descriptor;
+        
+      #endif
+    };
+    
+    
+    /**
+     * @brief 空白区切りのテキスト形式のデータファイルを読み込むクラス。
+     *        ファイルをメモリにマップし、行ごとの文字列を作らずにその場で数値を読み込む。
+     *        大きなファイルは改行の位置で区間に分割し、区間ごとに別のスレッドで読み込む。
+     *///---------------------------------------------------------------------------
+    class GridLoader {
+        
+      public:
+        
+        enum { CHUNK_SIZE = 1 << 20 };
+        
+        GridLoader(void) : rowNumber(0), columnNumber(0) {}
+        
+        /**
+         * @brief pathが指すファイルを開き、行数と列数を求める。
+         *///---------------------------------------------------------------------------
+        bool  open( const char * path ) {
+            
+            this->rowNumber    = 0;
+            this->columnNumber = 0;
+            this->chunks.clear();
+            
+            if ( ! this->file.open(path) || this->file.getSize() == 0 ) { return false; }
+            
+            this->scanColumn();
+            this->divide();
+            
+            RowCounter  counter( this->chunks );
+            
+            parallelFor( this->chunks.size(), counter );
+            
+            for ( std::size_t k=0;  k < this->chunks.size();  k++ ) {
+                
+                this->chunks[k].firstRow  = this->rowNumber;
+                this->rowNumber          += this->chunks[k].rowNumber;
+            }
+            
+            return  this->rowNumber != 0 && this->columnNumber != 0;
+        }
+        
+        /**
+         * @brief アクセッサ。
+         *///---------------------------------------------------------------------------
+        std::size_t  getRowNumber   (void) const { return this->rowNumber;    }
+        std::size_t  getColumnNumber(void) const { return this->columnNumber; }
+        
+        /**
+         * @brief 全ての値を読み込み、j行i列の値valueごとにreceiver(j,i,value)を呼ぶ。
+         *        receiverは異なる行について同時に呼ばれる。
+         *        列数が揃っていない行、または数値でない値があればfalseを返す。
+         *///---------------------------------------------------------------------------
+        template<class ReceiverType>
+        bool  read( ReceiverType & receiver ) const {
+            
+            ChunkReader<ReceiverType>  reader( this->chunks, this->columnNumber, receiver );
+            
+            parallelFor( this->chunks.size(), reader );
+            
+            return  reader.isValid();
+        }
+        
+        /**
+         * @brief 全ての値をstoreに読み込む。
+         *///---------------------------------------------------------------------------
+        bool  read( GridStore & store ) const {
+            
+            StoreSetter  setter(store);
+            
+            store.resize( this->rowNumber, this->columnNumber );
+            
+            return  this->read(setter);
+        }
+        
+      private:
+        
+        /**
+         * @brief 改行の位置で区切ったファイルの区間。
+         *///---------------------------------------------------------------------------
+        struct Chunk {
+            
+            const char *  begin;
+            const char *  end;
+            std::size_t   firstRow;
+            std::size_t   rowNumber;
+        };
+        
+        typedef std::vector<Chunk>  ChunkList;
+        
+        /**
+         * @brief 読み込んだ値をGridStoreに設定する関数オブジェクト。
+         *///---------------------------------------------------------------------------
+        class StoreSetter {
+            
+          public:
+            
+            StoreSetter( GridStore & store_) : store( store_) {}
+            
+            void  operator ()( Index j,  Index i,  Element value ) {
+                
+                this->store(j,i) = value;
+            }
+            
+          private:
+            
+            GridStore &  store;
+        };
+        
+        /**
+         * @brief 区間内の空行を除いた行数を数える関数オブジェクト。
+         *///---------------------------------------------------------------------------
+        class RowCounter {
+            
+          public:
+            
+            RowCounter( ChunkList & chunks_) : chunks( chunks_) {}
+            
+            void  operator ()( std::size_t k ) {
+                
+                Chunk &  chunk = this->chunks[k];
+                
+                chunk.rowNumber = 0;
+                
+                for ( const char * p = chunk.begin;  p != chunk.end; ) {
+                    
+                    const char *  lineEnd = static_cast<const char *>( std::memchr( p, '\n', chunk.end - p ) );
+                    
+                    if ( lineEnd == 0 ) { lineEnd = chunk.end; }
+                    
+                    skipBlank( p, lineEnd );
+                    
+                    if ( p != lineEnd ) { ++chunk.rowNumber; }
+                    
+                    p = ( lineEnd == chunk.end ) ? chunk.end : lineEnd + 1;
+                }
+            }
+            
+          private:
+            
+            ChunkList &  chunks;
+        };
+        
+        /**
+         * @brief 区間内の行を読み込み、各行の位置に書き込む関数オブジェクト。
+         *        列数の揃っていない行を見つけた区間を記録し、最後にまとめて判定する。
+         *///---------------------------------------------------------------------------
+        template<class ReceiverType>
+        class ChunkReader {
+            
+          public:
+            
+            ChunkReader( const ChunkList & chunks_,  std::size_t columnNumber_,  ReceiverType & receiver_) :
+                
+                chunks( chunks_), columnNumber( columnNumber_), receiver( receiver_), validity( chunks_.size(), 1 )
+            {}
+            
+            void  operator ()( std::size_t k ) {
+                
+                const Chunk &  chunk = this->chunks[k];
+                const char *   p     = chunk.begin;
+                
+                for ( Index j = chunk.firstRow;  j < chunk.firstRow + chunk.rowNumber;  j++ ) {
+                    
+                    if ( ! this->readRow( p, chunk.end, j ) ) { this->validity[k] = 0;  return; }
+                }
+            }
+            
+            bool  isValid(void) const {
+                
+                return  std::find( this->validity.begin(), this->validity.end(), 0 ) == this->validity.end();
+            }
+            
+          private:
+            
+            bool  readRow( const char *& p,  const char * end,  Index j ) {
+                
+                GridLoader::skipBlankLine( p, end );
+                
+                for ( Index i=0;  i < this->columnNumber;  i++ ) {
+                    
+                    Element  value;
+                    
+                    skipBlank( p, end );
+                    
+                    if ( p == end || *p == '\n' || ! parseElement( p, end, value ) ) { return false; }
+                    
+                    this->receiver( j, i, value );
+                }
+                
+                skipBlank( p, end );
+                
+                return  p == end || *p++ == '\n';
+            }
+            
+            const ChunkList &  chunks;
+            std::size_t        columnNumber;
+            ReceiverType &     receiver;
+            std::vector<char>  validity;
+        };
+        
+        /**
+         * @brief 最初の空でない行の列数を求める。
+         *///---------------------------------------------------------------------------
+        void  scanColumn(void) {
+            
+            const char *  p   = this->file.begin();
+            const char *  end = this->file.end();
+            
+            GridLoader::skipBlankLine( p, end );
+            
+            const char *  lineEnd = static_cast<const char *>( std::memchr( p, '\n', end - p ) );
+            
+            this->columnNumber = GridLoader::countColumn( p, ( lineEnd == 0 ) ? end : lineEnd );
+        }
+        
+        /**
+         * @brief ファイルを改行の直後で区切り、ほぼ同じ大きさの区間に分割する。
+         *///---------------------------------------------------------------------------
+        void  divide(void) {
+            
+            std::size_t   size   = this->file.getSize();
+            std::size_t   number = std::min( getProcessorNumber() * 4,  size / GridLoader::CHUNK_SIZE + 1 );
+            const char *  begin  = this->file.begin();
+            
+            for ( std::size_t k=1;  k <= number;  k++ ) {
+                
+                const char *  end = this->file.begin() + size / number * k;
+                
+                if ( k == number ) { end = this->file.end(); }
+                
+                if ( end < begin ) { continue; }
+                
+                const char *  lineEnd = static_cast<const char *>( std::memchr( end, '\n', this->file.end() - end ) );
+                
+                end = ( lineEnd == 0 ) ? this->file.end() : lineEnd + 1;
+                
+                Chunk  chunk = { begin, end, 0, 0 };
+                
+                this->chunks.push_back(chunk);
+                
+                if ( ( begin = end ) == this->file.end() ) { break; }
+            }
+        }
+        
+        /**
+         * @brief [p,end)に含まれる値の数を求める。
+         *///---------------------------------------------------------------------------
+        static std::size_t  countColumn( const char * p,  const char * end ) {
+            
+            std::size_t  number = 0;
+            
+            for ( skipBlank( p, end );  p != end;  skipBlank( p, end ) ) {
+                
+                while ( p != end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\v' && *p != '\f' ) { ++p; }
+                
+                ++number;
+            }
+            
+            return  number;
+        }
+        
+        /**
+         * @brief 空行を読み飛ばす。
+         *///---------------------------------------------------------------------------
+        static void  skipBlankLine( const char *& p,  const char * end ) {
+            
+            for ( const char * q = p;  q != end;  p = q ) {
+                
+                skipBlank( q, end );
+                
+                if ( q == end || *q != '\n' ) { return; }
+                
+                ++q;
+            }
+        }
+        
+        MappedFile   file;
+        ChunkList    chunks;
+        std::size_t  rowNumber;
+        std::size_t  columnNumber;
+    };
+    
+    /**
+     * @brief バイナリ形式(.3dg)のデータファイルのヘッダ。
+     *        ヘッダの直後に、行優先で並べたz値(リトルエンディアンのdouble)が続く。
+     *        minimum,maximumはx,y,zそれぞれの最小値・最大値。
+     *///---------------------------------------------------------------------------
+    struct GridHeader {
+        
+        enum { VERSION = 1, ELEMENT_DOUBLE = 1 };
+        
+        char                magic[4];
+        unsigned int        version;
+        unsigned int        elementType;
+        unsigned int        reserved;
+        unsigned long long  rowNumber;
+        unsigned long long  columnNumber;
+        double              minimum[3];
+        double              maximum[3];
+    };
+    
+    const char  GRID_MAGIC[4] = { '3','D','G','\0' };
+    
+    
+    /**
+     * @brief バイナリ形式のデータファイルを読み込み専用でマップするクラス。
+     *        z値はマップした領域をそのまま参照する。
+     *///---------------------------------------------------------------------------
+    class BinaryGridLoader {
+        
+      public:
+        
+        BinaryGridLoader(void) : header(0), data(0) {}
+        
+        /**
+         * @brief pathが指すファイルがバイナリ形式かどうかを判定する。
+         *///---------------------------------------------------------------------------
+        static bool  isBinary( const char * path ) {
+            
+            char           magic[4] = { 0 };
+            std::ifstream  ifs( path, std::ios::binary );
+            
+            ifs.read( magic, sizeof(magic) );
+            
+            return  ifs && std::memcmp( magic, GRID_MAGIC, sizeof(magic) ) == 0;
+        }
+        
+        /**
+         * @brief pathが指すファイルをマップし、ヘッダを検査する。
+         *///---------------------------------------------------------------------------
+        bool  open( const char * path ) {
+            
+            this->header = 0;
+            this->data   = 0;
+            
+            if ( ! this->file.open(path) || this->file.getSize() < sizeof(GridHeader) ) { return false; }
+            
+            const GridHeader *  header = reinterpret_cast<const GridHeader *>( this->file.begin() );
+            unsigned long long  number = header->rowNumber * header->columnNumber;
+            
+            if ( std::memcmp( header->magic, GRID_MAGIC, sizeof(GRID_MAGIC) ) != 0 ||
+                 header->version      != GridHeader::VERSION                         ||
+                 header->elementType  != GridHeader::ELEMENT_DOUBLE                  ||
+                 header->rowNumber    == 0 || header->columnNumber == 0              ||
+                 number / header->columnNumber != header->rowNumber                  ||
+                 number > ( this->file.getSize() - sizeof(GridHeader) ) / sizeof(Element) ) { return false; }
+            
+            this->header = header;
+            this->data   = reinterpret_cast<const Element *>( this->file.begin() + sizeof(GridHeader) );
+            
+            return true;
+        }
+        
+        /**
+         * @brief アクセッサ。
+         *///---------------------------------------------------------------------------
+        const GridHeader &  getHeader      (void) const { return *this->header;                                         }
+        std::size_t         getRowNumber   (void) const { return static_cast<std::size_t>( this->header->rowNumber    ); }
+        std::size_t         getColumnNumber(void) const { return static_cast<std::size_t>( this->header->columnNumber ); }
+        const Element *     getData        (void) const { return this->data;                                            }
+        
+      private:
+        
+        MappedFile           file;
+        const GridHeader *   header;
+        const Element *      data;
+    };
+    
+    
+    /**
+     * @brief storeのz値をバイナリ形式でpathに書き込む。
+     *        x,yの範囲は列・行の番号から、zの範囲は値から求める。
+     *///---------------------------------------------------------------------------
+    inline bool  writeBinaryGrid( const char * path,  const GridStore & store ) {
+        
+        GridHeader  header;
+        
+        std::memset( &header, 0, sizeof(header) );
+        std::memcpy( header.magic, GRID_MAGIC, sizeof(GRID_MAGIC) );
+        
+        header.version      = GridHeader::VERSION;
+        header.elementType  = GridHeader::ELEMENT_DOUBLE;
+        header.rowNumber    = store.getRowNumber();
+        header.columnNumber = store.getColumnNumber();
+        header.minimum[X]   = 0;
+        header.maximum[X]   = static_cast<double>( store.getColumnNumber() - 1 );
+        header.minimum[Y]   = 0;
+        header.maximum[Y]   = static_cast<double>( store.getRowNumber   () - 1 );
+        header.minimum[Z]   =  ELEMENT_EXTREAM_VALUE;
+        header.maximum[Z]   = -ELEMENT_EXTREAM_VALUE;
+        
+        for ( const Element * z = store.begin();  z != store.end();  z++ ) {
+            
+            header.minimum[Z] = std::min( header.minimum[Z], *z );
+            header.maximum[Z] = std::max( header.maximum[Z], *z );
+        }
+        
+        std::ofstream  ofs( path, std::ios::binary );
+        
+        ofs.write( reinterpret_cast<const char *>(&header),       sizeof(header)                   );
+        ofs.write( reinterpret_cast<const char *>(store.begin()), sizeof(Element) * store.getSize() );
+        
+        return  ofs.good();
+    }
+}
+#endif
@@ -0,0 +1,146 @@
+/**
+ * @file   Pipeline.h
+ * @author 村田 裕一
+ * @brief  z値の操作(正規化・対数縮尺)と最小値・最大値の査定を1回の走査で行うクラスを定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_PIPELINE_H
+#define  INCLUDED_PIPELINE_H
+
+#include  <vector>
+#include  <cmath>
+#include  "Utility.h"
+
+namespace Ploter {
+    
+    /**
+     * @brief z値に適用する段の組み合わせを管理し、格子に適用するクラス。
+     *        行・列の和は前処理の1回の走査で求め、各段の適用と最小値・最大値の査定は
+     *        要素ごとにまとめて行う。段の順序は行の正規化、列の正規化、対数縮尺。
+     *///---------------------------------------------------------------------------
+    class VertexPipeline {
+        
+      public:
+        
+        enum {
+            
+            REGULARIZE_ROWS    = 1 << 0,
+            REGULARIZE_COLUMNS = 1 << 1,
+            LOG_SCALE          = 1 << 2,
+        };
+        
+        VertexPipeline(void) : stages(0) {}
+        
+        /**
+         * @brief 適用する段を設定する。
+         *///---------------------------------------------------------------------------
+        void  setStages( int stages_) { this->stages = stages_; }
+        
+        /**
+         * @brief 適用する段があるかどうか。
+         *///---------------------------------------------------------------------------
+        bool  isEmpty(void) const { return this->stages == 0; }
+        
+        /**
+         * @brief sourceの各要素に段を適用してtargetに格納し、zの最小値・最大値をminmaxに設定する。
+         *        段の組み合わせごとに特殊化したループを1度だけ選んで実行する。
+         *///---------------------------------------------------------------------------
+        void  run( const GridStore& source,  GridStore& target,  MinMaxManager& minmax ) {
+            
+            this->prepare( source );
+            
+            target.resize( source.getRowNumber(), source.getColumnNumber() );
+            minmax.setGrid( source );
+            
+            switch ( this->stages ) {   // 段は3ビットで表すので8通り。
+                
+              case 0:   this->runStages<0>( source, target, minmax );  break;
+              case 1:   this->runStages<1>( source, target, minmax );  break;
+              case 2:   this->runStages<2>( source, target, minmax );  break;
+              case 3:   this->runStages<3>( source, target, minmax );  break;
+              case 4:   this->runStages<4>( source, target, minmax );  break;
+              case 5:   this->runStages<5>( source, target, minmax );  break;
+              case 6:   this->runStages<6>( source, target, minmax );  break;
+              default:  this->runStages<7>( source, target, minmax );  break;
+            }
+        }
+        
+      private:
+        
+        /**
+         * @brief 正規化に使う行ごと・列ごとの絶対値の和を求める。
+         *        列の和は行の正規化を適用した後の値について求める。
+         *        行は読み込んだ直後でキャッシュに残っているので、sourceの走査は実質1回になる。
+         *///---------------------------------------------------------------------------
+        void  prepare( const GridStore& source ) {
+            
+            bool  isRows    = ( this->stages & REGULARIZE_ROWS    ) != 0;
+            bool  isColumns = ( this->stages & REGULARIZE_COLUMNS ) != 0;
+            
+            this->rowSum   .assign( isRows    ? source.getRowNumber()    : 0, 0 );
+            this->columnSum.assign( isColumns ? source.getColumnNumber() : 0, 0 );
+            
+            if ( ! isRows && ! isColumns ) { return; }
+            
+            for ( Index j=0;  j < source.getRowNumber();  j++ ) {
+                
+                const Element *  z = source.row(j);
+                
+                if ( isRows ) {
+                    
+                    for ( Index i=0;  i < source.getColumnNumber();  i++ ) { this->rowSum[j] += std::fabs(z[i]); }
+                }
+                
+                if ( isColumns ) {
+                    
+                    for ( Index i=0;  i < source.getColumnNumber();  i++ ) {
+                        
+                        this->columnSum[i] += std::fabs( this->divideRow( z[i], j ) );
+                    }
+                }
+            }
+        }
+        
+        /**
+         * @brief 段の組み合わせStagesについて特殊化した、適用と査定のループ。
+         *        行の正規化の除数は行ごとに1度だけ求める。
+         *///---------------------------------------------------------------------------
+        template<int Stages>
+        void  runStages( const GridStore& source,  GridStore& target,  MinMaxManager& minmax ) const {
+            
+            for ( Index j=0;  j < source.getRowNumber();  j++ ) {
+                
+                const Element *  from   = source.row(j);
+                Element *        to     = target.row(j);
+                bool             isRows = ( Stages & REGULARIZE_ROWS ) && this->rowSum[j] != 0;
+                
+                for ( Index i=0;  i < source.getColumnNumber();  i++ ) {
+                    
+                    Element  value = from[i];
+                    
+                    if ( isRows ) { value /= this->rowSum[j]; }
+                    
+                    if ( ( Stages & REGULARIZE_COLUMNS ) && this->columnSum[i] != 0 ) { value /= this->columnSum[i]; }
+                    
+                    if ( ( Stages & LOG_SCALE ) && value != 0 ) { value = std::log10(value) + 1; }
+                    
+                    to[i] = value;
+                    
+                    minmax.z.assess( value );
+                }
+            }
+        }
+        
+        /**
+         * @brief 行の正規化を適用する。
+         *///---------------------------------------------------------------------------
+        Element  divideRow( Element value,  Index j ) const {
+            
+            return  ( ( this->stages & REGULARIZE_ROWS ) && this->rowSum[j] != 0 ) ? value / this->rowSum[j] : value;
+        }
+        
+        int                   stages;
+        std::vector<Element>  rowSum;
+        std::vector<Element>  columnSum;
+    };
+}
+#endif
@@ -1,957 +1,2301 @@
-/**
- * @file   Ploter.h
- * @author c T
- * @brief  Ot̗vfƂ𓝊NXS`t@CB
- *///---------------------------------------------------------------------------
-#ifndef  INCLUDED_PLOTER_H
-#define  INCLUDED_PLOTER_H
-
-#include  <iostream>
-#include  <fstream>
-#include  <sstream>
-#include  <list>
-#include  <deque>
-#include  <boost/shared_ptr.hpp>
-#include  <boost/mem_fn.hpp>
-#include  <boost/utility.hpp>
-#include  "Utility.h"
-
-namespace Ploter {
-    
-    class HiddenLineManager;
-    
-    /**
-     * @brief ώ@Ώۂ\NXB
-     *///---------------------------------------------------------------------------
-    class Subject {
-        
-      public:
-        
-        virtual       std::size_t  getIntervalNumber (void) const { return 0;                        }
-        virtual const VertexList & getPositions      (void) const { return Subject::dummyVertexList; }
-        virtual const Vector     & getDirection      (void) const { return Subject::dummyVector;     }
-        virtual       bool         isSettablePosition(int ) const { return false;                    }
-        
-      private:
-        
-        static VertexList  dummyVertexList;
-        static Vector      dummyVector;
-    };
-    
-    VertexList  Subject::dummyVertexList;
-    Vector      Subject::dummyVector;
-    
-    
-    /**
-     * @brief {Ώۂ\NXB
-     *///---------------------------------------------------------------------------
-    class Scannee {
-        
-      public:
-        
-        virtual void  acceptScanning     ( HiddenLineManager * )       = 0;
-        virtual void  acceptComplementing( HiddenLineManager * )       = 0;
-        virtual void  draw               ( void                ) const = 0;
-    };
-    
-    
-    /**
-     * @brief B
-     *///---------------------------------------------------------------------------
-    class ScanLine {
-        
-      public:
-        
-        ScanLine( Element scanLine ) : position(scanLine) {
-            
-            minmax.initialize();
-        }
-        
-        friend bool operator <  ( const ScanLine & leftOP,  const ScanLine & rightOP ) { return    leftOP.position <  rightOP.position;   }
-        friend bool operator <= ( const ScanLine & leftOP,  const ScanLine & rightOP ) { return    leftOP.position <= rightOP.position;   }
-        friend bool operator == ( const ScanLine & leftOP,  const ScanLine & rightOP ) { return    leftOP.position == rightOP.position;   }
-        friend bool operator >  ( const ScanLine & leftOP,  const ScanLine & rightOP ) { return !( leftOP          <  rightOP          ); }
-        friend bool operator >= ( const ScanLine & leftOP,  const ScanLine & rightOP ) { return !( leftOP          <= rightOP          ); }
-        friend bool operator != ( const ScanLine & leftOP,  const ScanLine & rightOP ) { return !( leftOP          == rightOP          ); }
-        
-        Element  position;
-        MinMax   minmax;
-    };
-    
-    
-    /**
-     * @brief AǗNXB
-     *///---------------------------------------------------------------------------
-    class HiddenLineManager {
-        
-      public:
-        
-        typedef  std::list<ScanLine>            ScanLineList;
-        typedef  std::list<ScanLine>::iterator  ScanLineListIterator;
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        HiddenLineManager( Scannee * target ) {
-            
-            if ( Option("Graph").get("isHiddenLine") ) {
-                
-                this->resetPosition();
-                
-                target->acceptScanning(this);
-                
-                this->scanLines.sort  ();
-                this->scanLines.unique();
-                
-                target->acceptComplementing(this);
-            }
-            
-            target->draw();
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  resetPosition(void) {
-            
-            this->currentScanLine = this->scanLines.begin();
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  addScanLine( Element scanLine ) {
-            
-            this->scanLines.push_back(scanLine);
-        }
-        
-        ScanLineListIterator  currentScanLine;
-        
-      private:
-        
-        ScanLineList  scanLines;
-    };
-    
-    
-    /**
-     * @brief Otvf\NXB
-     *///---------------------------------------------------------------------------
-    template<class ChildType>
-    class Composite {
-        
-      public:
-        
-        /**
-         * @brief childqvfɐݒ肷B
-         *///---------------------------------------------------------------------------
-        void  setChild( ChildType * child ) {
-            
-            this->child = shared_ptr<ChildType>(child);
-        }
-        
-        /**
-         * @brief qvf擾B
-         *///---------------------------------------------------------------------------
-        const ChildType * getChild(void) const {
-            
-            return this->child.get();
-        }
-        
-        /**
-         * @brief gƎqvfsaffineōWϊA`悷B
-         *///---------------------------------------------------------------------------
-        void  draw( const Matrix & affine ) const {
-            
-            this->drawMyself(affine);
-            
-            if ( this->child != 0 ) { this->child->draw(affine); }
-        }
-        
-      private:
-        
-        virtual void  drawMyself( const Matrix & affine ) const = 0;
-        
-      protected:
-        
-        shared_ptr<ChildType>  child;
-    };
-    
-    
-    /**
-     * @brief Otvf̏W\NXB
-     *///---------------------------------------------------------------------------
-    template<class ChildType>
-    class Collection : public Scannee {
-        
-      public:
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  acceptScanning( HiddenLineManager * hiddenLineManager ) {
-            
-            this->accept( hiddenLineManager, &Scannee::acceptScanning  );
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  acceptComplementing( HiddenLineManager * hiddenLineManager ) {
-            
-            this->accept( hiddenLineManager, &Scannee::acceptComplementing );
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        virtual void  draw(void) const {
-            
-            std::for_each( this->children.begin(), this->children.end(), mem_fn( &Scannee::draw ) );
-        }
-        
-      protected:
-        
-        std::deque<ChildType>  children;
-        
-      private:
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  accept( HiddenLineManager * hiddenLineManager,  void (Scannee::*accept)(HiddenLineManager *) ) {
-            
-            std::for_each( this->children.begin(), this->children.end(),
-                
-                bind( accept, _1, hiddenLineManager )
-            );
-        }
-    };
-    
-    
-    /**
-     * @brief \NXB
-     *///---------------------------------------------------------------------------
-    class Line : public Scannee {
-        
-      public:
-        
-        /**
-         * @brief n_begin_ƏI_end_Ԑ𐶐B
-         *///---------------------------------------------------------------------------
-        Line( const Vector & begin_, const Vector & end_) :
-            
-            begin( begin_), end( end_), source(X), target(Y)
-        {}
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        const Vector & getBegin(void) const { return this->begin; }
-        const Vector & getEnd  (void) const { return this->begin; }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  draw(void) const {
-            
-            if ( Option("Graph").get("isHiddenLine") ) {
-                
-                for ( std::list<Vector>::const_iterator  it = this->points.begin();  next(it) != this->points.end();  it++ ) {
-                    
-                    drawVertex( *      it  );
-                    drawVertex( * next(it) );
-                }
-                
-            } else {
-                
-                drawVertex( this->begin );
-                drawVertex( this->end   );
-            }
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  acceptScanning( HiddenLineManager * hiddenLineManager ) {
-            
-            this->findCharacter();
-            
-            hiddenLineManager->addScanLine( this->begin(this->source) );
-            hiddenLineManager->addScanLine( this->end  (this->source) );
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  acceptComplementing( HiddenLineManager * hiddenLineManager ) {
-            
-            this->points.clear();
-            
-            while ( this->isInRange( hiddenLineManager->currentScanLine->position ) ) {
-                
-                Vector  point(V::W_UNIT);
-                
-                point(this->source) = hiddenLineManager->currentScanLine->position;
-                point(this->target) = this->f( point(this->source) );
-                point(Z           ) = this->begin(this->target);
-                
-                if ( hiddenLineManager->currentScanLine->minmax.assess( point(this->target) ) != MinMax::INNER ) {
-                    
-                    this->points.push_back(point);
-                }
-                
-                hiddenLineManager->currentScanLine++;
-            }
-            
-            hiddenLineManager->currentScanLine--;
-        }
-        
-      private:
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  pushBackPoint( HiddenLineManager * hiddenLineManager,  const Vector & point ) {
-            
-            if ( (hiddenLineManager->currentScanLine++)->minmax.assess( point(this->target) ) ) {
-                
-                this->points.push_back(point);
-            }
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        bool  isInRange( Element scanLine ) {
-            
-            return  ( this->begin(this->source) <= scanLine ) && ( scanLine <= this->end(this->source) );
-        }
-        
-        /**
-         * @brief ̓߂B
-         *///---------------------------------------------------------------------------
-        void  findCharacter(void) {
-            
-            Element  x1 = this->begin(this->source),  x2 = this->end(this->source);
-            Element  y1 = this->begin(this->target),  y2 = this->end(this->target);
-            
-            this->delta     = ( y2 - y1 ) / ( x2 - x1 );
-            this->intercept =   y1 - this->delta * x1;
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        Element  f( Element x ) const {
-            
-            return  this->delta*x + this->intercept;
-        }
-        
-        const Vector &     begin;
-        const Vector &     end;
-        Element            delta;
-        Element            intercept;
-        std::size_t        source;
-        std::size_t        target;
-        std::list<Vector>  points;
-    };
-    
-    
-    /**
-     * @brief F\NXB
-     *///---------------------------------------------------------------------------
-    class RGBA {
-        
-      public:
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        RGBA( double r_ = 0.0, double g_ = 0.0, double b_ = 0.0, double a_ = 1.0 ) :
-            
-            r( r_), g( g_), b( b_), a( a_)
-        {}
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  set(void) const {
-            
-            glColor4d( this->r, this->g, this->b, this->a );
-        }
-        
-        double  r;
-        double  g;
-        double  b;
-        double  a;
-    };
-    
-    
-    /**
-     * @brief |C\NXB
-     *///---------------------------------------------------------------------------
-    class PolyLine : public Collection<Line> {
-        
-      public:
-        
-        /**
-         * @brief [begin,end)͈̔͂̒_̏W|C𐶐B
-         *///---------------------------------------------------------------------------
-        template<class IteratorType>
-        PolyLine( IteratorType begin,  IteratorType end ) {
-            
-            for ( IteratorType it = begin;  it != end-1;  it++ ) {
-                
-                this->children.push_back( Line( *it, *(it+1) ) );
-            }
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  acceptComplementing( HiddenLineManager * hiddenLineManager ) {
-            
-            hiddenLineManager->resetPosition();
-            
-            for ( Element firstScanLine = this->children.begin()->getBegin()(X);
-                
-                hiddenLineManager->currentScanLine->position < firstScanLine;
-                hiddenLineManager->currentScanLine++
-            );
-            
-            this->Collection<Line>::acceptComplementing( hiddenLineManager );
-        }
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        void  draw(void) const {
-            
-            if ( Option("Graph").get("isHiddenLine") ) { this->color = RGBA(0,0,0,0.2); }
-            else                                       { this->color = RGBA(0,0,0,0.7); }
-            
-            this->color.set();
-            
-            glBegin( GL_LINES ); {
-                
-                this->Collection<Line>::draw();
-                
-            } glEnd();
-        }
-        
-        mutable RGBA  color;
-    };
-    
-    
-    /**
-     * @brief |C̏W\NXB
-     *///---------------------------------------------------------------------------
-    class PolyLineList : public Collection<PolyLine> {
-        
-      public:
-        
-        /**
-         * @brief [begin,end)͈̔͂̒_̏W|C̃Xg𐶐B
-         *///---------------------------------------------------------------------------
-        template<class IteratorType>
-        void  set( IteratorType begin,  IteratorType end ) {
-            
-            this->children.clear();
-            
-            for ( IteratorType it = begin;  it != end;  it++ ) {
-                
-                this->children.push_back( PolyLine( it.begin(), it.end() ) );
-            }
-        }
-    };
-    
-    
-    /**
-     * @brief ڐ\NXB
-     *///---------------------------------------------------------------------------
-    class Tics : public Composite<Tics>, public Subject {
-        
-      public:
-        
-        /**
-         * @brief ڐline_Aevfparent_AIvVoption_̖ڐ𐶐B
-         *///---------------------------------------------------------------------------
-        Tics( const Option & option_, const Vector & line_, const Subject * parent_) :
-            
-            option( option_), line( line_), parent( parent_)
-        {}
-        
-        /**
-         * @brief ʒuXg擾B
-         *///---------------------------------------------------------------------------
-        const VertexList & getPositions(void) const {
-            
-            return this->positions;
-        }
-        
-        /**
-         * @brief ڐ̕擾B
-         *///---------------------------------------------------------------------------
-        const Vector & getDirection(void) const {
-            
-            return this->parent->getDirection();
-        }
-        
-        /**
-         * @brief Ԑ擾B
-         *///---------------------------------------------------------------------------
-        std::size_t  getIntervalNumber(void) const {
-            
-            return  this->option.get("divisionNumber") * this->parent->getIntervalNumber();
-        }
-        
-        /**
-         * @brief iݒ\ȏꏊǂ擾B 
-         *///---------------------------------------------------------------------------
-        bool  isSettablePosition(int i) const {
-            
-            return  i % this->child->option.get("divisionNumber");
-        }
-        
-      private:
-        
-        /**
-         * @brief ڐsaffineōWϊA`悷B 
-         *///---------------------------------------------------------------------------
-        void  drawMyself( const Matrix & affine ) const {
-            
-            if ( this->option.get("isDraw") ) {
-                
-                this->setPosition();
-                
-                drawParallelLines( affine, this->positions, this->line );
-            }
-        }
-        
-        /**
-         * @brief ڐ̈ʒu̐ݒB
-         *///---------------------------------------------------------------------------
-        void  setPosition(void) const {
-            
-            Vector  distance( this->parent->getDirection() / this->getIntervalNumber() );
-            
-            this->positions.clear();
-            
-            for ( Index i=0;  i <= this->getIntervalNumber();  i++ ) {
-                
-                if ( this->parent->isSettablePosition(i) ) {
-                    
-                    this->positions.push_back( i * distance );
-                }
-            }
-        }
-        
-        const   Option      option;
-        const   Subject *   parent;
-        const   Vector      line;
-        mutable VertexList  positions;
-    };
-    
-    
-    /**
-     * @brief W\NXB
-     *///---------------------------------------------------------------------------
-    class Axis : public Composite<Tics>, public Subject {
-        
-      public:
-        
-        /**
-         * @brief direction_̍W𐶐B
-         *///---------------------------------------------------------------------------
-        Axis( const Option & option_, const Vector & direction_) :
-            
-            option( option_), direction( direction_)
-        {}
-        
-        /**
-         * @brief W̕擾B
-         *///---------------------------------------------------------------------------
-        const Vector & getDirection(void) const {
-            
-            return this->direction;
-        }
-        
-        /**
-         * @brief Ԑ擾B
-         *///---------------------------------------------------------------------------
-        std::size_t  getIntervalNumber(void) const {
-            
-            return 1;
-        }
-        
-        /**
-         * @brief iݒ\ȏꏊǂ擾B 
-         *///---------------------------------------------------------------------------
-        bool  isSettablePosition(int i) const {
-            
-            return true;
-        }
-        
-      private:
-        
-        /**
-         * @brief WsaffineōWϊA`悷B
-         *///---------------------------------------------------------------------------
-        void  drawMyself( const Matrix & affine ) const {
-            
-            if ( this->option.get("isDraw") ) {
-                
-                glBegin( GL_LINES ); {
-                    
-                    drawLine( affine, V::ZERO, this->direction );
-                    
-                } glEnd();
-            }
-        }
-        
-        const Option  option;
-        const Vector  direction;
-    };
-    
-    
-    /**
-     * @brief Obh\NXB
-     *///---------------------------------------------------------------------------
-    class Grid : public Composite<Grid> {
-        
-      public:
-        
-        /**
-         * @brief IvVoption_Ŗڐtics1_Ɩڐtics2_ɂẴObh𐶐B
-         *///---------------------------------------------------------------------------
-        Grid( const Option & option_, const Subject * tics1_, const Subject * tics2_) :
-            
-            option( option_), tics1( tics1_), tics2( tics2_)
-        {}
-        
-      private:
-        
-        /**
-         * @brief iqsaffineōWϊA`悷B
-         *///---------------------------------------------------------------------------
-        void  drawMyself( const Matrix & affine ) const {
-            
-            if ( this->option.get("isDraw") ) {
-                
-                glEnable( GL_LINE_STIPPLE );  {
-                    
-                    glLineStipple( 1, 0x8888 );
-                    
-                    drawParallelLines( affine, this->tics1->getPositions(), this->tics2->getDirection() );
-                    drawParallelLines( affine, this->tics2->getPositions(), this->tics1->getDirection() );
-                    
-                } glDisable( GL_LINE_STIPPLE );
-            }
-        }
-        
-        const Option    option;
-        const Subject * tics1;
-        const Subject * tics2;
-    };
-    
-    
-    /**
-     * @brief ROt\NXB
-     *///---------------------------------------------------------------------------
-    class Graph {
-        
-      public:
-        
-        typedef std::vector<std::string>       Data;
-        typedef std::istringstream             DataStream;
-        typedef std::istream_iterator<Element> DataStreamIterator;
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        Graph( const Option & option_) : option( option_) {}
-        
-        /**
-         * @brief ŏlEől擾B
-         *///---------------------------------------------------------------------------
-        const MinMaxManager & getMinMaxManager(void) const {
-            
-            return  this->minmaxManager;
-        }
-        
-        /**
-         * @brief fileNamewt@CA_ݒ肷B
-         *///---------------------------------------------------------------------------
-        void  set( const char * path ) {
-            
-            Data  data;
-            
-            Graph::scanData(path,data);
-            
-            this->setSize  (data);
-            this->setVertex(data);
-            this->setPolyLine();
-        }
-        
-        /**
-         * @brief `悷B
-         *///---------------------------------------------------------------------------
-        void  draw( const AffineManager * affineManager,  int target ) const {
-            
-            this->operateVertex();
-            this->minmaxManager.set( transformed );
-            
-            this->draw( affineManager->get(target) );
-        }
-        
-      private:
-        
-        /**
-         * @brief f[^̓ǂݍ݁B
-         *///---------------------------------------------------------------------------
-        static void  scanData( const char * path,  Data & data ) {
-            
-            std::ifstream  ifs(path);
-            std::string    buffer;
-            
-            while ( std::getline( ifs, buffer ) ) {
-                
-                data.push_back( buffer );
-            }
-        }
-        
-        /**
-         * @brief _̐ݒB
-         *///---------------------------------------------------------------------------
-        void  setSize( const Data & data ) {
-            
-            std::size_t  xNumber = 0;
-            std::size_t  yNumber = data.size();
-            
-            DataStream          ds(data[0]);
-            DataStreamIterator  current(ds);
-            DataStreamIterator  end;
-            
-            while ( current++ != end ) { ++xNumber; }
-            
-            this->   original.resize( yNumber, xNumber );
-            this->transformed.resize( yNumber, xNumber );
-        }
-        
-        /**
-         * @brief _̐ݒB
-         *///---------------------------------------------------------------------------
-        void  setVertex( const Data & data ) {
-            
-            for ( Index j=0;  j < this->original.size1();  j++ ) {
-                
-                DataStream          ds(data[j]);
-                DataStreamIterator  k(ds);
-                
-                for ( Index i=0;  i < this->original.size2();  i++ ) {
-                    
-                    this->original(j,i) = v( i,j, *(k++) );
-                }
-            }
-        }
-        
-        /**
-         * @brief |C̐ݒB
-         *///---------------------------------------------------------------------------
-        void  setPolyLine(void) {
-            
-            this->xPolyLines.set( this->transformed. begin1(), this->transformed. end1() );
-            this->yPolyLines.set( this->transformed.rbegin2(), this->transformed.rend2() );
-        }
-        
-        /**
-         * @brief _̑B 
-         *///---------------------------------------------------------------------------
-        void  operateVertex(void) const {
-            
-            this->transformed = this->original;
-            
-            if ( this->option.get("isRegularizeX") ) { regularize( this->transformed.begin1(), this->transformed.end1() ); }
-            if ( this->option.get("isRegularizeY") ) { regularize( this->transformed.begin2(), this->transformed.end2() ); }
-            if ( this->option.get("isLogScale"   ) ) { toLogScale( this->transformed,          V::Z                     ); }
-        }
-        
-        /**
-         * @brief OtsaffineōWϊA`悷B
-         *///---------------------------------------------------------------------------
-        void  draw( const Matrix & affine ) const {
-            
-            dualForEach( this->transformed.begin1(),
-                         this->transformed.end1  (),  bind( transform, affine, _1 ) );
-            
-            if ( this->option.get("isDrawXPolyLines") ) { HiddenLineManager( &this->xPolyLines ); }
-            if ( this->option.get("isDrawYPolyLines") ) { HiddenLineManager( &this->yPolyLines ); }
-        }
-        
-        const   Option         option;
-                VertexMatrix   original;
-        mutable VertexMatrix   transformed;
-        mutable PolyLineList   xPolyLines;
-        mutable PolyLineList   yPolyLines;
-        mutable MinMaxManager  minmaxManager;
-    };
-    
-    
-    /**
-     * @brief Otvf𓝊NXB 
-     *///---------------------------------------------------------------------------
-    class Ploter {
-        
-      public:
-        
-        /**
-         * @brief B
-         *///---------------------------------------------------------------------------
-        Ploter(void) : affineManager( Option("affine"), &this->graph.getMinMaxManager() ),
-                               graph( Option("graph" )                                  ) {
-            
-            this->xAxis = makeAxis( "x",        V::X_UNIT, -V::Z_UNIT );
-            this->yAxis = makeAxis( "y",        V::Y_UNIT, -V::Z_UNIT );
-            this->zAxis = makeAxis( "z",  0.5 * V::Z_UNIT, -V::X_UNIT );
-            
-            this->xyGrid = makeGrid( "xy", this->xAxis, this->yAxis );
-            this->xzGrid = makeGrid( "xz", this->xAxis, this->zAxis );
-            this->yzGrid = makeGrid( "yz", this->yAxis, this->zAxis );
-        }
-        
-        /**
-         * @brief ݒ肷B
-         *///---------------------------------------------------------------------------
-        void  set( const char * fileName ) {
-            
-            graph.set( fileName );
-        }
-        
-        /**
-         * @brief `悷B
-         *///---------------------------------------------------------------------------
-        void  draw(void) const  {
-            
-            glClearColor( 1.0, 1.0, 1.0, 1.0  );
-            glClear     ( GL_COLOR_BUFFER_BIT );
-            
-            glLoadIdentity();
-            glOrtho( -0.4, 2.0,  -0.4, 2.0,  -10.0, 10.0 );
-            
-            glEnable( GL_BLEND ); {
-                
-                glBlendFunc( GL_SRC_ALPHA,  GL_ONE_MINUS_SRC_ALPHA );
-                
-                this->drawAxis ();
-                this->drawGrid ();
-                this->drawGraph();
-                
-            } glDisable( GL_BLEND );
-        }
-        
-        /**
-         * @brief EBhETCYω̃r[|[g̍ĐݒB
-         *///---------------------------------------------------------------------------
-        void  resize( int width,  int height ) const {
-            
-            int  max   = std::max(width,height);
-            int  min   = std::min(width,height);
-            int  space = (max - min) / 2;
-            
-            if ( min == height ) { glViewport( space, 0, min, min ); }
-            else                 { glViewport( 0, space, min, min ); }
-            
-            this->draw();
-        }
-        
-      private:
-        
-        /**
-         * @brief ̌axisDirectionAڐ̌ticsDirectionAʖname
-         *        W𐶐B
-         *///---------------------------------------------------------------------------
-        static shared_ptr<Axis>  makeAxis( const std::string & name,  const Vector & axisDirection,
-                                                                      const Vector & ticsDirection ) {
-            
-            Option   axisOption( name +  "Axis" );
-            Option   ticsOption( name +  "Tics" );
-            Option  mticsOption( name + "MTics" );
-            
-            Axis *  axis = new Axis(  axisOption,         axisDirection        );
-            Tics *  tics = new Tics(  ticsOption,  0.04 * ticsDirection,  axis );
-            Tics * mtics = new Tics( mticsOption,  0.02 * ticsDirection,  tics );
-            
-            axis->setChild( tics);
-            tics->setChild(mtics);
-            
-            return shared_ptr<Axis>(axis);
-        }
-        
-        /**
-         * @brief axis1Ǝaxis2𒣂鎯ʖnamẽObhʂ𐶐B
-         *///---------------------------------------------------------------------------
-        static shared_ptr<Grid>  makeGrid( const std::string & name,  const shared_ptr<Axis> axis1,
-                                                                      const shared_ptr<Axis> axis2 ) {
-            
-            Option   gridOption( name +  "Grid" );
-            Option  mgridOption( name + "MGrid" );
-            
-            Grid * grid = new Grid(  gridOption,  axis1->getChild(),
-                                                   axis2->getChild() );
-            Grid * mgrid = new Grid( mgridOption,  axis1->getChild()->getChild(),
-                                                   axis2->getChild()->getChild() );
-            
-            grid->setChild(mgrid);
-            
-            return shared_ptr<Grid>(grid);
-        }
-        
-        /**
-         * @brief W̕`B
-         *///---------------------------------------------------------------------------
-        void  drawAxis(void) const {
-            
-            glColor4d( 0.0,  0.0,  0.0,  1.0 );
-            
-            xAxis->draw( affineManager.get( AffineManager::FOR_X_AXIS ) );
-            yAxis->draw( affineManager.get( AffineManager::FOR_Y_AXIS ) );
-            zAxis->draw( affineManager.get( AffineManager::FOR_Z_AXIS ) );
-        }
-        
-        /**
-         * @brief Obh̕`B
-         *///---------------------------------------------------------------------------
-        void  drawGrid(void) const {
-            
-            glColor4d( 0.0,  0.0,  0.0,  0.7 );
-            
-            this->xyGrid->draw( this->affineManager.get( AffineManager::FOR_XY_GRID ) );
-            this->xzGrid->draw( this->affineManager.get( AffineManager::FOR_XZ_GRID ) );
-            this->yzGrid->draw( this->affineManager.get( AffineManager::FOR_YZ_GRID ) );
-        }
-        
-        /**
-         * @brief Ot̕`B
-         *///---------------------------------------------------------------------------
-        void  drawGraph(void) const {
-            
-            glEnable( GL_LINE_SMOOTH );  {
-                
-                glHint( GL_LINE_SMOOTH_HINT, GL_NICEST );
-                
-                graph.draw( &this->affineManager, AffineManager::FOR_GRAPH );
-                
-            }  glDisable( GL_LINE_SMOOTH );
-        }
-        
-        shared_ptr<Axis>  xAxis;
-        shared_ptr<Axis>  yAxis;
-        shared_ptr<Axis>  zAxis;
-        shared_ptr<Grid>  xyGrid;
-        shared_ptr<Grid>  xzGrid;
-        shared_ptr<Grid>  yzGrid;
-        Graph             graph;
-        AffineManager     affineManager;
-    };
-}
-#endif
+/**
+ * @file   Ploter.h
+ * @author 村田 裕一
+ * @brief  グラフの要素とそれらを統括するクラス郡を定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_PLOTER_H
+#define  INCLUDED_PLOTER_H
+
+#include  <iostream>
+#include  <fstream>
+#include  <sstream>
+#include  <map>
+#include  <limits>
+#include  <boost/shared_ptr.hpp>
+#include  <boost/utility.hpp>
+#include  <boost/next_prior.hpp>
+#include  "Utility.h"
+#include  "Loader.h"
+#include  "Kernel.h"
+#include  "Pipeline.h"
+#include  "Pyramid.h"
+#include  "DepthBuffer.h"
+#include  "RenderSink.h"
+
+namespace Ploter {
+    
+    class HiddenLineManager;
+    class PolyLineList;
+    
+    /**
+     * @brief 観察対象を表すクラス。
+     *///---------------------------------------------------------------------------
+    class Subject {
+        
+      public:
+        
+        virtual       std::size_t  getIntervalNumber (void) const { return 0;                        }
+        virtual const VertexList & getPositions      (void) const { return Subject::dummyVertexList; }
+        virtual const Vector     & getDirection      (void) const { return Subject::dummyVector;     }
+        virtual       bool         isSettablePosition(int ) const { return false;                    }
+        
+      private:
+        
+        static VertexList  dummyVertexList;
+        static Vector      dummyVector;
+    };
+    
+    VertexList  Subject::dummyVertexList;
+    Vector      Subject::dummyVector;
+    
+    
+    /**
+     * @brief 捜査対象を表すクラス。
+     *///---------------------------------------------------------------------------
+    class Scannee {
+        
+      public:
+        
+        virtual void  acceptScanning     ( HiddenLineManager * ) = 0;
+        virtual void  acceptComplementing( HiddenLineManager * ) = 0;
+    };
+    
+    
+    /**
+     * @brief 画面に表示する範囲の下限と上限。x・yで共通。
+     *///---------------------------------------------------------------------------
+    const Element  VIEW_MINIMUM = -0.4;
+    const Element  VIEW_MAXIMUM =  2.0;
+    
+    
+    /**
+     * @brief 走査線の位置の集合。末尾に番兵として+∞を置く。x方向とy方向の陰線処理で共有する。
+     *        頂点ごとに置く場合は、全ての頂点の画面上のxを昇順に重複なく並べる。
+     *        一定の間隔で置く場合は、画面を幅widthの列に区切り、頂点のある範囲の各列の中央に置く。
+     *///---------------------------------------------------------------------------
+    class ScanLineSet {
+        
+      public:
+        
+        explicit ScanLineSet( FrameArena * arena = 0 ) : positions( ArenaAllocator<Element>(arena) ), origin(0), width(0) {}
+        
+        /**
+         * @brief 点の集合pointsについて、幅width_の列ごとに走査線を設定する。
+         *        width_が0の場合は頂点ごとに設定する。
+         *///---------------------------------------------------------------------------
+        void  set( const PointArray & points,  Element width_) {
+            
+            if ( width_ <= 0 ) { this->set(points);  return; }
+            
+            Element  minimum =  std::numeric_limits<Element>::infinity();
+            Element  maximum = -std::numeric_limits<Element>::infinity();
+            
+            for ( std::size_t k=0;  k < points.size();  k++ ) {
+                
+                if ( points[k](X) - points[k](X) == 0 ) {   // NaNと∞は除く。
+                    
+                    minimum = std::min( minimum, points[k](X) );
+                    maximum = std::max( maximum, points[k](X) );
+                }
+            }
+            
+            this->positions.clear();
+            this->width = width_;
+            
+            if ( minimum <= maximum ) {
+                
+                Element  first = std::floor( ( minimum - VIEW_MINIMUM ) / this->width );
+                Element  last  = std::floor( ( maximum - VIEW_MINIMUM ) / this->width );
+                
+                this->origin = VIEW_MINIMUM + first * this->width;
+                
+                for ( Element k=0;  k <= last - first;  k++ ) {
+                    
+                    this->positions.push_back( this->origin + ( k + 0.5 ) * this->width );
+                }
+            }
+            
+            this->positions.push_back( std::numeric_limits<Element>::infinity() );
+        }
+        
+        /**
+         * @brief 点の集合pointsのxから、頂点ごとに走査線を設定する。
+         *///---------------------------------------------------------------------------
+        void  set( const PointArray & points ) {
+            
+            this->width = 0;
+            
+            this->positions.resize( points.size() );
+            
+            std::size_t  number = 0;
+            
+            for ( std::size_t k=0;  k < points.size();  k++ ) {
+                
+                if ( points[k](X) == points[k](X) ) { this->positions[number++] = points[k](X); }   // NaNは除く。
+            }
+            
+            std::sort( this->positions.begin(), this->positions.begin() + number );
+            
+            this->positions.erase( std::unique( this->positions.begin(), this->positions.begin() + number ), this->positions.end() );
+            this->positions.push_back( std::numeric_limits<Element>::infinity() );
+        }
+        
+        /**
+         * @brief 番兵を除いた走査線の数。
+         *///---------------------------------------------------------------------------
+        std::size_t  getSize(void) const { return this->positions.empty() ? 0 : this->positions.size() - 1; }
+        
+        /**
+         * @brief k番目の走査線の位置。
+         *///---------------------------------------------------------------------------
+        Element  operator []( std::size_t k ) const { return this->positions[k]; }
+        
+        /**
+         * @brief 位置がx以上である最初の走査線の番号を二分探索で求める。
+         *///---------------------------------------------------------------------------
+        std::size_t  find( Element x ) const {
+            
+            return  std::lower_bound( this->positions.begin(), this->positions.end(), x ) - this->positions.begin();
+        }
+        
+        /**
+         * @brief 一定の間隔で置いているかどうか。
+         *///---------------------------------------------------------------------------
+        bool  isColumnar(void) const { return this->width > 0; }
+        
+        /**
+         * @brief xを含む列の番号。一定の間隔で置いている場合に使う。範囲外のxは端の列に含める。
+         *///---------------------------------------------------------------------------
+        std::size_t  findColumn( Element x ) const {
+            
+            Element  k = std::floor( ( x - this->origin ) / this->width );
+            
+            if ( !( k > 0 ) ) { return 0; }
+            
+            return  std::min( static_cast<std::size_t>(k), this->getSize() - 1 );
+        }
+        
+      private:
+        
+        std::vector< Element, ArenaAllocator<Element> >  positions;
+        Element                                          origin;
+        Element                                          width;
+    };
+    
+    
+    /**
+     * @brief これまでの線分の最大値を表す区分線形関数(上側の水平線)。
+     *        折れ点をxの順にmapで持ち、各折れ点には左からの極限と右からの極限を置く。
+     *        隣り合う折れ点の間は線形に補間し、どちらかの極限が-∞なら線が無い区間とする。
+     *///---------------------------------------------------------------------------
+    class Envelope {
+        
+      public:
+        
+        /**
+         * @brief 折れ点と作業用の列をarenaから確保する水平線を生成する。
+         *///---------------------------------------------------------------------------
+        explicit Envelope( FrameArena * arena = 0 ) :
+            
+            nodes( std::less<Element>(), NodeMap::allocator_type(arena) ), criticals( CriticalList::allocator_type(arena) ), merged( NodeList::allocator_type(arena) )
+        {}
+        
+        /**
+         * @brief 全ての折れ点を削除する。
+         *///---------------------------------------------------------------------------
+        void  clear(void) { this->nodes.clear(); }
+        
+        /**
+         * @brief xでの値。折れ点では左右の極限の大きい方。
+         *///---------------------------------------------------------------------------
+        Element  getValue( Element x ) const {
+            
+            NodeMap::const_iterator  it = this->nodes.lower_bound(x);
+            
+            if ( it != this->nodes.end() && it->first == x ) { return std::max( it->second.left, it->second.right ); }
+            
+            return  this->interpolate( it, x );
+        }
+        
+        /**
+         * @brief x1 < x2である線分(x1,y1)-(x2,y2)のうち、関数より上にある区間をvisibleに設定し、
+         *        関数を線分との最大値に更新する。区間の端は交点で正確に切る。
+         *        手間は、線分の範囲にある折れ点の数をkとしてO(log n + k)。
+         *///---------------------------------------------------------------------------
+        void  merge( Element x1,  Element y1,  Element x2,  Element y2,  RangeList & visible ) {
+            
+            NodeMap::iterator  first = this->nodes.lower_bound(x1);
+            NodeMap::iterator  last  = this->nodes.upper_bound(x2);
+            NodeMap::iterator  it    = first;
+            
+            visible.clear();
+            
+            // 線分の範囲にある折れ点と、両端での関数の極限を並べる。
+            
+            this->criticals.clear();
+            
+            if ( it != last && it->first == x1 ) { this->criticals.push_back( Critical( x1, it->second ) );  it++; }
+            else                                 { this->criticals.push_back( Critical( x1, this->interpolate( first, x1 ) ) ); }
+            
+            for ( ;  it != last && it->first < x2;  it++ ) { this->criticals.push_back( Critical( it->first, it->second ) ); }
+            
+            if ( it != last ) { this->criticals.push_back( Critical( x2, it->second ) ); }
+            else              { this->criticals.push_back( Critical( x2, this->interpolate( last, x2 ) ) ); }
+            
+            // 折れ点の間ごとに線分と関数を比べ、新しい折れ点を求める。
+            // 両側で線分が上にある折れ点は線分上にあるので省く。
+            
+            Element  delta   = ( y2 - y1 ) / ( x2 - x1 );
+            bool     wasOver = false;
+            
+            this->merged.clear();
+            this->merged.push_back( std::make_pair( x1, Node( this->criticals.front().left, std::max( y1, this->criticals.front().right ) ) ) );
+            
+            for ( std::size_t k=1;  k < this->criticals.size();  k++ ) {
+                
+                const Critical &  a = this->criticals[k-1];
+                const Critical &  b = this->criticals[k  ];
+                
+                bool     isLast = ( k + 1 == this->criticals.size() );
+                Element  sa     = ( k == 1 ) ? y1 : y1 + delta * ( a.x - x1 );
+                Element  sb     = isLast     ? y2 : y1 + delta * ( b.x - x1 );
+                Element  da     = sa - a.right;
+                Element  db     = sb - b.left;
+                bool     isOver = ( a.right == -std::numeric_limits<Element>::infinity() || b.left == -std::numeric_limits<Element>::infinity() ) ||
+                                  ( da > 0 && db > 0 );
+                
+                if ( isOver ) {
+                    
+                    if ( wasOver ) { this->merged.pop_back(); }
+                    
+                    addRange( visible, a.x, b.x );
+                    
+                } else if ( da > 0 || db > 0 ) {   // 間で交わる。
+                    
+                    Element  xc = a.x + ( b.x - a.x ) * da / ( da - db );
+                    
+                    if ( da > 0 ) { addRange( visible, a.x, xc  ); }
+                    else          { addRange( visible, xc,  b.x ); }
+                    
+                    if ( a.x < xc && xc < b.x ) {
+                        
+                        Element  yc = y1 + delta * ( xc - x1 );
+                        
+                        this->merged.push_back( std::make_pair( xc, Node( yc, yc ) ) );
+                    }
+                }
+                
+                if ( isLast ) { this->merged.push_back( std::make_pair( b.x, Node( std::max( sb, b.left ), b.right                  ) ) ); }
+                else          { this->merged.push_back( std::make_pair( b.x, Node( std::max( sb, b.left ), std::max( sb, b.right ) ) ) ); }
+                
+                wasOver = isOver;
+            }
+            
+            if ( visible.empty() ) { return; }   // 全て隠れる場合は関数は変わらない。
+            
+            this->nodes.erase( first, last );
+            
+            for ( std::size_t k=0;  k < this->merged.size();  k++ ) { this->nodes.insert( last, this->merged[k] ); }
+        }
+        
+      private:
+        
+        /**
+         * @brief 折れ点での左右の極限。
+         *///---------------------------------------------------------------------------
+        struct Node {
+            
+            Node( Element left_,  Element right_) : left( left_), right( right_) {}
+            
+            Element  left;
+            Element  right;
+        };
+        
+        /**
+         * @brief 線分の範囲にある点とそこでの極限。
+         *///---------------------------------------------------------------------------
+        struct Critical {
+            
+            Critical( Element x_,  const Node & node ) : x( x_), left( node.left ), right( node.right ) {}
+            Critical( Element x_,  Element value     ) : x( x_), left( value     ), right( value      ) {}
+            
+            Element  x;
+            Element  left;
+            Element  right;
+        };
+        
+        typedef std::map< Element, Node, std::less<Element>, ArenaAllocator< std::pair<const Element,Node> > >  NodeMap;
+        typedef std::vector< Critical, ArenaAllocator<Critical> >                                                CriticalList;
+        typedef std::vector< std::pair<Element,Node>, ArenaAllocator< std::pair<Element,Node> > >                NodeList;
+        
+        /**
+         * @brief 折れ点でないxでの値。afterはxより右にある最初の折れ点。
+         *///---------------------------------------------------------------------------
+        Element  interpolate( NodeMap::const_iterator after,  Element x ) const {
+            
+            if ( after == this->nodes.begin() || after == this->nodes.end() ) { return -std::numeric_limits<Element>::infinity(); }
+            
+            NodeMap::const_iterator  before = prior(after);
+            
+            if ( before->second.right == -std::numeric_limits<Element>::infinity() ||
+                 after ->second.left  == -std::numeric_limits<Element>::infinity() ) { return -std::numeric_limits<Element>::infinity(); }
+            
+            return  before->second.right + ( after->second.left - before->second.right ) * ( x - before->first ) / ( after->first - before->first );
+        }
+        
+        /**
+         * @brief 区間[begin,end]をrangesの末尾に加える。末尾の区間と接する場合はつなげる。
+         *///---------------------------------------------------------------------------
+        static void  addRange( RangeList & ranges,  Element begin,  Element end ) {
+            
+            if ( ! ranges.empty() && ranges.back().second >= begin ) { ranges.back().second = std::max( ranges.back().second, end ); }
+            else                                                     { ranges.push_back( Range( begin, end ) );                     }
+        }
+        
+        NodeMap       nodes;
+        CriticalList  criticals;
+        NodeList      merged;
+    };
+    
+    
+    /**
+     * @brief 陰線処理で残す点を、全ての線分について1つの配列に線分の順に詰めて持つクラス。
+     *        k番目の線分の点はpoints[ offsets[k], offsets[k+1] )になる。
+     *        closeAsで閉じた場合は、点のある線分だけを持ち、k番目に閉じた線分の番号をedges[k]に持つ。
+     *///---------------------------------------------------------------------------
+    class PointBuffer {
+        
+      public:
+        
+        typedef std::vector< Point2, ArenaAllocator<Point2> >  PointList;
+        typedef PointList::const_iterator                      const_iterator;
+        
+        /**
+         * @brief 点と区切りをarenaから確保するバッファを生成する。arenaが0の場合は通常の領域から確保する。
+         *///---------------------------------------------------------------------------
+        explicit PointBuffer( FrameArena * arena = 0 ) :
+            
+            points( PointList::allocator_type(arena) ), offsets( 1, 0, OffsetList::allocator_type(arena) ), edges( OffsetList::allocator_type(arena) )
+        {}
+        
+        /**
+         * @brief 全ての点と線分の区切りを削除する。
+         *///---------------------------------------------------------------------------
+        void  clear(void) {
+            
+            this->points.clear();
+            this->offsets.assign( 1, 0 );
+            this->edges.clear();
+        }
+        
+        /**
+         * @brief 現在の線分にpointを加える。
+         *///---------------------------------------------------------------------------
+        void  push_back( const Point2 & point ) {
+            
+            this->points.push_back(point);
+        }
+        
+        /**
+         * @brief 現在の線分を閉じ、次の線分に移る。
+         *///---------------------------------------------------------------------------
+        void  close(void) {
+            
+            this->offsets.push_back( this->points.size() );
+        }
+        
+        /**
+         * @brief 現在の線分に点があれば、edge番目の線分として閉じる。点が無ければ何もしない。
+         *///---------------------------------------------------------------------------
+        void  closeAs( std::size_t edge ) {
+            
+            if ( this->points.size() == this->offsets.back() ) { return; }
+            
+            this->offsets.push_back( this->points.size() );
+            this->edges  .push_back( edge );
+        }
+        
+        /**
+         * @brief pointNumber個の点を加えても確保し直さないようにする。
+         *///---------------------------------------------------------------------------
+        void  reserve( std::size_t pointNumber ) {
+            
+            this->points.reserve( pointNumber );
+        }
+        
+        /**
+         * @brief 閉じた線分の数。
+         *///---------------------------------------------------------------------------
+        std::size_t  getEdgeNumber(void) const {
+            
+            return  this->offsets.size() - 1;
+        }
+        
+        /**
+         * @brief 点の数。
+         *///---------------------------------------------------------------------------
+        std::size_t  getPointNumber(void) const {
+            
+            return  this->points.size();
+        }
+        
+        /**
+         * @brief k番目の線分の最初の点と、最後の点の次。
+         *///---------------------------------------------------------------------------
+        const_iterator  begin( std::size_t k ) const { return this->points.begin() + this->offsets[k  ]; }
+        const_iterator  end  ( std::size_t k ) const { return this->points.begin() + this->offsets[k+1]; }
+        
+        /**
+         * @brief closeAsで閉じたpartsの点を、edgeNumber個の線分ごとにpartsの順につないで設定する。
+         *        線分ごとの点の数を数えて各線分の先頭を決めてから複写するので、手間は線分と点の数に比例し、partsの数には比例しない。
+         *        点の配列は空にせずに大きさだけを変え、前回より増えた分だけを初期化する。
+         *///---------------------------------------------------------------------------
+        void  gather( std::size_t edgeNumber,  const std::vector<const PointBuffer *> & parts ) {
+            
+            this->offsets.assign( edgeNumber + 1, 0 );
+            this->edges  .clear();
+            
+            for ( std::size_t s=0;  s < parts.size();  s++ ) {
+                
+                for ( std::size_t e=0;  e < parts[s]->edges.size();  e++ ) {
+                    
+                    this->offsets[ parts[s]->edges[e] + 1 ] += parts[s]->end(e) - parts[s]->begin(e);
+                }
+            }
+            
+            for ( std::size_t k=0;  k < edgeNumber;  k++ ) { this->offsets[k+1] += this->offsets[k]; }
+            
+            this->points.resize( this->offsets[edgeNumber] );
+            
+            // offsets[k]を複写先として進めると、k番目の線分の終わり、つまりk+1番目の線分の先頭になる。
+            
+            for ( std::size_t s=0;  s < parts.size();  s++ ) {
+                
+                for ( std::size_t e=0;  e < parts[s]->edges.size();  e++ ) {
+                    
+                    std::size_t &  cursor = this->offsets[ parts[s]->edges[e] ];
+                    
+                    std::copy( parts[s]->begin(e), parts[s]->end(e), this->points.begin() + cursor );
+                    
+                    cursor += parts[s]->end(e) - parts[s]->begin(e);
+                }
+            }
+            
+            std::copy_backward( this->offsets.begin(), this->offsets.end() - 1, this->offsets.end() );
+            
+            this->offsets[0] = 0;
+        }
+        
+      private:
+        
+        typedef std::vector< std::size_t, ArenaAllocator<std::size_t> >  OffsetList;
+        
+        PointList   points;
+        OffsetList  offsets;
+        OffsetList  edges;
+    };
+    
+    
+    /**
+     * @brief 陰線処理を管理するクラス。
+     *        走査線で処理する場合は、各走査線でのこれまでの線の最小値・最大値(水平線)を、走査線と同じ番号の配列に持つ。
+     *        正確に処理する場合は、上側と下側の水平線を区分線形関数で持ち、線分を交点で切る。
+     *///---------------------------------------------------------------------------
+    class HiddenLineManager {
+        
+      public:
+        
+        /**
+         * @brief 陰線処理の方法。
+         *///---------------------------------------------------------------------------
+        enum {
+            
+            SCAN_LINE = 0,   // 走査線上の点で判定する。
+            EXACT     = 1,   // 区分線形の水平線と交点で判定する。
+            Z_BUFFER  = 2,   // 面を画素ごとの奥行きに描き込み、線分の点と比べる。
+        };
+        
+        /**
+         * @brief オプションから陰線処理の方法を取得する。
+         *///---------------------------------------------------------------------------
+        static int  getMethod(void) {
+            
+            return  Option::getGraph().hiddenLineMethod;
+        }
+        
+        /**
+         * @brief 走査線scanLines_または奥行きdepthBuffer_でtargetの陰線処理をする。
+         *        走査線で処理する場合は、走査線をhiddenLineThreads個の帯に分け、帯ごとに別のスレッドで処理する。
+         *        水平線などの一時的な領域はarena_から確保する。
+         *///---------------------------------------------------------------------------
+        HiddenLineManager( Scannee * target,  const ScanLineSet & scanLines_,  const DepthBuffer & depthBuffer_,  FrameArena & arena_) :
+            
+            currentScanLine(0), scanLines( scanLines_), depthBuffer( depthBuffer_), arena( arena_),
+            minimum( &arena_), maximum( &arena_), method( HiddenLineManager::getMethod() ),
+            upper( &arena_), lower( &arena_), upperRanges( &arena_), lowerRanges( &arena_), pieces( &arena_),
+            firstScanLine(0), lastScanLine( scanLines_.getSize() ), stripNumber(1), assessNumber(0)
+        {
+            if ( Option::getGraph().isHiddenLine ) {
+                
+                if ( this->method == SCAN_LINE ) {
+                    
+                    this->minimum.assign( this->scanLines.getSize(),  std::numeric_limits<Element>::infinity() );
+                    this->maximum.assign( this->scanLines.getSize(), -std::numeric_limits<Element>::infinity() );
+                    
+                    this->horizonMinimum = this->minimum.empty() ? 0 : &this->minimum[0];
+                    this->horizonMaximum = this->maximum.empty() ? 0 : &this->maximum[0];
+                    
+                    this->stripNumber = HiddenLineManager::getStripNumber( this->scanLines.getSize() );
+                }
+                
+                target->acceptScanning     (this);
+                target->acceptComplementing(this);
+            }
+        }
+        
+        /**
+         * @brief 走査線を帯に分けて処理するかどうか。
+         *///---------------------------------------------------------------------------
+        bool  isStriped(void) const {
+            
+            return  this->stripNumber > 1;
+        }
+        
+        void  complementStrips( PolyLineList & target,  PointBuffer & visible,  std::vector<std::size_t> & loads );
+        
+        /**
+         * @brief 現在の走査線を、位置がx以上である最初の走査線にする。帯の手前にある場合は帯の最初の走査線にする。
+         *///---------------------------------------------------------------------------
+        void  findPosition( Element x ) {
+            
+            this->currentScanLine = std::max( this->scanLines.find(x), this->firstScanLine );
+        }
+        
+        /**
+         * @brief 現在の走査線を、xを含む列の走査線にする。その列が帯にあるかどうかを返す。
+         *///---------------------------------------------------------------------------
+        bool  findColumn( Element x ) {
+            
+            this->currentScanLine = this->scanLines.findColumn(x);
+            
+            return  this->firstScanLine <= this->currentScanLine && this->currentScanLine < this->lastScanLine;
+        }
+        
+        /**
+         * @brief 現在の走査線が帯にあるかどうか。
+         *///---------------------------------------------------------------------------
+        bool  isInStrip(void) const {
+            
+            return  this->currentScanLine < this->lastScanLine;
+        }
+        
+        /**
+         * @brief 走査線を列ごとに置いているかどうか。
+         *///---------------------------------------------------------------------------
+        bool  isColumnar(void) const {
+            
+            return  this->scanLines.isColumnar();
+        }
+        
+        /**
+         * @brief 陰線処理の方法。
+         *///---------------------------------------------------------------------------
+        int  getCurrentMethod(void) const {
+            
+            return  this->method;
+        }
+        
+        /**
+         * @brief assessで査定した点の数。
+         *///---------------------------------------------------------------------------
+        std::size_t  getAssessNumber(void) const {
+            
+            return  this->assessNumber;
+        }
+        
+        /**
+         * @brief 頂点の番号がbegin・endである線分の見える部分を奥行きで求め、媒介変数の区間の列で返す。
+         *///---------------------------------------------------------------------------
+        const RangeList &  clipByDepth( Index begin,  Index end ) {
+            
+            this->depthBuffer.clip( begin, end, this->pieces );
+            
+            return  this->pieces;
+        }
+        
+        /**
+         * @brief 線分begin-endのうち水平線の外にある部分を、始点を0・終点を1とする媒介変数の区間の列で返し、
+         *        水平線を更新する。上側と下側の水平線の外にある区間を合わせる。
+         *        xが等しい線分は、端点のどちらかが外にあれば全体を返し、水平線は更新しない。
+         *///---------------------------------------------------------------------------
+        const RangeList &  clip( const Point2 & begin,  const Point2 & end ) {
+            
+            Element  x1 = begin(X),  y1 = begin(Y);
+            Element  x2 = end  (X),  y2 = end  (Y);
+            
+            this->pieces.clear();
+            
+            if ( !( x1 - x1 == 0 && y1 - y1 == 0 && x2 - x2 == 0 && y2 - y2 == 0 ) ) { return this->pieces; }   // NaNと∞は描かない。
+            
+            if ( x1 == x2 ) {
+                
+                if ( std::max(y1,y2) > this->upper.getValue(x1) || -std::min(y1,y2) > this->lower.getValue(x1) ) {
+                    
+                    this->pieces.push_back( Range(0,1) );
+                }
+                
+                return  this->pieces;
+            }
+            
+            bool  isReversed = ( x2 < x1 );
+            
+            if ( isReversed ) { std::swap(x1,x2);  std::swap(y1,y2); }
+            
+            this->upper.merge( x1,  y1, x2,  y2, this->upperRanges );
+            this->lower.merge( x1, -y1, x2, -y2, this->lowerRanges );
+            
+            // 2つの区間の列をxの順に合わせ、媒介変数に直す。
+            
+            RangeList::const_iterator  u = this->upperRanges.begin();
+            RangeList::const_iterator  l = this->lowerRanges.begin();
+            
+            while ( u != this->upperRanges.end() || l != this->lowerRanges.end() ) {
+                
+                Range  range = ( l == this->lowerRanges.end() || ( u != this->upperRanges.end() && u->first < l->first ) ) ? *u++ : *l++;
+                
+                if ( ! this->pieces.empty() && this->pieces.back().second >= range.first ) {
+                    
+                    this->pieces.back().second = std::max( this->pieces.back().second, range.second );
+                    
+                } else {
+                    
+                    this->pieces.push_back(range);
+                }
+            }
+            
+            for ( std::size_t k=0;  k < this->pieces.size();  k++ ) {
+                
+                Element  t1 = ( this->pieces[k].first  - x1 ) / ( x2 - x1 );
+                Element  t2 = ( this->pieces[k].second - x1 ) / ( x2 - x1 );
+                
+                this->pieces[k] = isReversed ? Range( 1 - t2, 1 - t1 ) : Range( t1, t2 );
+            }
+            
+            return  this->pieces;
+        }
+        
+        /**
+         * @brief 現在の走査線の位置。
+         *///---------------------------------------------------------------------------
+        Element  getPosition(void) const {
+            
+            return  this->scanLines[ this->currentScanLine ];
+        }
+        
+        /**
+         * @brief 現在の走査線でvalueが水平線の外にあるかどうかを査定し、水平線を更新する。
+         *///---------------------------------------------------------------------------
+        bool  assess( Element value ) {
+            
+            bool  isOuter = false;
+            
+            this->assessNumber++;
+            
+            if ( this->horizonMinimum[ this->currentScanLine ] > value ) { this->horizonMinimum[ this->currentScanLine ] = value;  isOuter = true; }
+            if ( this->horizonMaximum[ this->currentScanLine ] < value ) { this->horizonMaximum[ this->currentScanLine ] = value;  isOuter = true; }
+            
+            return  isOuter;
+        }
+        
+        std::size_t  currentScanLine;
+        
+      private:
+        
+        class Strip;
+        class StripComplementer;
+        
+        friend class Strip;
+        
+        /**
+         * @brief ownerの走査線のうち、[first,last)番目だけを処理する帯を生成する。水平線はownerと共有する。
+         *        帯は別のスレッドで処理するので、一時的な領域はownerとは別のarena_から確保する。
+         *///---------------------------------------------------------------------------
+        HiddenLineManager( const HiddenLineManager & owner,  std::size_t first,  std::size_t last,  FrameArena & arena_) :
+            
+            currentScanLine(first), scanLines( owner.scanLines ), depthBuffer( owner.depthBuffer ), arena( arena_),
+            minimum( &arena_), maximum( &arena_), method(SCAN_LINE),
+            upper( &arena_), lower( &arena_), upperRanges( &arena_), lowerRanges( &arena_), pieces( &arena_),
+            firstScanLine(first), lastScanLine(last), horizonMinimum( owner.horizonMinimum ), horizonMaximum( owner.horizonMaximum ), stripNumber(1), assessNumber(0)
+        {}
+        
+        /**
+         * @brief オプションから帯の数を求める。hiddenLineThreadsが0の場合はプロセッサの数にする。
+         *///---------------------------------------------------------------------------
+        static std::size_t  getStripNumber( std::size_t scanLineNumber ) {
+            
+            int  threadNumber = Option::getGraph().hiddenLineThreads;
+            
+            std::size_t  number = ( threadNumber > 0 ) ? static_cast<std::size_t>(threadNumber) : getProcessorNumber();
+            
+            return  std::max<std::size_t>( 1, std::min( number, scanLineNumber ) );
+        }
+        
+        typedef std::vector< Element, ArenaAllocator<Element> >  Horizon;
+        
+        const ScanLineSet &   scanLines;
+        const DepthBuffer &   depthBuffer;
+        FrameArena &          arena;
+        Horizon               minimum;
+        Horizon               maximum;
+        int                   method;
+        Envelope              upper;
+        Envelope              lower;
+        RangeList             upperRanges;
+        RangeList             lowerRanges;
+        RangeList             pieces;
+        std::size_t           firstScanLine;
+        std::size_t           lastScanLine;
+        Element *             horizonMinimum;
+        Element *             horizonMaximum;
+        std::size_t           stripNumber;
+        std::size_t           assessNumber;
+    };
+    
+    
+    /**
+     * @brief 複合グラフ要素を表すクラス。
+     *///---------------------------------------------------------------------------
+    template<class ChildType>
+    class Composite {
+        
+      public:
+        
+        /**
+         * @brief childを子要素に設定する。
+         *///---------------------------------------------------------------------------
+        void  setChild( ChildType * child ) {
+            
+            this->child = shared_ptr<ChildType>(child);
+        }
+        
+        /**
+         * @brief 子要素を取得する。
+         *///---------------------------------------------------------------------------
+        const ChildType * getChild(void) const {
+            
+            return this->child.get();
+        }
+        
+        /**
+         * @brief 自身と子要素を行列affineで座標変換した後、styleで描く線分としてbatchに加える。
+         *///---------------------------------------------------------------------------
+        void  draw( LineBatch & batch,  const LineStyle & style,  const Matrix & affine ) const {
+            
+            this->drawMyself( batch, style, affine );
+            
+            if ( this->child != 0 ) { this->child->draw( batch, style, affine ); }
+        }
+        
+      private:
+        
+        virtual void  drawMyself( LineBatch & batch,  const LineStyle & style,  const Matrix & affine ) const = 0;
+        
+      protected:
+        
+        shared_ptr<ChildType>  child;
+    };
+    
+    
+    /**
+     * @brief ポリラインの集合を、線分の表として平坦な配列で持つクラス。
+     *        p番目のポリラインの線分はedges[ lineOffsets[p], lineOffsets[p+1] )で、線分は頂点の配列での始点と終点の番号の組。
+     *        線分の傾きと切片は線分と同じ番号の配列にまとめて求め、陰線処理で残す点は全ての線分で1つの配列に持つ。
+     *///---------------------------------------------------------------------------
+    class PolyLineList : public Scannee {
+        
+      public:
+        
+        PolyLineList(void) : vertices(0), lineOffsets( 1, 0 ), isPiecewise(false), isReduced(false) {}
+        
+        /**
+         * @brief vertices_のfirst番目から間隔lineStrideで始まるlineNumber本のポリラインのリストを設定する。
+         *        各ポリラインは間隔vertexStrideで並ぶvertexNumber個の頂点からなる。vertices_は次に設定するまで参照する。
+         *        線分の表はreduceで作る。前回と同じ並びの場合は、間引いていない線分の表をそのまま使う。
+         *///---------------------------------------------------------------------------
+        void  set( const PointArray & vertices_,  std::ptrdiff_t first,  std::size_t lineNumber,    std::ptrdiff_t lineStride,
+                                                                         std::size_t vertexNumber,  std::ptrdiff_t vertexStride ) {
+            
+            if ( this->vertices == &vertices_ &&
+                 this->layout.first        == first        && this->layout.lineNumber   == lineNumber   &&
+                 this->layout.lineStride   == lineStride   && this->layout.vertexNumber == vertexNumber &&
+                 this->layout.vertexStride == vertexStride ) { return; }
+            
+            this->vertices = &vertices_;
+            
+            this->layout.first        = first;
+            this->layout.lineNumber   = lineNumber;
+            this->layout.lineStride   = lineStride;
+            this->layout.vertexNumber = vertexNumber;
+            this->layout.vertexStride = vertexStride;
+            
+            this->edges      .clear();
+            this->lineOffsets.assign( 1, 0 );
+            this->visible    .clear();
+        }
+        
+        /**
+         * @brief 頂点を間引いた線分の表にする。ポリラインはlineStep本ごとの1本と最後の1本だけを描く。
+         *        描くポリラインの頂点はbucketSize個ごとの区間に分け、区間の先頭と画面の縦方向で最小・最大の頂点を残すので、
+         *        山や谷は失わない。さらにtoleranceが正なら、画面での誤差がtolerance以下になるように間引く(Douglas-Peucker法)。
+         *        頂点は間引くだけで動かさないので、残した線分の両端は元の頂点のまま。
+         *        どれも間引かない場合は、全ての頂点を使う線分の表を作るか、前回のものを使う。
+         *///---------------------------------------------------------------------------
+        void  reduce( std::size_t lineStep,  std::size_t bucketSize,  Element tolerance ) {
+            
+            if ( lineStep <= 1 && bucketSize <= 1 && !( tolerance > 0 ) ) {
+                
+                if ( this->isReduced || this->edges.empty() ) { this->setEdges(); }
+                
+                return;
+            }
+            
+            this->edges      .clear();
+            this->lineOffsets.assign( 1, 0 );
+            this->visible    .clear();
+            this->isReduced = true;
+            
+            const Layout &  l = this->layout;
+            
+            if ( l.vertexNumber < 2 ) { return; }
+            
+            lineStep   = std::max( lineStep,   std::size_t(1) );
+            bucketSize = std::max( bucketSize, std::size_t(1) );
+            
+            // 区間ごとに残す頂点は3個までなので、その数で線分の表を確保しておく。
+            std::size_t  edgeNumber = std::min( l.vertexNumber - 1, 3 * ( ( l.vertexNumber - 1 ) / bucketSize + 1 ) );
+            
+            this->edges.reserve( ( l.lineNumber / lineStep + 1 ) * edgeNumber );
+            
+            std::vector<std::size_t>  kept;
+            
+            for ( std::size_t p=0;  p < l.lineNumber;  p++ ) {
+                
+                if ( p % lineStep != 0 && p != l.lineNumber - 1 ) { continue; }
+                
+                std::ptrdiff_t  first = l.first + static_cast<std::ptrdiff_t>(p) * l.lineStride;
+                
+                this->bucket( first, bucketSize, kept );
+                
+                if ( tolerance > 0 ) { this->simplify( first, tolerance, kept ); }
+                
+                for ( std::size_t k=1;  k < kept.size();  k++ ) {
+                    
+                    this->edges.push_back( Edge( static_cast<Index>( this->getIndex( first, kept[k-1] ) ),
+                                                 static_cast<Index>( this->getIndex( first, kept[k  ] ) ) ) );
+                }
+                
+                this->lineOffsets.push_back( this->edges.size() );
+            }
+        }
+        
+        /**
+         * @brief 線分の両端の頂点をpointsに加える。間引いた場合に、残した頂点だけに走査線を置くために使う。
+         *///---------------------------------------------------------------------------
+        void  appendVertices( PointArray & points ) const {
+            
+            for ( std::size_t k=0;  k < this->edges.size();  k++ ) {
+                
+                points.push_back( this->getBegin(k) );
+                points.push_back( this->getEnd  (k) );
+            }
+        }
+        
+        /**
+         * @brief 線分の数。
+         *///---------------------------------------------------------------------------
+        std::size_t  getEdgeNumber(void) const {
+            
+            return  this->edges.size();
+        }
+        
+        /**
+         * @brief 最後に走査線で陰線処理をした場合の、帯ごとに査定した点の数。帯に分けなかった場合は1つの帯とし、走査線で処理しなかった場合は空。
+         *///---------------------------------------------------------------------------
+        const std::vector<std::size_t> &  getStripLoads(void) const {
+            
+            return  this->stripLoads;
+        }
+        
+        /**
+         * @brief k番目の線分のxの範囲が[left,right]と重ならないかどうか。NaNを含む線分は重なるとみなす。
+         *///---------------------------------------------------------------------------
+        bool  isApart( std::size_t k,  Element left,  Element right ) const {
+            
+            Element  x1 = this->getBegin(k)(X),  x2 = this->getEnd(k)(X);
+            
+            return  std::max(x1,x2) < left || std::min(x1,x2) > right;
+        }
+        
+        /**
+         * @brief 走査線で処理する場合に、全ての線分の傾きと切片をまとめて求める。
+         *///---------------------------------------------------------------------------
+        void  acceptScanning( HiddenLineManager * hiddenLineManager ) {
+            
+            if ( hiddenLineManager->getCurrentMethod() != HiddenLineManager::SCAN_LINE ) { return; }
+            
+            this->slopes    .resize( this->edges.size() );
+            this->intercepts.resize( this->edges.size() );
+            
+            for ( std::size_t k=0;  k < this->edges.size();  k++ ) {
+                
+                Element  x1 = this->getBegin(k)(X),  x2 = this->getEnd(k)(X);
+                Element  y1 = this->getBegin(k)(Y),  y2 = this->getEnd(k)(Y);
+                
+                this->slopes    [k] = ( y2 - y1 ) / ( x2 - x1 );
+                this->intercepts[k] =   y1 - this->slopes[k] * x1;
+            }
+        }
+        
+        /**
+         * @brief 全ての線分を描画の順に陰線処理し、残す点を共有の配列に詰める。
+         *///---------------------------------------------------------------------------
+        void  acceptComplementing( HiddenLineManager * hiddenLineManager ) {
+            
+            this->isPiecewise = ( hiddenLineManager->getCurrentMethod() != HiddenLineManager::SCAN_LINE );
+            
+            if ( hiddenLineManager->isStriped() ) { hiddenLineManager->complementStrips( *this, this->visible, this->stripLoads );  return; }
+            
+            this->visible.clear();
+            
+            for ( std::size_t k=0;  k < this->edges.size();  k++ ) {
+                
+                switch ( hiddenLineManager->getCurrentMethod() ) {
+                    
+                  case HiddenLineManager::EXACT:     this->setPieces( k, hiddenLineManager->clip       ( this->getBegin(k), this->getEnd(k) ) );       break;
+                  case HiddenLineManager::Z_BUFFER:  this->setPieces( k, hiddenLineManager->clipByDepth( this->edges[k].begin, this->edges[k].end ) );  break;
+                  default:                           this->complementEdge( k, hiddenLineManager, this->visible );                                      break;
+                }
+                
+                this->visible.close();
+            }
+            
+            if ( this->isPiecewise ) { this->stripLoads.clear(); }
+            else                     { this->stripLoads.assign( 1, hiddenLineManager->getAssessNumber() ); }
+        }
+        
+        /**
+         * @brief k番目の線分の走査線での陰線処理。hiddenLineManagerの帯にある走査線だけを処理し、残す点をpointsに加える。
+         *///---------------------------------------------------------------------------
+        void  complementEdge( std::size_t k,  HiddenLineManager * hiddenLineManager,  PointBuffer & points ) const {
+            
+            if ( hiddenLineManager->isColumnar() ) { this->complementByColumn( k, hiddenLineManager, points );  return; }
+            
+            hiddenLineManager->findPosition( this->getBegin(k)(X) );
+            
+            while ( hiddenLineManager->isInStrip() && this->isInRange( k, hiddenLineManager->getPosition() ) ) {
+                
+                this->pushBackPoint( hiddenLineManager, this->getPoint( k, hiddenLineManager->getPosition() ), points );
+                
+                hiddenLineManager->currentScanLine++;
+            }
+        }
+        
+        /**
+         * @brief styleの滑らかさで描く線分としてbatchに加える。色は陰線処理をするかどうかで決める。
+         *///---------------------------------------------------------------------------
+        void  draw( LineBatch & batch,  LineStyle style ) const {
+            
+            if ( Option::getGraph().isHiddenLine ) { style.color = RGBA(0,0,0,0.2);  this->appendLines<true >( batch.get(style) ); }
+            else                                       { style.color = RGBA(0,0,0,0.7);  this->appendLines<false>( batch.get(style) ); }
+        }
+        
+      private:
+        
+        /**
+         * @brief 頂点の配列での始点と終点の番号。
+         *///---------------------------------------------------------------------------
+        struct Edge {
+            
+            Edge( Index begin_,  Index end_) : begin( begin_), end( end_) {}
+            
+            Index  begin;
+            Index  end;
+        };
+        
+        /**
+         * @brief 全ての線分をpointsに加える。陰線処理をした場合は残った部分を、しない場合は線分全体を加える。
+         *        分岐はコンパイル時に決まる。残った点は順につなぐが、正確に処理した場合は2点ずつの組で加える。
+         *///---------------------------------------------------------------------------
+        template<bool IsHiddenLine>
+        void  appendLines( PointArray & points ) const {
+            
+            if ( IsHiddenLine && this->visible.getEdgeNumber() != this->edges.size() ) { return; }
+            
+            std::size_t  step = this->isPiecewise ? 2 : 1;
+            
+            if ( ! IsHiddenLine ) { points.reserve( points.size() + 2 * this->edges.size() ); }
+            
+            for ( std::size_t k=0;  k < this->edges.size();  k++ ) {
+                
+                if ( IsHiddenLine ) {
+                    
+                    PointBuffer::const_iterator  first = this->visible.begin(k);
+                    PointBuffer::const_iterator  last  = this->visible.end  (k);
+                    
+                    for ( PointBuffer::const_iterator  it = first;  last - it >= 2;  it += step ) {
+                        
+                        points.push_back( * it      );
+                        points.push_back( *(it + 1) );
+                    }
+                    
+                } else {
+                    
+                    points.push_back( this->getBegin(k) );
+                    points.push_back( this->getEnd  (k) );
+                }
+            }
+        }
+        
+        /**
+         * @brief 媒介変数の区間の列piecesで表したk番目の線分の見える部分の、両端を組にして残す。
+         *///---------------------------------------------------------------------------
+        void  setPieces( std::size_t k,  const RangeList & pieces ) {
+            
+            for ( RangeList::const_iterator  it = pieces.begin();  it != pieces.end();  it++ ) {
+                
+                this->visible.push_back( this->interpolate( k, it->first  ) );
+                this->visible.push_back( this->interpolate( k, it->second ) );
+            }
+        }
+        
+        /**
+         * @brief 始点を0・終点を1とする媒介変数tでのk番目の線分上の点。
+         *///---------------------------------------------------------------------------
+        Point2  interpolate( std::size_t k,  Element t ) const {
+            
+            const Point2 &  begin = this->getBegin(k);
+            const Point2 &  end   = this->getEnd  (k);
+            
+            Point2  point = {{ begin(X) + t * ( end(X) - begin(X) ),
+                               begin(Y) + t * ( end(Y) - begin(Y) ) }};
+            
+            return  point;
+        }
+        
+        /**
+         * @brief 走査線を列ごとに置いている場合のk番目の線分の陰線処理。
+         *        始点と終点はそれぞれを含む列で、その間は各列の中央で査定するので、
+         *        線分ごとの手間は線分が掛かる列の数に比例する。
+         *///---------------------------------------------------------------------------
+        void  complementByColumn( std::size_t k,  HiddenLineManager * hiddenLineManager,  PointBuffer & points ) const {
+            
+            const Point2 &  begin = this->getBegin(k);
+            const Point2 &  end   = this->getEnd  (k);
+            
+            if ( !( begin(X) <= end(X) ) ) { return; }
+            
+            if ( hiddenLineManager->findColumn( begin(X) ) ) { this->pushBackPoint( hiddenLineManager, begin, points ); }
+            
+            for ( hiddenLineManager->findPosition( begin(X) );
+                  hiddenLineManager->isInStrip() && hiddenLineManager->getPosition() < end(X);
+                  hiddenLineManager->currentScanLine++ ) {
+                
+                this->pushBackPoint( hiddenLineManager, this->getPoint( k, hiddenLineManager->getPosition() ), points );
+            }
+            
+            if ( hiddenLineManager->findColumn( end(X) ) ) { this->pushBackPoint( hiddenLineManager, end, points ); }
+        }
+        
+        /**
+         * @brief 現在の走査線でpointが見えるなら、pointsに加える。
+         *///---------------------------------------------------------------------------
+        static void  pushBackPoint( HiddenLineManager * hiddenLineManager,  const Point2 & point,  PointBuffer & points ) {
+            
+            if ( hiddenLineManager->assess( point(Y) ) ) {
+                
+                points.push_back(point);
+            }
+        }
+        
+        /**
+         * @brief 走査線scanLine上のk番目の線分の点。
+         *///---------------------------------------------------------------------------
+        Point2  getPoint( std::size_t k,  Element scanLine ) const {
+            
+            Point2  point = {{ scanLine, this->slopes[k] * scanLine + this->intercepts[k] }};
+            
+            return  point;
+        }
+        
+        /**
+         * @brief 走査線scanLineがk番目の線分のxの範囲にあるかどうか。
+         *///---------------------------------------------------------------------------
+        bool  isInRange( std::size_t k,  Element scanLine ) const {
+            
+            return  ( this->getBegin(k)(X) <= scanLine ) && ( scanLine <= this->getEnd(k)(X) );
+        }
+        
+        /**
+         * @brief ポリラインの頂点の並び。p番目のポリラインのk番目の頂点は、頂点の配列のfirst + p * lineStride + k * vertexStride番目。
+         *///---------------------------------------------------------------------------
+        struct Layout {
+            
+            Layout(void) : first(0), lineNumber(0), lineStride(0), vertexNumber(0), vertexStride(0) {}
+            
+            std::ptrdiff_t  first;
+            std::size_t     lineNumber;
+            std::ptrdiff_t  lineStride;
+            std::size_t     vertexNumber;
+            std::ptrdiff_t  vertexStride;
+        };
+        
+        /**
+         * @brief 全ての頂点を使う線分の表を作る。
+         *///---------------------------------------------------------------------------
+        void  setEdges(void) {
+            
+            const Layout &  l = this->layout;
+            
+            this->edges      .clear();
+            this->lineOffsets.assign( 1, 0 );
+            this->visible    .clear();
+            this->isReduced = false;
+            
+            if ( l.vertexNumber < 2 ) { return; }
+            
+            this->edges      .reserve( l.lineNumber * ( l.vertexNumber - 1 ) );
+            this->lineOffsets.reserve( l.lineNumber + 1 );
+            
+            std::ptrdiff_t  first = l.first;
+            
+            for ( std::size_t p=0;  p < l.lineNumber;  p++, first += l.lineStride ) {
+                
+                std::ptrdiff_t  vertex = first;
+                
+                for ( std::size_t k=1;  k < l.vertexNumber;  k++, vertex += l.vertexStride ) {
+                    
+                    this->edges.push_back( Edge( static_cast<Index>(vertex), static_cast<Index>( vertex + l.vertexStride ) ) );
+                }
+                
+                this->lineOffsets.push_back( this->edges.size() );
+            }
+        }
+        
+        /**
+         * @brief 先頭の頂点の番号がfirstのポリラインの頂点をbucketSize個ごとの区間に分け、残す頂点の番号を順にkeptに入れる。
+         *        区間の先頭と、画面の縦方向で最小・最大の頂点を残す。不定の頂点との境目は、線の途切れを保つために両側を残す。
+         *        列方向のポリラインは頂点が離れて並ぶので、各頂点は1回だけ読む。
+         *///---------------------------------------------------------------------------
+        void  bucket( std::ptrdiff_t first,  std::size_t bucketSize,  std::vector<std::size_t> & kept ) const {
+            
+            const std::size_t  number = this->layout.vertexNumber;
+            
+            std::vector<char>  isKept( number, 0 );
+            
+            Element  previous = (*this->vertices)[ this->getIndex( first, 0 ) ](Y);
+            
+            for ( std::size_t begin=0;  begin < number - 1;  begin += bucketSize ) {
+                
+                std::size_t  end     = std::min( begin + bucketSize, number - 1 );
+                std::size_t  minimum = begin,  maximum = begin;
+                Element      lowest  = (*this->vertices)[ this->getIndex( first, begin ) ](Y);
+                Element      highest = lowest;
+                
+                if ( ( previous != previous ) != ( lowest != lowest ) ) { isKept[begin-1] = isKept[begin] = 1; }
+                
+                previous = lowest;
+                
+                for ( std::size_t k=begin+1;  k < end;  k++ ) {
+                    
+                    Element  y = (*this->vertices)[ this->getIndex( first, k ) ](Y);
+                    
+                    if ( ( previous != previous ) != ( y != y ) ) { isKept[k-1] = isKept[k] = 1; }
+                    
+                    previous = y;
+                    
+                    if ( y != y ) { continue; }   // 不定の頂点は境目で残す。
+                    
+                    if ( !( lowest  <= y ) ) { minimum = k;  lowest  = y; }
+                    if ( !( highest >= y ) ) { maximum = k;  highest = y; }
+                }
+                
+                isKept[begin] = isKept[minimum] = isKept[maximum] = 1;
+            }
+            
+            Element  last = (*this->vertices)[ this->getIndex( first, number - 1 ) ](Y);
+            
+            if ( ( previous != previous ) != ( last != last ) ) { isKept[ number - 2 ] = 1; }
+            
+            isKept[ number - 1 ] = 1;
+            
+            kept.clear();
+            
+            for ( std::size_t k=0;  k < number;  k++ ) {
+                
+                if ( isKept[k] ) { kept.push_back(k); }
+            }
+        }
+        
+        /**
+         * @brief 先頭の頂点の番号がfirstのポリラインの、keptに並べた頂点のうち、
+         *        画面での誤差がtolerance以下で済むものを反復版のDouglas-Peucker法で除く。不定の頂点は残す。
+         *        列方向のポリラインは頂点が離れて並ぶので、先に連続した配列に集めてから調べる。
+         *///---------------------------------------------------------------------------
+        void  simplify( std::ptrdiff_t first,  Element tolerance,  std::vector<std::size_t> & kept ) const {
+            
+            if ( kept.size() < 3 ) { return; }
+            
+            std::vector<char>                                  isKept( kept.size(), 0 );
+            std::vector< std::pair<std::size_t,std::size_t> >  stack;
+            PointArray                                         points( kept.size() );
+            
+            for ( std::size_t k=0;  k < kept.size();  k++ ) { points[k] = (*this->vertices)[ this->getIndex( first, kept[k] ) ]; }
+            
+            isKept.front() = isKept.back() = 1;
+            
+            stack.push_back( std::make_pair( std::size_t(0), kept.size() - 1 ) );
+            
+            while ( ! stack.empty() ) {
+                
+                std::size_t  a = stack.back().first;
+                std::size_t  b = stack.back().second;
+                
+                stack.pop_back();
+                
+                const Point2 &  begin    = points[a];
+                Element         dx       = points[b](X) - begin(X),  dy = points[b](Y) - begin(Y);
+                Element         length2  = dx*dx + dy*dy;
+                Element         scale    = ( length2 > 0 ) ? length2 : 1;
+                std::size_t     farthest = a;
+                Element         maximum  = tolerance * tolerance * scale;
+                
+                for ( std::size_t k=a+1;  k < b;  k++ ) {
+                    
+                    Element  distance = getScaledDistance( points[k], begin, dx, dy, length2, scale );
+                    
+                    if ( !( distance <= maximum ) ) { farthest = k;  maximum = distance; }
+                    if ( distance != distance     ) { break; }
+                }
+                
+                if ( farthest == a ) { continue; }
+                
+                isKept[farthest] = 1;
+                
+                stack.push_back( std::make_pair( a,        farthest ) );
+                stack.push_back( std::make_pair( farthest, b        ) );
+            }
+            
+            std::size_t  number = 0;
+            
+            for ( std::size_t k=0;  k < kept.size();  k++ ) {
+                
+                if ( isKept[k] ) { kept[number++] = kept[k]; }
+            }
+            
+            kept.resize(number);
+        }
+        
+        /**
+         * @brief 先頭の頂点の番号がfirstのポリラインの、k番目の頂点の番号。
+         *///---------------------------------------------------------------------------
+        std::ptrdiff_t  getIndex( std::ptrdiff_t first,  std::size_t k ) const {
+            
+            return  first + static_cast<std::ptrdiff_t>(k) * this->layout.vertexStride;
+        }
+        
+        /**
+         * @brief 点pointから、beginと(begin+(dx,dy))を結ぶ線分までの距離の2乗にscaleを掛けたもの。
+         *        length2は線分の長さの2乗で、scaleはそれが0の場合に1にしたもの。割り算と平方根を使わずに、同じ線分までの距離を比べる。
+         *        どれかの点が不定の場合は不定を返す。
+         *///---------------------------------------------------------------------------
+        static Element  getScaledDistance( const Point2 & point,  const Point2 & begin,  Element dx,  Element dy,  Element length2,  Element scale ) {
+            
+            if ( length2 != length2 ) { return length2; }
+            
+            Element  px  = point(X) - begin(X),  py = point(Y) - begin(Y);
+            Element  dot = px*dx + py*dy;
+            
+            if ( !( dot > 0       ) ) { return  ( px*px + py*py ) * scale; }   // 始点が最も近い。不定もここで返す。
+            if ( !( dot < length2 ) ) { return  ( ( px - dx )*( px - dx ) + ( py - dy )*( py - dy ) ) * scale; }
+            
+            Element  cross = px*dy - py*dx;
+            
+            return  cross * cross;
+        }
+        
+        /**
+         * @brief k番目の線分の始点と終点。
+         *///---------------------------------------------------------------------------
+        const Point2 &  getBegin( std::size_t k ) const { return (*this->vertices)[ this->edges[k].begin ]; }
+        const Point2 &  getEnd  ( std::size_t k ) const { return (*this->vertices)[ this->edges[k].end   ]; }
+        
+        const PointArray *        vertices;
+        std::vector<Edge>         edges;
+        std::vector<std::size_t>  lineOffsets;
+        ElementArray              slopes;
+        ElementArray              intercepts;
+        PointBuffer               visible;
+        std::vector<std::size_t>  stripLoads;
+        bool                      isPiecewise;
+        Layout                    layout;
+        bool                      isReduced;
+    };
+    
+    
+    /**
+     * @brief 走査線の帯1つ分の陰線処理。全ての線分を描画の順に処理し、残す点を線分ごとに区切って持つ。
+     *        帯どうしは異なる走査線の水平線だけを更新し、一時的な領域も帯ごとの一時領域から確保するので、同時に処理できる。
+     *///---------------------------------------------------------------------------
+    class HiddenLineManager::Strip {
+        
+      public:
+        
+        Strip( const HiddenLineManager & owner,  std::size_t first,  std::size_t last,  FrameArena & arena ) : manager( owner, first, last, arena ), points( &arena ) {}
+        
+        /**
+         * @brief targetの線分を順に処理する。帯の両隣の走査線の間に掛からない線分は、走査線を探さずに飛ばす。
+         *        点の残った線分だけを、線分の番号と共に閉じる。
+         *///---------------------------------------------------------------------------
+        void  complement( const PolyLineList & target ) {
+            
+            const ScanLineSet &  scanLines = this->manager.scanLines;
+            
+            Element  left  = ( this->manager.firstScanLine > 0 ) ? scanLines[ this->manager.firstScanLine - 1 ] : -std::numeric_limits<Element>::infinity();
+            Element  right = scanLines[ this->manager.lastScanLine ];
+            
+            this->points.clear();
+            
+            for ( std::size_t k=0;  k < target.getEdgeNumber();  k++ ) {
+                
+                if ( target.isApart( k, left, right ) ) { continue; }
+                
+                target.complementEdge( k, &this->manager, this->points );
+                
+                this->points.closeAs(k);
+            }
+        }
+        
+        HiddenLineManager  manager;
+        PointBuffer        points;
+    };
+    
+    
+    /**
+     * @brief parallelForで帯ごとに陰線処理をする。
+     *///---------------------------------------------------------------------------
+    class HiddenLineManager::StripComplementer {
+        
+      public:
+        
+        StripComplementer( std::vector< shared_ptr<Strip> > & strips_,  const PolyLineList & target_) : strips( strips_), target( target_) {}
+        
+        void  operator ()( std::size_t k ) { this->strips[k]->complement( this->target ); }
+        
+      private:
+        
+        std::vector< shared_ptr<Strip> > &  strips;
+        const PolyLineList &                target;
+    };
+    
+    
+    /**
+     * @brief 走査線を帯に分けて帯ごとに別のスレッドでtargetの陰線処理をし、線分ごとに結果をvisibleに集める。
+     *        各走査線の水平線は1つの帯だけが更新し、帯の中では線分を描画の順に処理するので、
+     *        結果は1つのスレッドで処理した場合と同じになる。帯ごとに査定した点の数をloadsに入れる。
+     *///---------------------------------------------------------------------------
+    inline void  HiddenLineManager::complementStrips( PolyLineList & target,  PointBuffer & visible,  std::vector<std::size_t> & loads ) {
+        
+        std::vector< shared_ptr<Strip> >  strips;
+        std::vector<const PointBuffer *>  parts;
+        
+        std::size_t  expected = visible.getPointNumber() / this->stripNumber;   // 前回の結果から帯ごとの点の数を見込む。
+        
+        for ( std::size_t s=0;  s < this->stripNumber;  s++ ) {
+            
+            std::size_t  first = this->lastScanLine *  s      / this->stripNumber;
+            std::size_t  last  = this->lastScanLine * (s + 1) / this->stripNumber;
+            
+            strips.push_back( shared_ptr<Strip>( new Strip( *this, first, last, this->arena.getChild(s) ) ) );
+            parts .push_back( &strips.back()->points );
+            
+            strips.back()->points.reserve( expected + expected / 4 );
+        }
+        
+        StripComplementer  complementer( strips, target );
+        
+        parallelFor( strips.size(), complementer, this->stripNumber );
+        
+        visible.gather( target.getEdgeNumber(), parts );
+        
+        loads.clear();
+        
+        for ( std::size_t s=0;  s < strips.size();  s++ ) { loads.push_back( strips[s]->manager.assessNumber ); }
+    }
+    
+    
+    /**
+     * @brief 目盛を表すクラス。
+     *///---------------------------------------------------------------------------
+    class Tics : public Composite<Tics>, public Subject {
+        
+      public:
+        
+        /**
+         * @brief 目盛線がline_、親要素がparent_、オプションがoption_の目盛を生成する。
+         *///---------------------------------------------------------------------------
+        Tics( const Option & option_, const Vector & line_, const Subject * parent_) :
+            
+            option( option_), line( line_), parent( parent_), generation(0)
+        {}
+        
+        /**
+         * @brief 位置リストを取得する。
+         *///---------------------------------------------------------------------------
+        const VertexList & getPositions(void) const {
+            
+            return this->positions;
+        }
+        
+        /**
+         * @brief 目盛の方向を取得する。
+         *///---------------------------------------------------------------------------
+        const Vector & getDirection(void) const {
+            
+            return this->parent->getDirection();
+        }
+        
+        /**
+         * @brief 区間数を取得する。
+         *///---------------------------------------------------------------------------
+        std::size_t  getIntervalNumber(void) const {
+            
+            return  this->option.get("divisionNumber") * this->parent->getIntervalNumber();
+        }
+        
+        /**
+         * @brief iが設定可能な場所かどうかを取得する。 
+         *///---------------------------------------------------------------------------
+        bool  isSettablePosition(int i) const {
+            
+            return  i % this->child->option.get("divisionNumber");
+        }
+        
+      private:
+        
+        /**
+         * @brief 目盛線を行列affineで座標変換した後、styleで描く線分としてbatchに加える。 
+         *///---------------------------------------------------------------------------
+        void  drawMyself( LineBatch & batch,  const LineStyle & style,  const Matrix & affine ) const {
+            
+            if ( this->option.get("isDraw") ) {
+                
+                this->setPosition();
+                
+                appendParallelLines( batch.get(style), affine, this->positions, this->line );
+            }
+        }
+        
+        /**
+         * @brief 目盛線の位置の設定。位置はオプションだけで決まるので、オプションの世代が変わった時だけ求め直す。
+         *///---------------------------------------------------------------------------
+        void  setPosition(void) const {
+            
+            if ( this->generation == Option::getGeneration() ) { return; }
+            
+            this->generation = Option::getGeneration();
+            
+            Vector  distance( this->parent->getDirection() / this->getIntervalNumber() );
+            
+            this->positions.clear();
+            
+            for ( Index i=0;  i <= this->getIntervalNumber();  i++ ) {
+                
+                if ( this->parent->isSettablePosition(i) ) {
+                    
+                    this->positions.push_back( i * distance );
+                }
+            }
+        }
+        
+        const   Option      option;
+        const   Subject *   parent;
+        const   Vector      line;
+        mutable VertexList  positions;
+        mutable Generation  generation;
+    };
+    
+    
+    /**
+     * @brief 座標軸を表すクラス。
+     *///---------------------------------------------------------------------------
+    class Axis : public Composite<Tics>, public Subject {
+        
+      public:
+        
+        /**
+         * @brief 方向がdirection_の座標軸を生成する。
+         *///---------------------------------------------------------------------------
+        Axis( const Option & option_, const Vector & direction_) :
+            
+            option( option_), direction( direction_)
+        {}
+        
+        /**
+         * @brief 座標軸の方向を取得する。
+         *///---------------------------------------------------------------------------
+        const Vector & getDirection(void) const {
+            
+            return this->direction;
+        }
+        
+        /**
+         * @brief 区間数を取得する。
+         *///---------------------------------------------------------------------------
+        std::size_t  getIntervalNumber(void) const {
+            
+            return 1;
+        }
+        
+        /**
+         * @brief iが設定可能な場所かどうかを取得する。 
+         *///---------------------------------------------------------------------------
+        bool  isSettablePosition(int i) const {
+            
+            return true;
+        }
+        
+      private:
+        
+        /**
+         * @brief 座標軸を行列affineで座標変換した後、styleで描く線分としてbatchに加える。
+         *///---------------------------------------------------------------------------
+        void  drawMyself( LineBatch & batch,  const LineStyle & style,  const Matrix & affine ) const {
+            
+            if ( this->option.get("isDraw") ) {
+                
+                appendLine( batch.get(style), affine, V::ZERO, this->direction );
+            }
+        }
+        
+        const Option  option;
+        const Vector  direction;
+    };
+    
+    
+    /**
+     * @brief グリッドを表すクラス。
+     *///---------------------------------------------------------------------------
+    class Grid : public Composite<Grid> {
+        
+      public:
+        
+        /**
+         * @brief オプションがoption_で目盛tics1_と目盛tics2_についてのグリッドを生成する。
+         *///---------------------------------------------------------------------------
+        Grid( const Option & option_, const Subject * tics1_, const Subject * tics2_) :
+            
+            option( option_), tics1( tics1_), tics2( tics2_)
+        {}
+        
+      private:
+        
+        /**
+         * @brief 格子線を行列affineで座標変換した後、styleの色の破線で描く線分としてbatchに加える。
+         *///---------------------------------------------------------------------------
+        void  drawMyself( LineBatch & batch,  const LineStyle & style,  const Matrix & affine ) const {
+            
+            if ( this->option.get("isDraw") ) {
+                
+                PointArray &  points = batch.get( LineStyle( style.color, 0x8888, style.isSmooth ) );
+                
+                appendParallelLines( points, affine, this->tics1->getPositions(), this->tics2->getDirection() );
+                appendParallelLines( points, affine, this->tics2->getPositions(), this->tics1->getDirection() );
+            }
+        }
+        
+        const Option    option;
+        const Subject * tics1;
+        const Subject * tics2;
+    };
+    
+    
+    /**
+     * @brief ３次元グラフを表すクラス。
+     *///---------------------------------------------------------------------------
+    class Graph {
+        
+      public:
+        
+        /**
+         * @brief graphセクションのオプションで描くグラフを生成する。頂点は後からsetで設定する。
+         *///---------------------------------------------------------------------------
+        Graph(void) :
+            
+            isBounded(false), dataGeneration(0),
+            operatedData(0), operatedOption(0), projectedRange(0), projectedOption(0), projectedColumn(0), projectedTolerance(0), projectedSpacing(0),
+            pyramidData(0), pyramidStages(0), pyramidBudget(-1), startLevel(0), level(0), projectedLevel(0), isBatched(false)
+        {}
+        
+        /**
+         * @brief 最小値・最大値を取得する。
+         *///---------------------------------------------------------------------------
+        const MinMaxManager & getMinMaxManager(void) const {
+            
+            return  this->minmaxManager;
+        }
+        
+        /**
+         * @brief 陰線処理の一時領域を最後に陰線処理をした描画で同時に使った大きさの最大値[バイト]。
+         *///---------------------------------------------------------------------------
+        std::size_t  getArenaPeak(void) const {
+            
+            return  this->arena.getPeak();
+        }
+        
+        /**
+         * @brief 最後に陰線処理をした描画で陰線処理に渡した、描くポリラインの線分の数。間引いた場合は間引いた後の数。
+         *///---------------------------------------------------------------------------
+        std::size_t  getEdgeNumber(void) const {
+            
+            std::size_t  number = 0;
+            
+            if ( Option::getGraph().isDrawXPolyLines ) { number += this->xPolyLines.getEdgeNumber(); }
+            if ( Option::getGraph().isDrawYPolyLines ) { number += this->yPolyLines.getEdgeNumber(); }
+            
+            return  number;
+        }
+        
+        /**
+         * @brief 最後に走査線で陰線処理をした描画での、帯ごとに査定した点の数。帯の手間の目安になる。
+         *        x方向とy方向のポリラインの分を帯ごとに足す。走査線で処理しなかった場合は空。
+         *///---------------------------------------------------------------------------
+        std::vector<std::size_t>  getStripLoads(void) const {
+            
+            std::vector<std::size_t>  loads;
+            
+            const PolyLineList *  lists[2] = { Option::getGraph().isDrawXPolyLines ? &this->xPolyLines : 0,
+                                               Option::getGraph().isDrawYPolyLines ? &this->yPolyLines : 0 };
+            
+            for ( std::size_t k=0;  k < 2;  k++ ) {
+                
+                if ( ! lists[k] ) { continue; }
+                
+                const std::vector<std::size_t> &  part = lists[k]->getStripLoads();
+                
+                if ( loads.size() < part.size() ) { loads.resize( part.size(), 0 ); }
+                
+                for ( std::size_t s=0;  s < part.size();  s++ ) { loads[s] += part[s]; }
+            }
+            
+            return  loads;
+        }
+        
+        /**
+         * @brief fileNameが指すファイルから、頂点を設定する。
+         *        バイナリ形式(.3dg)とテキスト形式のどちらも読み込める。
+         *        読み込みに失敗した場合はfalseを返し、頂点は変更しない。
+         *///---------------------------------------------------------------------------
+        bool  set( const char * path ) {
+            
+            return  BinaryGridLoader::isBinary(path) ? this->setBinary(path) : this->setText(path);
+        }
+        
+        /**
+         * @brief 1画素の幅がpixelWidthの画面として、sinkにstyleで描画する。
+         *        頂点とオプションが前回と同じ世代なら、頂点の操作・座標変換・陰線処理を省き、前回の結果を描画する。
+         *        走査線を列ごとに置く場合とポリラインや頂点を間引く場合は、画素の幅が変わった時も陰線処理をやり直す。
+         *        描く線分は描き方ごとに1つの配列にまとめておき、陰線処理の結果か描き方が変わった時だけ作り直す。
+         *        ピラミッドがある場合は、陰線処理をやり直す時に最も粗い段から描き、refineで1段ずつ細かくする。
+         *///---------------------------------------------------------------------------
+        void  draw( RenderSink & sink,  const LineStyle & style,  const AffineManager * affineManager,  int target,  Element pixelWidth ) const {
+            
+            this->prepare( style, affineManager, target, pixelWidth );
+            
+            this->batch.submit(sink);
+        }
+        
+        /**
+         * @brief drawで描く線分の配列を、描画先を使わずに作る。引数はdrawと同じ。
+         *        描画先を持たないスレッドで前もって呼んでおけば、続くdrawは配列を描くだけで済む。
+         *///---------------------------------------------------------------------------
+        void  prepare( const LineStyle & style,  const AffineManager * affineManager,  int target,  Element pixelWidth ) const {
+            
+            if ( this->operatedData != this->dataGeneration || this->operatedOption != Option::getGeneration() ) {
+                
+                this->operateVertex();
+                
+                this->operatedData   = this->dataGeneration;
+                this->operatedOption = Option::getGeneration();
+            }
+            
+            this->buildPyramid();
+            
+            Element  columnWidth = this->getColumnWidth(pixelWidth);
+            Element  tolerance   = this->getTolerance  (pixelWidth);
+            Element  spacing     = this->getSpacing    (pixelWidth);
+            
+            bool  isChanged = this->projectedRange  != this->minmaxManager.getGeneration() ||
+                              this->projectedOption != Option::getGeneration()             ||
+                              this->projectedColumn != columnWidth                         ||
+                              this->projectedTolerance != tolerance                        || this->projectedSpacing != spacing;
+            
+            if ( isChanged ) { this->level = this->startLevel; }
+            
+            if ( isChanged || this->projectedLevel != this->level ) {
+                
+                this->complement( this->pyramid.scale( affineManager->get(target), this->level ), this->pyramid.get(this->level),
+                                  columnWidth, tolerance, spacing );
+                
+                this->projectedRange     = this->minmaxManager.getGeneration();
+                this->projectedOption    = Option::getGeneration();
+                this->projectedColumn    = columnWidth;
+                this->projectedTolerance = tolerance;
+                this->projectedSpacing   = spacing;
+                this->projectedLevel     = this->level;
+                this->isBatched          = false;
+            }
+            
+            if ( ! this->isBatched || this->batchStyle != style ) {
+                
+                this->batch.clear();
+                
+                if ( Option::getGraph().isDrawXPolyLines ) { this->xPolyLines.draw( this->batch, style ); }
+                if ( Option::getGraph().isDrawYPolyLines ) { this->yPolyLines.draw( this->batch, style ); }
+                
+                this->batchStyle = style;
+                this->isBatched  = true;
+            }
+        }
+        
+        /**
+         * @brief 次の描画でピラミッドの1段細かい格子を使う。1画素の幅がpixelWidthの画面で、
+         *        元の格子か、画面の画素の数より行数・列数が少なくならない最も粗い段に達していればfalseを返す。
+         *///---------------------------------------------------------------------------
+        bool  refine( Element pixelWidth ) const {
+            
+            std::size_t  number = ( pixelWidth > 0 ) ? static_cast<std::size_t>( std::ceil( ( VIEW_MAXIMUM - VIEW_MINIMUM ) / pixelWidth ) )
+                                                     : std::numeric_limits<std::size_t>::max();
+            
+            if ( this->level <= this->pyramid.findLevel(number) ) { return false; }
+            
+            this->level--;
+            
+            return true;
+        }
+        
+      private:
+        
+        /**
+         * @brief テキスト形式のファイルから頂点を設定する。
+         *///---------------------------------------------------------------------------
+        bool  setText( const char * path ) {
+            
+            GridLoader  loader;
+            GridStore   vertices;
+            
+            if ( ! loader.open(path) || ! loader.read(vertices) ) { return false; }
+            
+            this->isBounded = false;
+            this->binaryPath.clear();
+            this->setVertex(vertices);
+            
+            return true;
+        }
+        
+        /**
+         * @brief バイナリ形式のファイルから頂点と範囲を設定する。
+         *        z値はマップした領域を複写せずに参照する。
+         *///---------------------------------------------------------------------------
+        bool  setBinary( const char * path ) {
+            
+            shared_ptr<BinaryGridLoader>  loader( new BinaryGridLoader );
+            GridStore                     vertices;
+            
+            if ( ! loader->open(path) ) { return false; }
+            
+            vertices.attach( loader->getData(), loader->getRowNumber(), loader->getColumnNumber(), loader );
+            
+            const GridHeader &  header = loader->getHeader();
+            
+            this->bounds.x.set( header.minimum[X], header.maximum[X] );
+            this->bounds.y.set( header.minimum[Y], header.maximum[Y] );
+            this->bounds.z.set( header.minimum[Z], header.maximum[Z] );
+            
+            this->isBounded = true;
+            this->binaryPath = path;
+            this->setVertex(vertices);
+            
+            return true;
+        }
+        
+        /**
+         * @brief 頂点の設定。
+         *///---------------------------------------------------------------------------
+        void  setVertex( GridStore & vertices ) {
+            
+            this->original.swap(vertices);
+            
+            this->dataGeneration = newGeneration();
+        }
+        
+        /**
+         * @brief 格子verticesのポリラインの設定。
+         *        x方向は行ごと、y方向は列ごとに手前の列から順に並べる。
+         *///---------------------------------------------------------------------------
+        void  setPolyLine( const GridStore & vertices ) const {
+            
+            std::size_t  rowNumber    = vertices.getRowNumber();
+            std::size_t  columnNumber = vertices.getColumnNumber();
+            
+            this->xPolyLines.set( this->projected, 0,                rowNumber,     columnNumber,  columnNumber, 1            );
+            this->yPolyLines.set( this->projected, columnNumber - 1, columnNumber,  -1,            rowNumber,    columnNumber );
+        }
+        
+        /**
+         * @brief 頂点を操作し、最小値・最大値を求める。
+         *        頂点を操作しない場合は元の頂点をそのまま使い、範囲が既知なら最小値・最大値も求め直さない。
+         *///---------------------------------------------------------------------------
+        void  operateVertex(void) const {
+            
+            this->pipeline.setStages( this->getStages() );
+            
+            if      ( ! this->pipeline.isEmpty() ) { this->pipeline.run( this->original, this->transformed, this->minmaxManager ); }
+            else if ( this->isBounded            ) { this->minmaxManager = this->bounds;  this->minmaxManager.touch();            }
+            else                                   { this->minmaxManager.set( this->original );                                   }
+        }
+        
+        /**
+         * @brief オプションから頂点に適用する操作を求める。
+         *///---------------------------------------------------------------------------
+        int  getStages(void) const {
+            
+            int  stages = 0;
+            
+            if ( Option::getGraph().isRegularizeX ) { stages |= VertexPipeline::REGULARIZE_ROWS;    }
+            if ( Option::getGraph().isRegularizeY ) { stages |= VertexPipeline::REGULARIZE_COLUMNS; }
+            if ( Option::getGraph().isLogScale    ) { stages |= VertexPipeline::LOG_SCALE;          }
+            
+            return stages;
+        }
+        
+        /**
+         * @brief 頂点を操作した格子から、頂点の数がlodVertexBudget[千頂点]以下になるまでピラミッドを作り、最初に描く段を決める。
+         *        頂点を操作しない場合は、バイナリ形式のデータファイルと共に置いたキャッシュファイルがあり、
+         *        キャッシュファイルを書き出した後にデータファイルが更新されていなければ、それを使う。
+         *        lodVertexBudgetが0の場合は元の格子だけにする。頂点・操作・上限が前回と同じなら作り直さない。
+         *///---------------------------------------------------------------------------
+        void  buildPyramid(void) const {
+            
+            int  budget = std::max( 0, Option::getGraph().lodVertexBudget );
+            
+            if ( this->pyramidData == this->dataGeneration && this->pyramidStages == this->getStages() && this->pyramidBudget == budget ) { return; }
+            
+            const GridStore &  base          = this->pipeline.isEmpty() ? this->original : this->transformed;
+            std::size_t        maximumNumber = ( budget > 0 ) ? static_cast<std::size_t>(budget) * 1000 : std::numeric_limits<std::size_t>::max();
+            
+            bool  isCached = budget > 0 && &base == &this->original && ! this->binaryPath.empty() && this->pyramid.load( this->binaryPath.c_str(), base );
+            
+            if ( ! isCached ) { this->pyramid.build( base, maximumNumber ); }
+            
+            this->startLevel    = this->pyramid.findStartLevel(maximumNumber);
+            
+            this->pyramidData   = this->dataGeneration;
+            this->pyramidStages = this->getStages();
+            this->pyramidBudget = budget;
+        }
+        
+        /**
+         * @brief 陰線処理の走査線を置く列の幅、または奥行きを描き込む画素の幅。
+         *        scanLineDensityが0の場合と、どちらも使わない場合は0を返す。
+         *///---------------------------------------------------------------------------
+        Element  getColumnWidth( Element pixelWidth ) const {
+            
+            int  density = Option::getGraph().scanLineDensity;
+            
+            switch ( HiddenLineManager::getMethod() ) {
+                
+              case HiddenLineManager::SCAN_LINE:  return  ( density > 0 && pixelWidth > 0 ) ? pixelWidth / density : 0;
+              case HiddenLineManager::Z_BUFFER:   return  pixelWidth;
+              default:                            return  0;
+            }
+        }
+        
+        /**
+         * @brief 陰線処理の前にポリラインを間引く許容誤差。simplifyToleranceは1/10画素単位で、0の場合は0を返す。
+         *///---------------------------------------------------------------------------
+        Element  getTolerance( Element pixelWidth ) const {
+            
+            int  tolerance = Option::getGraph().simplifyTolerance;
+            
+            return  ( tolerance > 0 && pixelWidth > 0 ) ? pixelWidth * tolerance / 10 : 0;
+        }
+        
+        /**
+         * @brief 描くポリラインの画面での最小の間隔。decimationSpacingは画素単位で、0の場合は0を返す。
+         *///---------------------------------------------------------------------------
+        Element  getSpacing( Element pixelWidth ) const {
+            
+            int  spacing = Option::getGraph().decimationSpacing;
+            
+            return  ( spacing > 0 && pixelWidth > 0 ) ? pixelWidth * spacing : 0;
+        }
+        
+        /**
+         * @brief 点の配列pointsで間隔strideで並ぶnumber本の線を、画面での間隔がspacing以上になるように何本ごとに描くか。
+         *        各線は間隔stepで並ぶlength個の点からなる。線の間隔は、最初と最後の線の対応する点の距離を
+         *        線の始点・中点・終点で求め、その最大値を線の本数で割って見積もる。見積もれない場合は1を返す。
+         *///---------------------------------------------------------------------------
+        static std::size_t  getLineStep( const PointArray & points,  std::size_t number,  std::ptrdiff_t stride,
+                                                                     std::size_t length,  std::ptrdiff_t step,  Element spacing ) {
+            
+            if ( !( spacing > 0 ) || number < 2 || length < 1 ) { return 1; }
+            
+            const std::size_t  samples[3] = { 0, length / 2, length - 1 };
+            
+            Element  distance = 0;
+            
+            for ( int k=0;  k < 3;  k++ ) {
+                
+                std::ptrdiff_t  first = static_cast<std::ptrdiff_t>( samples[k] ) * step;
+                std::ptrdiff_t  last  = first + static_cast<std::ptrdiff_t>( number - 1 ) * stride;
+                
+                Element  dx = points[last](X) - points[first](X);
+                Element  dy = points[last](Y) - points[first](Y);
+                Element  d  = std::sqrt( dx*dx + dy*dy );
+                
+                if ( d != d ) { return 1; }
+                
+                distance = std::max( distance, d );
+            }
+            
+            Element  lines = std::floor( spacing * ( number - 1 ) / distance );   // distanceが0なら∞
+            
+            return  ( lines > 1 ) ? static_cast<std::size_t>( std::min( lines, static_cast<Element>(number) ) ) : 1;
+        }
+        
+        /**
+         * @brief 格子verticesを行列affineで座標変換した後、各ポリラインを間引いて陰線処理をする。
+         *        spacingが正なら、行と列を画面での間隔がspacing以上になるように選び、選んだ線の頂点を最小・最大を保って間引く。
+         *        toleranceが正なら、さらに誤差がtolerance以下になるように頂点を間引く。走査線は幅columnWidthの列ごとに置く。
+         *        走査線と陰線処理の一時的な領域は一時領域から確保し、描画の終わりにまとめて解放する。
+         *        一時領域は、何も確保していない時にframeArenaSize[KB]まで前もって確保する。
+         *///---------------------------------------------------------------------------
+        void  complement( const Matrix & affine,  const GridStore & vertices,  Element columnWidth,  Element tolerance,  Element spacing ) const {
+            
+            transform( affine, vertices, this->projected );
+            
+            this->setPolyLine(vertices);
+            
+            std::size_t  rowNumber    = vertices.getRowNumber();
+            std::size_t  columnNumber = vertices.getColumnNumber();
+            std::size_t  rowStep      = getLineStep( this->projected, rowNumber,    columnNumber,  columnNumber, 1,            spacing );
+            std::size_t  columnStep   = getLineStep( this->projected, columnNumber, 1,             rowNumber,    columnNumber, spacing );
+            
+            this->xPolyLines.reduce( rowStep,    columnStep, tolerance );
+            this->yPolyLines.reduce( columnStep, rowStep,    tolerance );
+            
+            this->arena.resetPeak();
+            this->arena.reserve( static_cast<std::size_t>( std::max( 0, Option::getGraph().frameArenaSize ) ) * 1024 );
+            
+            {
+                ScanLineSet  scanLines( &this->arena );
+                
+                if ( Option::getGraph().isHiddenLine ) {
+                    
+                    switch ( HiddenLineManager::getMethod() ) {
+                        
+                      case HiddenLineManager::SCAN_LINE:
+                        
+                        if ( ( tolerance > 0 || spacing > 0 ) && columnWidth <= 0 ) { scanLines.set( this->getKeptVertices() ); }
+                        else                                                        { scanLines.set( this->projected, columnWidth ); }
+                        break;
+                        
+                      case HiddenLineManager::Z_BUFFER:
+                        
+                        transformDepth( affine, vertices, this->depths );
+                        
+                        this->depthBuffer.set( this->projected, this->depths, vertices.getColumnNumber(),
+                                               VIEW_MINIMUM, VIEW_MAXIMUM - VIEW_MINIMUM, columnWidth );
+                        break;
+                    }
+                }
+                
+                if ( Option::getGraph().isDrawXPolyLines ) { HiddenLineManager( &this->xPolyLines, scanLines, this->depthBuffer, this->arena ); }
+                if ( Option::getGraph().isDrawYPolyLines ) { HiddenLineManager( &this->yPolyLines, scanLines, this->depthBuffer, this->arena ); }
+            }
+            
+            this->arena.reset();
+        }
+        
+        /**
+         * @brief 間引いた後に描くポリラインに残った頂点。
+         *///---------------------------------------------------------------------------
+        PointArray  getKeptVertices(void) const {
+            
+            PointArray  points;
+            
+            if ( Option::getGraph().isDrawXPolyLines ) { this->xPolyLines.appendVertices(points); }
+            if ( Option::getGraph().isDrawYPolyLines ) { this->yPolyLines.appendVertices(points); }
+            
+            return  points;
+        }
+                
+                GridStore       original;
+        mutable GridStore       transformed;
+        mutable VertexPipeline  pipeline;
+        mutable PointArray      projected;
+        mutable PolyLineList    xPolyLines;
+        mutable PolyLineList    yPolyLines;
+        mutable ElementArray    depths;
+        mutable DepthBuffer     depthBuffer;
+        mutable MinMaxManager   minmaxManager;
+                MinMaxManager   bounds;
+                bool            isBounded;
+                Generation      dataGeneration;
+                std::string     binaryPath;
+        mutable Generation      operatedData;
+        mutable Generation      operatedOption;
+        mutable Generation      projectedRange;
+        mutable Generation      projectedOption;
+        mutable Element         projectedColumn;
+        mutable Element         projectedTolerance;
+        mutable Element         projectedSpacing;
+        mutable GridPyramid     pyramid;
+        mutable Generation      pyramidData;
+        mutable int             pyramidStages;
+        mutable int             pyramidBudget;
+        mutable std::size_t     startLevel;
+        mutable std::size_t     level;
+        mutable std::size_t     projectedLevel;
+        mutable FrameArena      arena;
+        mutable LineBatch       batch;
+        mutable LineStyle       batchStyle;
+        mutable bool            isBatched;
+    };
+    
+    
+    /**
+     * @brief グラフ要素を統括するクラス。 
+     *///---------------------------------------------------------------------------
+    class Ploter {
+        
+      public:
+        
+        /**
+         * @brief 軸・目盛・格子・グラフを持つプロッタを生成する。描画先はsetSinkで設定するまで無く、描画しない。
+         *///---------------------------------------------------------------------------
+        Ploter(void) : affineManager( Option("affine"), &this->graph.getMinMaxManager() ), pixelWidth(0) {
+            
+            this->xAxis = makeAxis( "x",        V::X_UNIT, -V::Z_UNIT );
+            this->yAxis = makeAxis( "y",        V::Y_UNIT, -V::Z_UNIT );
+            this->zAxis = makeAxis( "z",  0.5 * V::Z_UNIT, -V::X_UNIT );
+            
+            this->xyGrid = makeGrid( "xy", this->xAxis, this->yAxis );
+            this->xzGrid = makeGrid( "xz", this->xAxis, this->zAxis );
+            this->yzGrid = makeGrid( "yz", this->yAxis, this->zAxis );
+        }
+        
+        /**
+         * @brief 設定する。読み込みに失敗した場合はfalseを返す。
+         *///---------------------------------------------------------------------------
+        bool  set( const char * fileName ) {
+            
+            return  graph.set( fileName );
+        }
+        
+        /**
+         * @brief 陰線処理の一時領域を最後に陰線処理をした描画で同時に使った大きさの最大値[バイト]。
+         *///---------------------------------------------------------------------------
+        std::size_t  getArenaPeak(void) const {
+            
+            return  this->graph.getArenaPeak();
+        }
+        
+        /**
+         * @brief グラフの陰線処理に渡した線分の数。
+         *///---------------------------------------------------------------------------
+        std::size_t  getEdgeNumber(void) const {
+            
+            return  this->graph.getEdgeNumber();
+        }
+        
+        /**
+         * @brief グラフの陰線処理で帯ごとに査定した点の数。
+         *///---------------------------------------------------------------------------
+        std::vector<std::size_t>  getStripLoads(void) const {
+            
+            return  this->graph.getStripLoads();
+        }
+        
+        /**
+         * @brief 描画先をsink_にする。
+         *///---------------------------------------------------------------------------
+        void  setSink( const shared_ptr<RenderSink> & sink_) {
+            
+            this->sink = sink_;
+        }
+        
+        /**
+         * @brief 描画する。
+         *///---------------------------------------------------------------------------
+        void  draw(void) const  {
+            
+            if ( ! this->sink ) { return; }
+            
+            Option::refresh();
+            
+            this->sink->beginFrame( RGBA(1.0, 1.0, 1.0, 1.0), VIEW_MINIMUM, VIEW_MAXIMUM ); {
+                
+                this->guides.clear();
+                
+                this->drawAxis ();
+                this->drawGrid ();
+                
+                this->guides.submit( *this->sink );
+                
+                this->drawGraph();
+                
+            } this->sink->endFrame();
+        }
+        
+        /**
+         * @brief ウィンドウサイズ変化時のビューポートの再設定。
+         *///---------------------------------------------------------------------------
+        void  resize( int width,  int height ) const {
+            
+            if ( ! this->sink ) { return; }
+            
+            int  max   = std::max(width,height);
+            int  min   = std::min(width,height);
+            int  space = (max - min) / 2;
+            
+            if ( min == height ) { this->sink->setViewport( space, 0, min ); }
+            else                 { this->sink->setViewport( 0, space, min ); }
+            
+            this->pixelWidth = ( min > 0 ) ? ( VIEW_MAXIMUM - VIEW_MINIMUM ) / min : 0;
+            
+            this->draw();
+        }
+        
+        /**
+         * @brief グラフを1段細かい格子で描き直す。これ以上細かくしない場合はfalseを返し、描き直さない。
+         *///---------------------------------------------------------------------------
+        bool  refine(void) const {
+            
+            if ( ! this->graph.refine( this->pixelWidth ) ) { return false; }
+            
+            this->draw();
+            
+            return true;
+        }
+        
+        /**
+         * @brief グラフを1段細かい格子にし、描く線分の配列まで作る。これ以上細かくしない場合はfalseを返す。
+         *        描画先を使わないので、描画先を持たないスレッドで呼べる。細かくした格子は次のdrawで描く。
+         *        呼んでいる間は、他のスレッドからこのプロッタを使わないこと。
+         *///---------------------------------------------------------------------------
+        bool  prepareRefine(void) const {
+            
+            if ( ! this->graph.refine( this->pixelWidth ) ) { return false; }
+            
+            this->graph.prepare( getGraphStyle(), &this->affineManager, AffineManager::FOR_GRAPH, this->pixelWidth );
+            
+            return true;
+        }
+        
+      private:
+        
+        /**
+         * @brief 軸の向きがaxisDirection、目盛線の向きがticsDirection、識別名がnameの
+         *        座標軸を生成する。
+         *///---------------------------------------------------------------------------
+        static shared_ptr<Axis>  makeAxis( const std::string & name,  const Vector & axisDirection,
+                                                                      const Vector & ticsDirection ) {
+            
+            Option   axisOption( name +  "Axis" );
+            Option   ticsOption( name +  "Tics" );
+            Option  mticsOption( name + "MTics" );
+            
+            Axis *  axis = new Axis(  axisOption,         axisDirection        );
+            Tics *  tics = new Tics(  ticsOption,  0.04 * ticsDirection,  axis );
+            Tics * mtics = new Tics( mticsOption,  0.02 * ticsDirection,  tics );
+            
+            axis->setChild( tics);
+            tics->setChild(mtics);
+            
+            return shared_ptr<Axis>(axis);
+        }
+        
+        /**
+         * @brief 軸axis1と軸axis2を張る識別名nameのグリッド平面を生成する。
+         *///---------------------------------------------------------------------------
+        static shared_ptr<Grid>  makeGrid( const std::string & name,  const shared_ptr<Axis> axis1,
+                                                                      const shared_ptr<Axis> axis2 ) {
+            
+            Option   gridOption( name +  "Grid" );
+            Option  mgridOption( name + "MGrid" );
+            
+            Grid * grid = new Grid(  gridOption,  axis1->getChild(),
+                                                   axis2->getChild() );
+            Grid * mgrid = new Grid( mgridOption,  axis1->getChild()->getChild(),
+                                                   axis2->getChild()->getChild() );
+            
+            grid->setChild(mgrid);
+            
+            return shared_ptr<Grid>(grid);
+        }
+        
+        /**
+         * @brief 座標軸の線分をguidesに加える。
+         *///---------------------------------------------------------------------------
+        void  drawAxis(void) const {
+            
+            LineStyle  style( RGBA( 0.0,  0.0,  0.0,  1.0 ) );
+            
+            xAxis->draw( this->guides, style, affineManager.get( AffineManager::FOR_X_AXIS ) );
+            yAxis->draw( this->guides, style, affineManager.get( AffineManager::FOR_Y_AXIS ) );
+            zAxis->draw( this->guides, style, affineManager.get( AffineManager::FOR_Z_AXIS ) );
+        }
+        
+        /**
+         * @brief グリッドの線分をguidesに加える。
+         *///---------------------------------------------------------------------------
+        void  drawGrid(void) const {
+            
+            LineStyle  style( RGBA( 0.0,  0.0,  0.0,  0.7 ) );
+            
+            this->xyGrid->draw( this->guides, style, this->affineManager.get( AffineManager::FOR_XY_GRID ) );
+            this->xzGrid->draw( this->guides, style, this->affineManager.get( AffineManager::FOR_XZ_GRID ) );
+            this->yzGrid->draw( this->guides, style, this->affineManager.get( AffineManager::FOR_YZ_GRID ) );
+        }
+        
+        /**
+         * @brief グラフの描画。
+         *///---------------------------------------------------------------------------
+        void  drawGraph(void) const {
+            
+            graph.draw( *this->sink, getGraphStyle(), &this->affineManager, AffineManager::FOR_GRAPH, this->pixelWidth );
+        }
+        
+        /**
+         * @brief グラフの線の描き方。
+         *///---------------------------------------------------------------------------
+        static LineStyle  getGraphStyle(void) {
+            
+            return  LineStyle( RGBA(), LineStyle::SOLID, true );
+        }
+        
+        shared_ptr<Axis>        xAxis;
+        shared_ptr<Axis>        yAxis;
+        shared_ptr<Axis>        zAxis;
+        shared_ptr<Grid>        xyGrid;
+        shared_ptr<Grid>        xzGrid;
+        shared_ptr<Grid>        yzGrid;
+        Graph                   graph;
+        AffineManager           affineManager;
+        shared_ptr<RenderSink>  sink;
+        mutable LineBatch       guides;
+        mutable Element         pixelWidth;
+    };
+}
+#endif
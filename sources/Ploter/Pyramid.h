@@ -0,0 +1,332 @@
+/**
+ * @file   Pyramid.h
+ * @author 村田 裕一
+ * @brief  格子のz値を段階的に粗くした多重解像度の格子(ピラミッド)を定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_PYRAMID_H
+#define  INCLUDED_PYRAMID_H
+
+#include  <deque>
+#include  <string>
+#include  <fstream>
+#include  <cstring>
+#include  <algorithm>
+#include  "Utility.h"
+#include  "Loader.h"
+
+namespace Ploter {
+    
+    /**
+     * @brief ピラミッドのキャッシュファイル(.lod)のヘッダ。
+     *        ヘッダの直後に、元の格子を除く各段の行数・列数の組(unsigned long long)が続き、
+     *        その後に各段のz値(double)を行優先で段の順に並べる。
+     *        fingerprintは元の格子の行数・列数と標本の値から求め、dataStampは書き出した時のデータファイルの更新時刻とサイズから求める。
+     *        どちらも読み込む時に求め直し、キャッシュが元の格子と合うかを確かめる。
+     *///---------------------------------------------------------------------------
+    struct PyramidHeader {
+        
+        enum { VERSION = 3 };
+        
+        char                magic[4];
+        unsigned int        version;
+        unsigned int        levelNumber;
+        unsigned int        reserved;
+        unsigned long long  rowNumber;
+        unsigned long long  columnNumber;
+        unsigned long long  fingerprint;
+        unsigned long long  dataStamp;
+    };
+    
+    const char  PYRAMID_MAGIC[4] = { '3','D','P','\0' };
+    
+    
+    /**
+     * @brief 格子を縦横に半分ずつ粗くした格子の列。0段目は元の格子で、段が1つ増えるごとに、
+     *        LEVEL_MINIMUM_SIZEより大きい行数・列数を半分(切り上げ)にする。
+     *        粗い段は2x2の区画ごとに1つの頂点を置き、その値を区画の代表値とする。
+     *        代表値は、区画に含まれる元の格子の最小値と最大値の和から、細かい段の値の平均を引いた値とする。
+     *        なだらかな区画では平均に近く、孤立した山や谷を含む区画ではその山や谷に近い値になる。
+     *        最小値と最大値は作る間だけ段ごとに持ち、キャッシュファイルには代表値だけを書き込む。
+     *        粗い格子の頂点は、元の格子の範囲に等間隔に置き直す。
+     *        段は格子から作るか、3dgConvertが書き出したキャッシュファイルから読み込む。
+     *///---------------------------------------------------------------------------
+    class GridPyramid {
+        
+      public:
+        
+        enum { LEVEL_MINIMUM_SIZE = 32, FINGERPRINT_SAMPLES = 1024 };
+        
+        GridPyramid(void) : base(0) {}
+        
+        /**
+         * @brief 格子base_から、頂点の数がmaximumNumber以下になるか、それ以上粗くできなくなるまで段を作る。
+         *        base_は次に設定するまで参照する。
+         *///---------------------------------------------------------------------------
+        void  build( const GridStore & base_,  std::size_t maximumNumber ) {
+            
+            this->base = &base_;
+            this->levels.clear();
+            
+            GridStore  minimum;
+            GridStore  maximum;
+            
+            while ( this->getCoarsest().getSize() > maximumNumber ) {
+                
+                const GridStore &  source = this->getCoarsest();
+                
+                if ( source.getRowNumber() <= LEVEL_MINIMUM_SIZE && source.getColumnNumber() <= LEVEL_MINIMUM_SIZE ) { break; }
+                
+                bool       isBase = this->levels.empty();
+                GridStore  nextMinimum;
+                GridStore  nextMaximum;
+                
+                this->levels.push_back( GridStore() );
+                
+                shrink( this->getCoarsest( 1 ), isBase ? base_ : minimum, isBase ? base_ : maximum,
+                        this->levels.back(), nextMinimum, nextMaximum );
+                
+                minimum.swap( nextMinimum );
+                maximum.swap( nextMaximum );
+            }
+        }
+        
+        /**
+         * @brief データファイルpathのキャッシュファイルをマップし、pathから読み込んだ格子base_のピラミッドとする。
+         *        z値はマップした領域を複写せずに参照する。
+         *        キャッシュファイルが無いか、書き出した後にpathが更新されたか、base_と合わない場合はfalseを返し、ピラミッドは変更しない。
+         *///---------------------------------------------------------------------------
+        bool  load( const char * path,  const GridStore & base_) {
+            
+            shared_ptr<MappedFile>  file( new MappedFile );
+            
+            if ( ! file->open( getCachePath(path).c_str() ) || file->getSize() < sizeof(PyramidHeader) ) { return false; }
+            
+            const PyramidHeader *  header = reinterpret_cast<const PyramidHeader *>( file->begin() );
+            
+            if ( std::memcmp( header->magic, PYRAMID_MAGIC, sizeof(PYRAMID_MAGIC) ) != 0 ||
+                 header->version      != PyramidHeader::VERSION                          ||
+                 header->rowNumber    != base_.getRowNumber()                            ||
+                 header->columnNumber != base_.getColumnNumber()                         ||
+                 header->levelNumber   > ( file->getSize() - sizeof(PyramidHeader) ) / ( 2 * sizeof(unsigned long long) ) ||
+                 header->fingerprint  != getFingerprint(base_)                           ||
+                 header->dataStamp    == 0 || header->dataStamp != getFileStamp(path) ) { return false; }
+            
+            const unsigned long long *  sizes  = reinterpret_cast<const unsigned long long *>( file->begin() + sizeof(PyramidHeader) );
+            std::size_t                 offset = sizeof(PyramidHeader) + 2 * sizeof(unsigned long long) * header->levelNumber;
+            std::deque<GridStore>       levels_( header->levelNumber );
+            
+            for ( std::size_t k=0;  k < levels_.size();  k++ ) {
+                
+                unsigned long long  rowNumber    = sizes[ 2 * k     ];
+                unsigned long long  columnNumber = sizes[ 2 * k + 1 ];
+                unsigned long long  number       = rowNumber * columnNumber;
+                
+                if ( rowNumber == 0 || columnNumber == 0 || number / columnNumber != rowNumber ||
+                     number > ( file->getSize() - offset ) / sizeof(Element) ) { return false; }
+                
+                levels_[k].attach( reinterpret_cast<const Element *>( file->begin() + offset ),
+                                   static_cast<std::size_t>(rowNumber), static_cast<std::size_t>(columnNumber), file );
+                
+                offset += static_cast<std::size_t>(number) * sizeof(Element);
+            }
+            
+            this->base = &base_;
+            this->levels.swap(levels_);
+            
+            return true;
+        }
+        
+        /**
+         * @brief ピラミッドを、元の格子を書き込んだデータファイルpathのキャッシュファイルに書き込む。
+         *        pathの更新時刻とサイズを記録するので、pathを書き終えてから呼ぶ。書き込みに失敗した場合はfalseを返す。
+         *///---------------------------------------------------------------------------
+        bool  save( const char * path ) const {
+            
+            PyramidHeader  header;
+            
+            std::memset( &header, 0, sizeof(header) );
+            std::memcpy( header.magic, PYRAMID_MAGIC, sizeof(PYRAMID_MAGIC) );
+            
+            header.version      = PyramidHeader::VERSION;
+            header.levelNumber  = static_cast<unsigned int>( this->levels.size() );
+            header.rowNumber    = this->base->getRowNumber();
+            header.columnNumber = this->base->getColumnNumber();
+            header.fingerprint  = getFingerprint( *this->base );
+            header.dataStamp    = getFileStamp(path);
+            
+            std::ofstream  ofs( getCachePath(path).c_str(), std::ios::binary );
+            
+            ofs.write( reinterpret_cast<const char *>(&header), sizeof(header) );
+            
+            for ( std::size_t k=0;  k < this->levels.size();  k++ ) {
+                
+                unsigned long long  sizes[2] = { this->levels[k].getRowNumber(), this->levels[k].getColumnNumber() };
+                
+                ofs.write( reinterpret_cast<const char *>(sizes), sizeof(sizes) );
+            }
+            
+            for ( std::size_t k=0;  k < this->levels.size();  k++ ) {
+                
+                ofs.write( reinterpret_cast<const char *>( this->levels[k].begin() ), sizeof(Element) * this->levels[k].getSize() );
+            }
+            
+            return  ofs.good();
+        }
+        
+        /**
+         * @brief データファイルpathのピラミッドのキャッシュファイルの名前。
+         *///---------------------------------------------------------------------------
+        static std::string  getCachePath( const std::string & path ) { return path + ".lod"; }
+        
+        /**
+         * @brief 元の格子を含めた段の数。
+         *///---------------------------------------------------------------------------
+        std::size_t  getLevelNumber(void) const { return this->levels.size() + 1; }
+        
+        /**
+         * @brief level段目の格子。
+         *///---------------------------------------------------------------------------
+        const GridStore &  get( std::size_t level ) const { return ( level == 0 ) ? *this->base : this->levels[ level - 1 ]; }
+        
+        /**
+         * @brief 元の格子の頂点(i,j,z)に対する行列affineを、level段目の格子の頂点に対する行列に直す。
+         *///---------------------------------------------------------------------------
+        Matrix  scale( const Matrix & affine,  std::size_t level ) const {
+            
+            Matrix  result = affine;
+            
+            if ( level == 0 ) { return result; }
+            
+            const GridStore &  grid = this->get(level);
+            
+            Element  x = ( grid.getColumnNumber() > 1 ) ? Element( this->base->getColumnNumber() - 1 ) / ( grid.getColumnNumber() - 1 ) : 1;
+            Element  y = ( grid.getRowNumber   () > 1 ) ? Element( this->base->getRowNumber   () - 1 ) / ( grid.getRowNumber   () - 1 ) : 1;
+            
+            for ( Index r=0;  r < 4;  r++ ) {
+                
+                result(r,X) *= x;
+                result(r,Y) *= y;
+            }
+            
+            return result;
+        }
+        
+        /**
+         * @brief 頂点の数がmaximumNumber以下である段のうち、最も細かい段。そのような段が無い場合は最も粗い段。
+         *///---------------------------------------------------------------------------
+        std::size_t  findStartLevel( std::size_t maximumNumber ) const {
+            
+            std::size_t  level = 0;
+            
+            while ( level + 1 < this->getLevelNumber() && this->get(level).getSize() > maximumNumber ) { level++; }
+            
+            return level;
+        }
+        
+        /**
+         * @brief 行数・列数が、どちらも元の格子とnumberの小さい方以上である段のうち、最も粗い段。
+         *///---------------------------------------------------------------------------
+        std::size_t  findLevel( std::size_t number ) const {
+            
+            std::size_t  rowNumber    = std::min( this->base->getRowNumber   (), number );
+            std::size_t  columnNumber = std::min( this->base->getColumnNumber(), number );
+            std::size_t  level        = 0;
+            
+            while ( level + 1 < this->getLevelNumber() && this->get( level + 1 ).getRowNumber   () >= rowNumber
+                                                       && this->get( level + 1 ).getColumnNumber() >= columnNumber ) { level++; }
+            
+            return level;
+        }
+        
+      private:
+        
+        /**
+         * @brief 粗い方からk+1番目の段の格子。
+         *///---------------------------------------------------------------------------
+        const GridStore &  getCoarsest( std::size_t k = 0 ) const { return this->get( this->levels.size() - k ); }
+        
+        /**
+         * @brief sourceの頂点を縦横に2つずつまとめた区画ごとに、代表値をtargetに、最小値と最大値をtargetMinimumとtargetMaximumに求める。
+         *        sourceMinimumとsourceMaximumは、sourceの各頂点が表す元の格子の範囲の最小値と最大値。
+         *        行数・列数がLEVEL_MINIMUM_SIZE以下の方向はまとめない。
+         *        どの値も有限の値から求め、有限の値がなければ区画の先頭の値とする。
+         *///---------------------------------------------------------------------------
+        static void  shrink( const GridStore & source,  const GridStore & sourceMinimum,  const GridStore & sourceMaximum,
+                             GridStore & target,  GridStore & targetMinimum,  GridStore & targetMaximum ) {
+            
+            std::size_t  rowStep    = ( source.getRowNumber   () > LEVEL_MINIMUM_SIZE ) ? 2 : 1;
+            std::size_t  columnStep = ( source.getColumnNumber() > LEVEL_MINIMUM_SIZE ) ? 2 : 1;
+            
+            target.resize( ( source.getRowNumber   () + rowStep    - 1 ) / rowStep,
+                           ( source.getColumnNumber() + columnStep - 1 ) / columnStep );
+            
+            targetMinimum.resize( target.getRowNumber(), target.getColumnNumber() );
+            targetMaximum.resize( target.getRowNumber(), target.getColumnNumber() );
+            
+            for ( Index j=0;  j < target.getRowNumber();  j++ ) {
+                
+                Index  j1 = std::min( ( j + 1 ) * rowStep, source.getRowNumber() );
+                
+                for ( Index i=0;  i < target.getColumnNumber();  i++ ) {
+                    
+                    Index  i1 = std::min( ( i + 1 ) * columnStep, source.getColumnNumber() );
+                    
+                    Element      first   = source( j * rowStep, i * columnStep );
+                    Element      minimum = first;
+                    Element      maximum = first;
+                    Element      sum     = 0;
+                    std::size_t  number  = 0;
+                    
+                    for ( Index jj = j * rowStep;  jj < j1;  jj++ ) {
+                        
+                        for ( Index ii = i * columnStep;  ii < i1;  ii++ ) {
+                            
+                            Element  value = source       ( jj, ii );
+                            Element  low   = sourceMinimum( jj, ii );
+                            Element  high  = sourceMaximum( jj, ii );
+                            
+                            if ( !( value - value == 0 && low - low == 0 && high - high == 0 ) ) { continue; }   // NaNと∞は除く。
+                            
+                            if ( number == 0 || low  < minimum ) { minimum = low;  }
+                            if ( number == 0 || high > maximum ) { maximum = high; }
+                            
+                            sum += value;
+                            number++;
+                        }
+                    }
+                    
+                    target       ( j, i ) = ( number > 0 ) ? minimum + maximum - sum / number : first;
+                    targetMinimum( j, i ) = minimum;
+                    targetMaximum( j, i ) = maximum;
+                }
+            }
+        }
+        
+        /**
+         * @brief 格子gridの行数・列数と、等間隔に選んだFINGERPRINT_SAMPLES個の値のハッシュ値(FNV-1a)。
+         *///---------------------------------------------------------------------------
+        static unsigned long long  getFingerprint( const GridStore & grid ) {
+            
+            unsigned long long  hash = 14695981039346656037ULL;
+            unsigned long long  size = grid.getSize();
+            unsigned long long  keys[2] = { grid.getRowNumber(), grid.getColumnNumber() };
+            
+            const unsigned char *  p = reinterpret_cast<const unsigned char *>(keys);
+            
+            for ( std::size_t k=0;  k < sizeof(keys);  k++ ) { hash = ( hash ^ p[k] ) * 1099511628211ULL; }
+            
+            for ( unsigned long long n=0;  size > 0 && n < FINGERPRINT_SAMPLES;  n++ ) {
+                
+                const unsigned char *  q = reinterpret_cast<const unsigned char *>( grid.begin() + ( size - 1 ) * n / ( FINGERPRINT_SAMPLES - 1 ) );
+                
+                for ( std::size_t k=0;  k < sizeof(Element);  k++ ) { hash = ( hash ^ q[k] ) * 1099511628211ULL; }
+            }
+            
+            return hash;
+        }
+        
+        const GridStore *      base;
+        std::deque<GridStore>  levels;
+    };
+}
+#endif
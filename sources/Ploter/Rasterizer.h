@@ -0,0 +1,623 @@
+/**
+ * @file   Rasterizer.h
+ * @author 村田 裕一
+ * @brief  線分をメモリ上の画像に描く、ソフトウェアによる描画先を定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_RASTERIZER_H
+#define  INCLUDED_RASTERIZER_H
+
+#include  <vector>
+#include  <cmath>
+#include  <algorithm>
+#include  "RenderSink.h"
+#include  "Thread.h"
+
+namespace Ploter {
+    
+    /**
+     * @brief 線分をつなぐ場合に許す、間の頂点からつないだ線分までの距離[画素]。
+     *///---------------------------------------------------------------------------
+    const float  MERGE_TOLERANCE = 0.125f;
+    
+    /**
+     * @brief 線分をRGBA各8ビットの画像に描く描画先。ウィンドウやOpenGLを使わない。
+     *        線分は画像を区切ったタイルに振り分け、タイルごとに別のスレッドで描く。
+     *        タイルの中では受け取った順に描くので、重なりの結果はOpenGLと同じ順になる。
+     *        滑らかな線は幅1画素の線が画素を覆う割合を不透明度に掛け、glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA )と同じく合成する。
+     *        破線の模様は線分ごとに始点から数え、主軸方向の1画素ごとに1ビット使う。
+     *///---------------------------------------------------------------------------
+    class SoftwareRenderSink : public RenderSink {
+        
+      public:
+        
+        /**
+         * @brief 線分を描くタイルの1辺[画素]と、まとめて描く線分の数。
+         *///---------------------------------------------------------------------------
+        enum { TILE_SIZE = 64, FLUSH_SIZE = 1 << 20 };
+        
+        /**
+         * @brief 幅width_・高さheight_の画像に、threadNumber_個のスレッドで描く描画先を生成する。
+         *        threadNumber_が0の場合はプロセッサの数だけスレッドを使う。
+         *///---------------------------------------------------------------------------
+        SoftwareRenderSink( int width_,  int height_,  std::size_t threadNumber_ = 0 ) :
+            
+            width( std::max( width_, 0 ) ), height( std::max( height_, 0 ) ), threadNumber( threadNumber_),
+            pixels( 4 * width * height, 255 ), viewportX(0), viewportY(0), viewportSize( std::min( width, height ) ),
+            minimum(0), scale(1), chunkNumber(0)
+        {
+            this->columnNumber = ( this->width  + TILE_SIZE - 1 ) / TILE_SIZE;
+            this->rowNumber    = ( this->height + TILE_SIZE - 1 ) / TILE_SIZE;
+        }
+        
+        int  getWidth (void) const { return this->width;  }
+        int  getHeight(void) const { return this->height; }
+        
+        /**
+         * @brief 画像の画素。上の行から順に、1画素につきR・G・B・Aの4バイトを並べる。
+         *///---------------------------------------------------------------------------
+        const std::vector<unsigned char> &  getPixels(void) const { return this->pixels; }
+        
+        /**
+         * @brief 画像の左下(x,y)から1辺sizeの正方形に描く。単位は画素。
+         *///---------------------------------------------------------------------------
+        void  setViewport( int x,  int y,  int size ) {
+            
+            this->viewportX    = x;
+            this->viewportY    = y;
+            this->viewportSize = size;
+        }
+        
+        /**
+         * @brief 画像全体を背景の色で塗る。
+         *///---------------------------------------------------------------------------
+        void  beginFrame( const RGBA & background,  Element minimum_,  Element maximum_) {
+            
+            unsigned char  color[4] = { toByte( background.r ), toByte( background.g ), toByte( background.b ), toByte( background.a ) };
+            
+            for ( std::size_t k=0;  k < this->pixels.size();  k++ ) { this->pixels[k] = color[ k % 4 ]; }
+            
+            this->minimum = minimum_;
+            this->scale   = ( maximum_ > minimum_ ) ? this->viewportSize / ( maximum_ - minimum_ ) : 0;
+            
+            this->segments.clear();
+            this->styles  .clear();
+        }
+        
+        /**
+         * @brief 線分を画像の座標に直して溜める。溜まった線分がFLUSH_SIZEに達したら、途中でも描く。
+         *        実線では、前の線分の終点から始まる線分は、曲がりがMERGE_TOLERANCE画素以内の間は前の線分とつないで1本にする。
+         *        細かい格子では画素より短い線分がほぼ真っ直ぐに続き、描く手間は線分の数に比例するので、振り分ける前に減らす。
+         *///---------------------------------------------------------------------------
+        void  drawLines( const PointArray & points,  const LineStyle & style ) {
+            
+            if ( points.size() < 2 ) { return; }
+            
+            if ( this->styles.size() > 0xFFFF ) { this->flush(); }
+            
+            if ( this->styles.empty() || this->styles.back() != style ) { this->styles.push_back(style); }
+            
+            Chain  chain;
+            bool   isMerged = ( style.stipple == LineStyle::SOLID );   // 破線の模様は線分ごとに数えるので、つながない。
+            
+            for ( std::size_t k=0;  k+1 < points.size();  k += 2 ) {
+                
+                Segment  segment;
+                
+                segment.x1    = this->toX( points[k  ](X) );
+                segment.y1    = this->toY( points[k  ](Y) );
+                segment.x2    = this->toX( points[k+1](X) );
+                segment.y2    = this->toY( points[k+1](Y) );
+                segment.style = 0;
+                
+                if ( !( segment.x1 - segment.x1 == 0 && segment.y1 - segment.y1 == 0 &&
+                        segment.x2 - segment.x2 == 0 && segment.y2 - segment.y2 == 0 ) ) { continue; }   // NaNと∞は描かない。
+                
+                if ( isMerged && chain.isFollowed( segment ) && chain.extend( segment.x2, segment.y2 ) ) { continue; }
+                
+                if ( chain.isOpen() ) { this->pushSegment( chain.get(), style ); }
+                
+                chain.start(segment);
+            }
+            
+            if ( chain.isOpen() ) { this->pushSegment( chain.get(), style ); }
+        }
+        
+        /**
+         * @brief 溜めた線分を全て描く。
+         *///---------------------------------------------------------------------------
+        void  endFrame(void) {
+            
+            this->flush();
+        }
+        
+      private:
+        
+        /**
+         * @brief 画像の座標(左上が原点、yは下向き)で表した線分。
+         *///---------------------------------------------------------------------------
+        struct Segment {
+            
+            float           x1;
+            float           y1;
+            float           x2;
+            float           y2;
+            unsigned short  style;
+        };
+        
+        /**
+         * @brief 始点から順につないだ線分。つないだ間の頂点は、つないだ線分からおよそMERGE_TOLERANCE画素以内に収める。
+         *        許す向きは間の頂点ごとに始点から見た扇形で、全ての扇形の共通部分を両端の向きlowとhighで持つ。
+         *///---------------------------------------------------------------------------
+        class Chain {
+            
+          public:
+            
+            Chain(void) : isStarted(false), isBounded(false), reach(0) {}
+            
+            bool             isOpen(void) const { return this->isStarted; }
+            const Segment &  get   (void) const { return this->segment;   }
+            
+            /**
+             * @brief segment_から始める。
+             *///---------------------------------------------------------------------------
+            void  start( const Segment & segment_) {
+                
+                this->segment   = segment_;
+                this->isStarted = true;
+                this->isBounded = false;
+                this->reach     = 0;
+            }
+            
+            /**
+             * @brief segment_が終点から始まるかどうか。
+             *///---------------------------------------------------------------------------
+            bool  isFollowed( const Segment & segment_) const {
+                
+                return  this->isStarted && segment_.x1 == this->segment.x2 && segment_.y1 == this->segment.y2;
+            }
+            
+            /**
+             * @brief 終点から(x,y)までの線分をつなぐ。つなぐと今の終点を含む間の頂点が離れすぎる場合はつながない。
+             *///---------------------------------------------------------------------------
+            bool  extend( float x,  float y ) {
+                
+                float  dx = this->segment.x2 - this->segment.x1,  dy = this->segment.y2 - this->segment.y1;   // 間に入る今の終点
+                float  cx = x - this->segment.x1,                 cy = y - this->segment.y1;                  // つないだ線分
+                float  r2 = dx*dx + dy*dy;
+                
+                float  lowX  = this->lowX,   lowY  = this->lowY;
+                float  highX = this->highX,  highY = this->highY;
+                bool   isBounded_ = this->isBounded;
+                float  reach_     = this->reach;
+                
+                if ( r2 > MERGE_TOLERANCE * MERGE_TOLERANCE ) {   // 始点に近い頂点は向きに依らず収まる。
+                    
+                    float  r = std::sqrt(r2);
+                    float  s = MERGE_TOLERANCE / r,  c = std::sqrt( 1 - s*s );
+                    float  ax = dx*c + dy*s,  ay = dy*c - dx*s;   // 頂点の向きを扇形の半分だけ時計回りに回した向き
+                    float  bx = dx*c - dy*s,  by = dy*c + dx*s;   // 反時計回りに回した向き
+                    
+                    if ( ! isBounded_ || cross( lowX,  lowY,  ax, ay ) > 0 ) { lowX  = ax;  lowY  = ay; }
+                    if ( ! isBounded_ || cross( highX, highY, bx, by ) < 0 ) { highX = bx;  highY = by; }
+                    
+                    isBounded_ = true;
+                    
+                    reach_ = std::max( reach_, r );
+                }
+                
+                if ( isBounded_ && !( cross( lowX, lowY, highX, highY ) >= 0 &&
+                                      lowX*cx  + lowY*cy  > 0 && cross( lowX, lowY, cx, cy )   >= 0 &&
+                                      highX*cx + highY*cy > 0 && cross( cx, cy, highX, highY ) >= 0 ) ) { return false; }
+                
+                if ( cx*cx + cy*cy < ( reach_ - MERGE_TOLERANCE ) * ( reach_ - MERGE_TOLERANCE ) ) { return false; }   // 引き返す場合
+                
+                this->segment.x2 = x;
+                this->segment.y2 = y;
+                this->lowX       = lowX;   this->lowY  = lowY;
+                this->highX      = highX;  this->highY = highY;
+                this->isBounded  = isBounded_;
+                this->reach      = reach_;
+                
+                return  true;
+            }
+            
+          private:
+            
+            static float  cross( float x1,  float y1,  float x2,  float y2 ) { return x1 * y2 - y1 * x2; }
+            
+            Segment  segment;
+            bool     isStarted;
+            bool     isBounded;
+            float    lowX;
+            float    lowY;
+            float    highX;
+            float    highY;
+            float    reach;
+        };
+        
+        /**
+         * @brief 線分segmentを描く線分に加える。溜まった線分がFLUSH_SIZEに達していたら、先に描く。
+         *///---------------------------------------------------------------------------
+        void  pushSegment( Segment segment,  const LineStyle & style ) {
+            
+            if ( this->segments.size() >= FLUSH_SIZE ) {
+                
+                this->flush();
+                this->styles.push_back(style);
+            }
+            
+            segment.style = static_cast<unsigned short>( this->styles.size() - 1 );
+            
+            this->segments.push_back(segment);
+        }
+        
+        /**
+         * @brief parallelForで番号ごとにメンバ関数methodを呼ぶ。塊ごとの振り分けとタイルごとの描画に使う。
+         *///---------------------------------------------------------------------------
+        class Task {
+            
+          public:
+            
+            typedef void ( SoftwareRenderSink::*Method )( std::size_t );
+            
+            Task( SoftwareRenderSink & sink_,  Method method_) : sink( sink_), method( method_) {}
+            
+            void  operator ()( std::size_t k ) { ( this->sink.*this->method )(k); }
+            
+          private:
+            
+            SoftwareRenderSink &  sink;
+            Method                method;
+        };
+        
+        friend class Task;
+        
+        /**
+         * @brief 溜めた線分をタイルに振り分けてから、タイルごとに別のスレッドで描く。
+         *        振り分けは各タイルの線分の番号を受け取った順に1つの配列に詰め、タイルごとの区切りを持つ。
+         *        線分は受け取った順にスレッドの数の塊に分け、塊ごとに別のスレッドで数えてから詰める。
+         *        タイルの中では塊の順に詰めるので、受け取った順は変わらない。
+         *        スレッドが1つの場合は振り分けずに、受け取った順に画像全体へ描く。画素ごとの合成の順は変わらない。
+         *///---------------------------------------------------------------------------
+        void  flush(void) {
+            
+            if ( this->segments.empty() ) { this->styles.clear();  return; }
+            
+            this->paints.resize( this->styles.size() );
+            
+            for ( std::size_t k=0;  k < this->styles.size();  k++ ) { this->paints[k] = toPaint( this->styles[k].color ); }
+            
+            std::size_t  tileNumber = this->columnNumber * this->rowNumber;
+            std::size_t  threads    = ( this->threadNumber == 0 ) ? getProcessorNumber() : this->threadNumber;
+            
+            if ( threads <= 1 || tileNumber <= 1 ) {
+                
+                for ( std::size_t k=0;  k < this->segments.size();  k++ ) { this->rasterize( this->segments[k], 0, 0, this->width, this->height ); }
+                
+                this->segments.clear();
+                this->styles  .clear();
+                
+                return;
+            }
+            
+            this->chunkNumber = std::min( threads, this->segments.size() );
+            
+            this->chunkFills.assign( this->chunkNumber * tileNumber, 0 );
+            this->tileRanges.resize( this->segments.size() );
+            
+            Task  counter( *this, &SoftwareRenderSink::countChunk );
+            
+            parallelFor( this->chunkNumber, counter, threads );
+            
+            // タイルごとに塊の順に数を足し、各塊が詰め始める位置に置き換える。
+            this->tileOffsets.resize( tileNumber + 1 );
+            
+            std::size_t  offset = 0;
+            
+            for ( std::size_t t=0;  t < tileNumber;  t++ ) {
+                
+                this->tileOffsets[t] = offset;
+                
+                for ( std::size_t c=0;  c < this->chunkNumber;  c++ ) {
+                    
+                    std::size_t &  fill  = this->chunkFills[ c * tileNumber + t ];
+                    std::size_t    count = fill;
+                    
+                    fill    = offset;
+                    offset += count;
+                }
+            }
+            
+            this->tileOffsets[tileNumber] = offset;
+            this->tileSegments.resize(offset);
+            
+            Task  filler    ( *this, &SoftwareRenderSink::fillChunk     );
+            Task  rasterizer( *this, &SoftwareRenderSink::rasterizeTile );
+            
+            parallelFor( this->chunkNumber, filler,     threads );
+            parallelFor( tileNumber,        rasterizer, threads );
+            
+            this->segments.clear();
+            this->styles  .clear();
+        }
+        
+        /**
+         * @brief 塊chunkの線分の番号の範囲[first,last)を求める。
+         *///---------------------------------------------------------------------------
+        void  getChunk( std::size_t chunk,  std::size_t & first,  std::size_t & last ) const {
+            
+            first = this->segments.size() *   chunk       / this->chunkNumber;
+            last  = this->segments.size() * ( chunk + 1 ) / this->chunkNumber;
+        }
+        
+        /**
+         * @brief 塊chunkの線分が掛かるタイルの範囲を求め、タイルごとの線分の数を数える。
+         *///---------------------------------------------------------------------------
+        void  countChunk( std::size_t chunk ) {
+            
+            std::size_t    first, last;
+            std::size_t *  counts = &this->chunkFills[ chunk * this->columnNumber * this->rowNumber ];
+            
+            this->getChunk( chunk, first, last );
+            
+            for ( std::size_t k=first;  k < last;  k++ ) {
+                
+                TileRange &  range = this->tileRanges[k];
+                
+                this->getTileRange( this->segments[k], range );
+                
+                for ( int r=range.firstRow;  r <= range.lastRow;  r++ ) {
+                    
+                    for ( int c=range.firstColumn;  c <= range.lastColumn;  c++ ) { counts[ r * this->columnNumber + c ]++; }
+                }
+            }
+        }
+        
+        /**
+         * @brief 塊chunkの線分の番号を、掛かるタイルごとに受け取った順に詰める。
+         *///---------------------------------------------------------------------------
+        void  fillChunk( std::size_t chunk ) {
+            
+            std::size_t    first, last;
+            std::size_t *  fills = &this->chunkFills[ chunk * this->columnNumber * this->rowNumber ];
+            
+            this->getChunk( chunk, first, last );
+            
+            for ( std::size_t k=first;  k < last;  k++ ) {
+                
+                const TileRange &  range = this->tileRanges[k];
+                
+                for ( int r=range.firstRow;  r <= range.lastRow;  r++ ) {
+                    
+                    for ( int c=range.firstColumn;  c <= range.lastColumn;  c++ ) {
+                        
+                        this->tileSegments[ fills[ r * this->columnNumber + c ]++ ] = static_cast<unsigned int>(k);
+                    }
+                }
+            }
+        }
+        
+        /**
+         * @brief 線分が掛かり得るタイルの範囲。画像の外にある場合は空の範囲にする。
+         *///---------------------------------------------------------------------------
+        struct TileRange {
+            
+            int  firstColumn;
+            int  lastColumn;
+            int  firstRow;
+            int  lastRow;
+        };
+        
+        /**
+         * @brief 線分sが掛かり得るタイルの範囲をrangeに求める。
+         *///---------------------------------------------------------------------------
+        void  getTileRange( const Segment & s,  TileRange & range ) const {
+            
+            float  left   = std::min( s.x1, s.x2 ) - 2,  right  = std::max( s.x1, s.x2 ) + 2;
+            float  top    = std::min( s.y1, s.y2 ) - 2,  bottom = std::max( s.y1, s.y2 ) + 2;
+            
+            if ( right < 0 || bottom < 0 || left >= this->width || top >= this->height ) {
+                
+                range.firstColumn = range.firstRow = 0;
+                range.lastColumn  = range.lastRow  = -1;
+                
+                return;
+            }
+            
+            range.firstColumn = toIndex( left,   0, this->width  - 1 ) / TILE_SIZE;
+            range.firstRow    = toIndex( top,    0, this->height - 1 ) / TILE_SIZE;
+            range.lastColumn  = toIndex( right,  0, this->width  - 1 ) / TILE_SIZE;
+            range.lastRow     = toIndex( bottom, 0, this->height - 1 ) / TILE_SIZE;
+        }
+        
+        /**
+         * @brief タイルtileに振り分けた線分を順に描く。
+         *///---------------------------------------------------------------------------
+        void  rasterizeTile( std::size_t tile ) {
+            
+            int  left   = static_cast<int>( tile % this->columnNumber ) * TILE_SIZE;
+            int  top    = static_cast<int>( tile / this->columnNumber ) * TILE_SIZE;
+            int  right  = std::min( left + TILE_SIZE, this->width  );
+            int  bottom = std::min( top  + TILE_SIZE, this->height );
+            
+            for ( std::size_t k=this->tileOffsets[tile];  k < this->tileOffsets[tile+1];  k++ ) {
+                
+                this->rasterize( this->segments[ this->tileSegments[k] ], left, top, right, bottom );
+            }
+        }
+        
+        /**
+         * @brief 線分sを、画素の範囲[left,right)×[top,bottom)の中だけ線分の描き方で描く。
+         *        主軸(変化の大きい方の軸)の1画素ごとに、副軸の線の近くの画素を調べる。
+         *        画素ごとの値は範囲の取り方に依らず同じになるように、途中の値を積み上げずに画素の位置から求める。
+         *///---------------------------------------------------------------------------
+        void  rasterize( const Segment & s,  int left,  int top,  int right,  int bottom ) {
+            
+            float  dx = s.x2 - s.x1;
+            float  dy = s.y2 - s.y1;
+            
+            if ( dx == 0 && dy == 0 ) { return; }
+            
+            const LineStyle &  style = this->styles[ s.style ];
+            const Paint &      paint = this->paints[ s.style ];
+            
+            bool   isXMajor = std::fabs(dx) >= std::fabs(dy);
+            float  u1 = isXMajor ? s.x1 : s.y1,  v1 = isXMajor ? s.y1 : s.x1;
+            float  du = isXMajor ? dx   : dy,    dv = isXMajor ? dy   : dx;
+            
+            int    uFirst = isXMajor ? left  : top,     vFirst = isXMajor ? top    : left;
+            int    uLast  = isXMajor ? right : bottom,  vLast  = isXMajor ? bottom : right;
+            
+            std::ptrdiff_t  uStep = isXMajor ? 4 : 4 * static_cast<std::ptrdiff_t>( this->width );
+            std::ptrdiff_t  vStep = isXMajor ? 4 * static_cast<std::ptrdiff_t>( this->width ) : 4;
+            unsigned char * origin = &this->pixels[0];
+            
+            float  length  = std::sqrt( dx*dx + dy*dy );
+            float  slope   = dv / du;
+            float  inverse = std::fabs(du) / length;   // 線からの距離が1未満になる副軸方向の幅の半分の逆数
+            float  reach   = 1 / inverse;
+            float  uMin    = std::min( u1, u1 + du ),  uMax = std::max( u1, u1 + du );
+            float  uAlong  = du / length,  vAlong = dv / length;
+            float  vReverse = ( vAlong != 0 ) ? 1 / vAlong : 0;
+            
+            // 端から線に沿って0.5を超えて離れた画素は覆わないので、滑らかな線は主軸方向にその分だけ広げて調べる。
+            float  margin = style.isSmooth ? std::min( 1.0f, ( 0.5f + std::fabs(slope) ) * inverse ) : 0.0f;
+            int    first  =  toIndex(   uMin - margin,  uFirst, uLast );
+            int    last   = -toIndex( -(uMax + margin), -uLast, -uFirst );
+            bool   isSolid = style.stipple == LineStyle::SOLID;
+            
+            for ( int u=first;  u < last;  u++ ) {
+                
+                float  uc = u + 0.5f;
+                
+                if ( ! style.isSmooth && !( uMin <= uc && uc < uMax ) ) { continue; }
+                
+                unsigned int  bit = static_cast<unsigned int>( std::fabs( uc - u1 ) ) & 15;
+                
+                if ( ! isSolid && !( style.stipple >> bit & 1 ) ) { continue; }
+                
+                float  vLine = v1 + slope * ( uc - u1 );
+                
+                if ( ! style.isSmooth ) {
+                    
+                    int  v = toIndex( vLine, vFirst - 1, vLast );
+                    
+                    if ( vFirst <= v && v < vLast ) { blend( origin + u * uStep + v * vStep, paint, 1 ); }
+                    
+                    continue;
+                }
+                
+                float  base   = ( uc - u1 ) * uAlong - v1 * vAlong;
+                float  low    = vLine - reach,  high = vLine + reach;
+                
+                if ( vAlong != 0 ) {    // 線に沿った位置が両端から0.5の内側に入る範囲に絞る。境界の丸めの違いは内側の判定に任せる。
+                    
+                    float  a = ( -0.5f - base ) * vReverse,  b = ( length + 0.5f - base ) * vReverse;
+                    
+                    low  = std::max( low,  std::min( a, b ) - 1e-3f );
+                    high = std::min( high, std::max( a, b ) + 1e-3f );
+                }
+                
+                int    vBegin = -toIndex( -(low - 0.5f), -vLast, -vFirst );
+                int    vEnd   =  toIndex(   high - 0.5f,  vFirst - 1, vLast - 1 ) + 1;
+                
+                unsigned char *  pixel = origin + u * uStep + vBegin * vStep;
+                
+                for ( int v=vBegin;  v < vEnd;  v++, pixel += vStep ) {
+                    
+                    float  vc       = v + 0.5f;
+                    float  distance = std::fabs( vc - vLine ) * inverse;
+                    
+                    if ( distance >= 1 ) { continue; }
+                    
+                    float  along = base + vc * vAlong;
+                    float  ends  = std::min( along, length - along ) + 0.5f;
+                    
+                    if ( ends <= 0 ) { continue; }
+                    
+                    blend( pixel, paint, ( 1 - distance ) * std::min( 1.0f, ends ) );
+                }
+            }
+        }
+        
+        /**
+         * @brief 合成に使う色。R・G・Bは0～255、不透明度は0～1。
+         *///---------------------------------------------------------------------------
+        struct Paint {
+            
+            float  r;
+            float  g;
+            float  b;
+            float  a;
+        };
+        
+        static Paint  toPaint( const RGBA & color ) {
+            
+            Paint  paint = { static_cast<float>( 255 * color.r ), static_cast<float>( 255 * color.g ),
+                             static_cast<float>( 255 * color.b ), static_cast<float>(       color.a ) };
+            
+            return  paint;
+        }
+        
+        /**
+         * @brief 画素pixelに色paintを、不透明度に覆う割合coverageを掛けて合成する。
+         *///---------------------------------------------------------------------------
+        static void  blend( unsigned char * pixel,  const Paint & paint,  float coverage ) {
+            
+            float  alpha = paint.a * coverage;
+            
+            pixel[0] = static_cast<unsigned char>( pixel[0] + ( paint.r - pixel[0] ) * alpha + 0.5f );
+            pixel[1] = static_cast<unsigned char>( pixel[1] + ( paint.g - pixel[1] ) * alpha + 0.5f );
+            pixel[2] = static_cast<unsigned char>( pixel[2] + ( paint.b - pixel[2] ) * alpha + 0.5f );
+            pixel[3] = static_cast<unsigned char>( pixel[3] + ( 255     - pixel[3] ) * alpha + 0.5f );
+        }
+        
+        /**
+         * @brief 表示範囲の座標を画像の座標に直す。画像のyは下向き。
+         *///---------------------------------------------------------------------------
+        float  toX( Element x ) const { return static_cast<float>( this->viewportX + ( x - this->minimum ) * this->scale ); }
+        float  toY( Element y ) const { return static_cast<float>( this->height - this->viewportY - ( y - this->minimum ) * this->scale ); }
+        
+        /**
+         * @brief valueを切り捨てた整数を[minimum,maximum]に収めて返す。
+         *///---------------------------------------------------------------------------
+        static int  toIndex( float value,  int minimum,  int maximum ) {
+            
+            if ( !( value > minimum ) ) { return minimum; }
+            if ( !( value < maximum ) ) { return maximum; }
+            
+            int  index = static_cast<int>(value);
+            
+            return  ( value < index ) ? index - 1 : index;
+        }
+        
+        /**
+         * @brief [0,1]の値を0～255に直す。
+         *///---------------------------------------------------------------------------
+        static unsigned char  toByte( double value ) {
+            
+            return  static_cast<unsigned char>( std::max( 0.0, std::min( 1.0, value ) ) * 255 + 0.5 );
+        }
+        
+        int                          width;
+        int                          height;
+        std::size_t                  threadNumber;
+        std::vector<unsigned char>   pixels;
+        int                          viewportX;
+        int                          viewportY;
+        int                          viewportSize;
+        Element                      minimum;
+        Element                      scale;
+        std::size_t                  columnNumber;
+        std::size_t                  rowNumber;
+        std::vector<Segment>         segments;
+        std::vector<LineStyle>       styles;
+        std::vector<Paint>           paints;
+        std::vector<TileRange>       tileRanges;
+        std::vector<std::size_t>     tileOffsets;
+        std::size_t                  chunkNumber;
+        std::vector<std::size_t>     chunkFills;
+        std::vector<unsigned int>    tileSegments;
+    };
+}
+#endif
@@ -0,0 +1,187 @@
+/**
+ * @file   RenderSink.h
+ * @author 村田 裕一
+ * @brief  線分の描画先のインターフェースを定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_RENDER_SINK_H
+#define  INCLUDED_RENDER_SINK_H
+
+#include  <vector>
+#include  <deque>
+#include  "Utility.h"
+
+namespace Ploter {
+    
+    /**
+     * @brief 色を表すクラス。
+     *///---------------------------------------------------------------------------
+    class RGBA {
+        
+      public:
+        
+        /**
+         * @brief 赤r_、緑g_、青b_、不透明度a_の色を生成する。各成分は[0,1]。
+         *///---------------------------------------------------------------------------
+        RGBA( double r_ = 0.0, double g_ = 0.0, double b_ = 0.0, double a_ = 1.0 ) :
+            
+            r( r_), g( g_), b( b_), a( a_)
+        {}
+        
+        double  r;
+        double  g;
+        double  b;
+        double  a;
+    };
+    
+    
+    /**
+     * @brief 線分の描き方。色(不透明度を含む)、破線の模様、滑らかにするかどうか。
+     *        破線の模様は16ビットで、1画素ごとに下位のビットから順に使う。
+     *///---------------------------------------------------------------------------
+    class LineStyle {
+        
+      public:
+        
+        enum { SOLID = 0xFFFF };
+        
+        LineStyle( const RGBA & color_ = RGBA(),  unsigned short stipple_ = SOLID,  bool isSmooth_ = false ) :
+            
+            color( color_), stipple( stipple_), isSmooth( isSmooth_)
+        {}
+        
+        RGBA            color;
+        unsigned short  stipple;
+        bool            isSmooth;
+    };
+    
+    inline bool  operator ==( const RGBA & a,  const RGBA & b ) {
+        
+        return  a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+    
+    inline bool  operator ==( const LineStyle & a,  const LineStyle & b ) {
+        
+        return  a.color == b.color && a.stipple == b.stipple && a.isSmooth == b.isSmooth;
+    }
+    
+    inline bool  operator !=( const LineStyle & a,  const LineStyle & b ) {
+        
+        return  !( a == b );
+    }
+    
+    
+    /**
+     * @brief 線分の描画先。画面の座標で表した線分の列を、描き方ごとにまとめて受け取る。
+     *        1回の描画はbeginFrameで始め、endFrameで終える。
+     *///---------------------------------------------------------------------------
+    class RenderSink {
+        
+      public:
+        
+        virtual ~RenderSink(void) {}
+        
+        /**
+         * @brief 描画先の左下(x,y)から1辺sizeの正方形に描く。単位は画素。
+         *///---------------------------------------------------------------------------
+        virtual void  setViewport( int x,  int y,  int size ) = 0;
+        
+        /**
+         * @brief 背景をbackgroundで塗り、x・yともに[minimum,maximum]の範囲を描く1回の描画を始める。
+         *///---------------------------------------------------------------------------
+        virtual void  beginFrame( const RGBA & background,  Element minimum,  Element maximum ) = 0;
+        
+        /**
+         * @brief 点を2つずつ組にした線分の列pointsを、styleで描く。
+         *///---------------------------------------------------------------------------
+        virtual void  drawLines( const PointArray & points,  const LineStyle & style ) = 0;
+        
+        /**
+         * @brief 1回の描画を終える。
+         *///---------------------------------------------------------------------------
+        virtual void  endFrame(void) = 0;
+    };
+    
+    
+    /**
+     * @brief 線分を描き方ごとに1つの配列にまとめ、描画先へ描き方ごとに1回で渡すクラス。
+     *        描き方は最初に現れた順に描くので、同じ描き方の線分どうしの順序は変わらない。
+     *///---------------------------------------------------------------------------
+    class LineBatch {
+        
+      public:
+        
+        /**
+         * @brief styleで描く線分の配列。点を2つずつ組にして加える。
+         *///---------------------------------------------------------------------------
+        PointArray &  get( const LineStyle & style ) {
+            
+            for ( std::size_t k=0;  k < this->entries.size();  k++ ) {
+                
+                if ( this->entries[k].style == style ) { return this->entries[k].points; }
+            }
+            
+            this->entries.push_back( Entry(style) );
+            
+            return  this->entries.back().points;
+        }
+        
+        /**
+         * @brief 全ての線分を捨てる。
+         *///---------------------------------------------------------------------------
+        void  clear(void) {
+            
+            this->entries.clear();
+        }
+        
+        /**
+         * @brief 描き方ごとに1回ずつ、sinkに線分を渡す。
+         *///---------------------------------------------------------------------------
+        void  submit( RenderSink & sink ) const {
+            
+            for ( std::size_t k=0;  k < this->entries.size();  k++ ) {
+                
+                if ( ! this->entries[k].points.empty() ) { sink.drawLines( this->entries[k].points, this->entries[k].style ); }
+            }
+        }
+        
+      private:
+        
+        /**
+         * @brief 描き方と、その描き方で描く線分の配列。
+         *///---------------------------------------------------------------------------
+        struct Entry {
+            
+            explicit Entry( const LineStyle & style_) : style( style_) {}
+            
+            LineStyle   style;
+            PointArray  points;
+        };
+        
+        std::deque<Entry>  entries;
+    };
+    
+    
+    /**
+     * @brief 始点をorigin、終点をorigin + toとする線分を行列affineで画面へ写し、pointsに加える。
+     *///---------------------------------------------------------------------------
+    inline void  appendLine( PointArray & points,  const Matrix& affine,  const Vector& origin,  const Vector& to ) {
+        
+        const Affine2  screen = toScreen( affine );
+        
+        points.push_back( screen * ( origin      ) );
+        points.push_back( screen * ( origin + to ) );
+    }
+    
+    
+    /**
+     * @brief 方向がdirectionで始点の集合がpositionsな平行線の集合を行列affineで画面へ写し、pointsに加える。
+     *///---------------------------------------------------------------------------
+    inline void  appendParallelLines( PointArray & points,  const Matrix& affine,  const VertexList & positions,  const Vector & direction ) {
+        
+        for ( VertexList::const_iterator  it = positions.begin();  it != positions.end();  it++ ) {
+            
+            appendLine( points, affine, *it, direction );
+        }
+    }
+}
+#endif
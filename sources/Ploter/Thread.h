@@ -0,0 +1,308 @@
+/**
+ * @file   Thread.h
+ * @author 村田 裕一
+ * @brief  処理を複数のスレッドに分配する関数郡を定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_THREAD_H
+#define  INCLUDED_THREAD_H
+
+#include  <vector>
+#include  <algorithm>
+#include  <boost/utility.hpp>
+
+#ifdef   _WIN32
+#include  <windows.h>
+#else
+#include  <unistd.h>
+#include  <pthread.h>
+#endif
+
+namespace Ploter {
+    
+    /**
+     * @brief 利用できるプロセッサの数を取得する。
+     *///---------------------------------------------------------------------------
+    inline std::size_t  getProcessorNumber(void) {
+        
+      #ifdef _WIN32
+        
+        SYSTEM_INFO  information;
+        
+        GetSystemInfo( &information );
+        
+        return  std::max<std::size_t>( 1, information.dwNumberOfProcessors );
+        
+      #else
+        
+        long  number = sysconf( _SC_NPROCESSORS_ONLN );
+        
+        return  ( number < 1 ) ? 1 : static_cast<std::size_t>(number);
+        
+      #endif
+    }
+    
+    
+    /**
+     * @brief 共有カウンタを1増やし、増やす前の値を返す。
+     *///---------------------------------------------------------------------------
+    inline long  fetchAndIncrement( volatile long & counter ) {
+        
+      #ifdef _WIN32
+        
+        return  InterlockedIncrement( &counter ) - 1;
+        
+      #else
+        
+        return  __sync_fetch_and_add( &counter, 1 );
+        
+      #endif
+    }
+    
+    
+    /**
+     * @brief 現在のスレッドをmilliseconds[ms]止める。
+     *///---------------------------------------------------------------------------
+    inline void  sleepMilliseconds( unsigned int milliseconds ) {
+        
+      #ifdef _WIN32
+        
+        Sleep( milliseconds );
+        
+      #else
+        
+        usleep( milliseconds * 1000 );
+        
+      #endif
+    }
+    
+    
+    /**
+     * @brief 相互排他。
+     *///---------------------------------------------------------------------------
+    class Mutex : boost::noncopyable {
+        
+      public:
+        
+      #ifdef _WIN32
+        
+        Mutex(void) { InitializeCriticalSection( &this->section ); }
+        ~Mutex(void) { DeleteCriticalSection    ( &this->section ); }
+        
+        void  lock  (void) { EnterCriticalSection( &this->section ); }
+        void  unlock(void) { LeaveCriticalSection( &this->section ); }
+        
+      private:
+        
+        CRITICAL_SECTION  section;
+        
+      #else
+        
+        Mutex(void) { pthread_mutex_init   ( &this->mutex, 0 ); }
+        ~Mutex(void) { pthread_mutex_destroy( &this->mutex    ); }
+        
+        void  lock  (void) { pthread_mutex_lock  ( &this->mutex ); }
+        void  unlock(void) { pthread_mutex_unlock( &this->mutex ); }
+        
+      private:
+        
+        pthread_mutex_t  mutex;
+        
+      #endif
+    };
+    
+    
+    /**
+     * @brief 生存期間中、mutexを確保する。
+     *///---------------------------------------------------------------------------
+    class Lock : boost::noncopyable {
+        
+      public:
+        
+        explicit Lock( Mutex & mutex_) : mutex( mutex_) { this->mutex.lock(); }
+        ~Lock(void) { this->mutex.unlock(); }
+        
+      private:
+        
+        Mutex &  mutex;
+    };
+    
+    
+    /**
+     * @brief 関数を別のスレッドで実行するクラス。破棄する時に終了を待つ。
+     *///---------------------------------------------------------------------------
+    class Thread : boost::noncopyable {
+        
+      public:
+        
+        typedef void (*Function)( void * argument );
+        
+        Thread(void) : isStarted(false) {}
+        ~Thread(void) { this->join(); }
+        
+        /**
+         * @brief function(argument)を別のスレッドで開始する。開始できない場合はfalseを返す。
+         *///---------------------------------------------------------------------------
+        bool  start( Function function_,  void * argument_) {
+            
+            if ( this->isStarted ) { return false; }
+            
+            this->function = function_;
+            this->argument = argument_;
+            
+          #ifdef _WIN32
+            
+            this->handle    = CreateThread( 0, 0, &Thread::run, this, 0, 0 );
+            this->isStarted = ( this->handle != 0 );
+            
+          #else
+            
+            this->isStarted = ( pthread_create( &this->handle, 0, &Thread::run, this ) == 0 );
+            
+          #endif
+            
+            return  this->isStarted;
+        }
+        
+        /**
+         * @brief スレッドの終了を待つ。
+         *///---------------------------------------------------------------------------
+        void  join(void) {
+            
+            if ( ! this->isStarted ) { return; }
+            
+          #ifdef _WIN32
+            
+            WaitForSingleObject( this->handle, INFINITE );
+            CloseHandle        ( this->handle           );
+            
+          #else
+            
+            pthread_join( this->handle, 0 );
+            
+          #endif
+            
+            this->isStarted = false;
+        }
+        
+      private:
+        
+      #ifdef _WIN32
+        
+        static DWORD WINAPI  run( LPVOID thread ) { static_cast<Thread *>(thread)->execute();  return 0; }
+        
+        HANDLE     handle;
+        
+      #else
+        
+        static void *        run( void * thread ) { static_cast<Thread *>(thread)->execute();  return 0; }
+        
+        pthread_t  handle;
+        
+      #endif
+        
+        void  execute(void) { this->function( this->argument ); }
+        
+        Function  function;
+        void *    argument;
+        bool      isStarted;
+    };
+    
+    
+    /**
+     * @brief parallelForの各スレッドが実行する処理。未処理の番号を順に取り出してtaskに渡す。
+     *///---------------------------------------------------------------------------
+    template<class TaskType>
+    class TaskRunner {
+        
+      public:
+        
+        TaskRunner( TaskType & task_,  std::size_t count_) : task( task_), count( count_), next(0) {}
+        
+        /**
+         * @brief スレッドの開始関数。
+         *///---------------------------------------------------------------------------
+      #ifdef _WIN32
+        
+        static DWORD WINAPI  run( LPVOID runner ) { static_cast<TaskRunner *>(runner)->work();  return 0; }
+        
+      #else
+        
+        static void *        run( void * runner ) { static_cast<TaskRunner *>(runner)->work();  return 0; }
+        
+      #endif
+        
+        /**
+         * @brief 全ての番号を処理し終えるまでtaskを呼ぶ。
+         *///---------------------------------------------------------------------------
+        void  work(void) {
+            
+            for ( long k = fetchAndIncrement(this->next);  static_cast<std::size_t>(k) < this->count;  k = fetchAndIncrement(this->next) ) {
+                
+                this->task( static_cast<std::size_t>(k) );
+            }
+        }
+        
+      private:
+        
+        TaskType &     task;
+        std::size_t    count;
+        volatile long  next;
+    };
+    
+    
+    /**
+     * @brief [0,count)の各番号kについてtask(k)を複数のスレッドで実行し、全て終わるまで待つ。
+     *        threadNumberが0の場合はプロセッサの数だけスレッドを使う。
+     *///---------------------------------------------------------------------------
+    template<class TaskType>
+    void  parallelFor( std::size_t count,  TaskType & task,  std::size_t threadNumber = 0 ) {
+        
+        TaskRunner<TaskType>  runner( task, count );
+        
+        if ( threadNumber == 0 ) { threadNumber = getProcessorNumber(); }
+        
+        threadNumber = std::min( threadNumber, count );
+        
+        if ( threadNumber <= 1 ) { runner.work();  return; }
+        
+      #ifdef _WIN32
+        
+        std::vector<HANDLE>  threads;
+        
+        for ( std::size_t k=1;  k < threadNumber;  k++ ) {
+            
+            HANDLE  thread = CreateThread( 0, 0, &TaskRunner<TaskType>::run, &runner, 0, 0 );
+            
+            if ( thread != 0 ) { threads.push_back(thread); }
+        }
+        
+        runner.work();
+        
+        for ( std::size_t k=0;  k < threads.size();  k++ ) {
+            
+            WaitForSingleObject( threads[k], INFINITE );
+            CloseHandle        ( threads[k]           );
+        }
+        
+      #else
+        
+        std::vector<pthread_t>  threads;
+        
+        for ( std::size_t k=1;  k < threadNumber;  k++ ) {
+            
+            pthread_t  thread;
+            
+            if ( pthread_create( &thread, 0, &TaskRunner<TaskType>::run, &runner ) == 0 ) { threads.push_back(thread); }
+        }
+        
+        runner.work();
+        
+        for ( std::size_t k=0;  k < threads.size();  k++ ) {
+            
+            pthread_join( threads[k], 0 );
+        }
+        
+      #endif
+    }
+}
+#endif
@@ -1,658 +1,1251 @@
-/**
- * 
- * @file   Utility.h
- * @author c T
- * @brief  B
- * 
- *///---------------------------------------------------------------------------
-#ifndef     INCLUDED_UTILITY_H
-#define     INCLUDED_UTILITY_H
-
-
-#include    <string>
-#include    <vector>
-#include    <algorithm>
-#include    <cmath>
-#include    <boost/function.hpp>
-#include    <boost/lambda/lambda.hpp>
-#include    <boost/lambda/bind.hpp>
-#include    <boost/lambda/if.hpp>
-#include    <boost/numeric/ublas/matrix.hpp>
-#include    <boost/numeric/ublas/vector.hpp>
-#include    <boost/numeric/ublas/matrix_proxy.hpp>
-#include    <boost/numeric/ublas/vector_proxy.hpp>
-#include    <boost/numeric/ublas/triangular.hpp>
-#include    <boost/numeric/ublas/lu.hpp>
-#include    <boost/numeric/ublas/io.hpp>
-#include    <windows.h>
-#include    <gl/gl.h>
-
-
-namespace Ploter {
-    
-    using namespace boost;
-    using namespace boost::numeric;
-    using namespace boost::numeric::ublas;
-    using namespace boost::lambda;
-    
-    
-    typedef double                 Element;
-    typedef ublas::vector<Element> Vector;
-    typedef ublas::matrix<Element> Matrix;
-    
-    typedef unsigned int           Index;
-    typedef std  ::vector<Vector>  VertexList;
-    typedef ublas::matrix<Vector>  VertexMatrix;
-    
-    typedef function<      Element& (      Vector&)> ReferenceFunction;
-    typedef function<const Element& (const Vector&)> ConstReferenceFunction;
-    
-    
-    const Element  ELEMENT_EXTREAM_VALUE = 1.79769313486232e308;
-    
-    
-    /**
-     * @brief xNg̗vf̎wW\lB
-     *///---------------------------------------------------------------------------
-    enum { X,Y,Z,W };
-    
-    
-    /**
-     * @brief xNgEsɊւ萔SB
-     *///---------------------------------------------------------------------------
-    namespace V {
-        
-        const Vector  ZERO  ( zero_vector<Element>(4)   );
-        const Vector  X_UNIT( unit_vector<Element>(4,X) );
-        const Vector  Y_UNIT( unit_vector<Element>(4,Y) );
-        const Vector  Z_UNIT( unit_vector<Element>(4,Z) );
-        const Vector  W_UNIT( unit_vector<Element>(4,W) );
-        
-        const      ReferenceFunction        X( ret<      Element&>( _1[0] ) );
-        const      ReferenceFunction        Y( ret<      Element&>( _1[1] ) );
-        const      ReferenceFunction        Z( ret<      Element&>( _1[2] ) );
-        const ConstReferenceFunction  CONST_X( ret<const Element&>( _1[0] ) );
-        const ConstReferenceFunction  CONST_Y( ret<const Element&>( _1[1] ) );
-        const ConstReferenceFunction  CONST_Z( ret<const Element&>( _1[2] ) );
-    }
-    namespace M {
-        
-        const Matrix  ZERO    ( zero_matrix    <Element>(4,4) );
-        const Matrix  IDENTITY( identity_matrix<Element>(4,4) );
-    }
-    
-    
-    /**
-     * @brief x烉WAւ̕ϊB 
-     *///---------------------------------------------------------------------------
-    inline double  toRad( double deg ) {
-        
-        return deg/180 * M_PI;
-    }
-    
-    
-    /**
-     * @brief dfor_eachB
-     *///---------------------------------------------------------------------------
-    template<class IteratorType, class UnaryFunctionType>
-    void  dualForEach( IteratorType begin,  IteratorType end,  UnaryFunctionType  unaryFunction ) {
-        
-        for ( IteratorType  i = begin;  i != end;  i++ ) {
-            
-            std::for_each( i.begin(), i.end(), unaryFunction );
-        }
-    }
-    
-    /**
-     * @brief ΐkڂɂBA0͖B
-     *///---------------------------------------------------------------------------
-    void  toLogScale( VertexMatrix& object,  ReferenceFunction element ) {
-        
-        dualForEach( object.begin1(), object.end1(),
-            
-            if_( bind(V::Z,_1) != 0 ) [
-                
-                bind(element,_1) = bind<double,double>( std::log10, bind(element,_1) ) + 1
-            ]
-        );
-    }
-    
-    
-    /**
-     * @brief KB
-     *///---------------------------------------------------------------------------
-    template<class IteratorType>
-    void  regularize( IteratorType begin,  IteratorType end ) {
-        
-        Element  sumZ;
-        
-        for ( IteratorType  i = begin;  i != end;  i++ ) {
-            
-            sumZ = 0;
-            
-            std::for_each( i.begin(), i.end(),
-                
-                var(sumZ) += bind<double,double>( std::fabs, bind(V::Z,_1) )
-            );
-            
-            if ( sumZ != 0 ) {
-                
-                std::for_each( i.begin(), i.end(), ( bind(V::Z,_1) /= sumZ ) );
-            }
-        }
-    }
-    
-    
-    /**
-     * @brief _vertex`悷B
-     *///---------------------------------------------------------------------------
-    inline void  drawVertex( const Vector& vertex ) {
-        
-        glVertex4d( vertex(X), vertex(Y), vertex(Z), vertex(W) );
-    }
-    
-    
-    /**
-     * @brief n_originAI_origin + toƂsaffineōWϊA`悷B
-     *///---------------------------------------------------------------------------
-    void  drawLine( const Matrix& affine,  const Vector& origin,  const Vector& to ) {
-        
-        static Vector  begin( V::ZERO );
-        static Vector  end  ( V::ZERO );
-        
-        begin = prod( affine, origin +      V::W_UNIT );
-        end   = prod( affine, origin + to + V::W_UNIT );
-        
-        drawVertex( begin );
-        drawVertex( end   );
-    }
-    
-    
-    /**
-     * @brief directionŎn_̏Wpositionsȕs̏WsaffineōWϊA`悷B
-     *///---------------------------------------------------------------------------
-    void  drawParallelLines( const Matrix& affine,  const VertexList& positions,
-                                                    const Vector&     direction ) {
-        
-        glBegin( GL_LINES ); {
-            
-            std::for_each( positions.begin(), positions.end(), bind( drawLine, affine, _1, direction ) );
-            
-        } glEnd();
-    }
-    
-    
-    /**
-     * @brief xNgv(x,y,z)̐B
-     *///---------------------------------------------------------------------------
-    inline Vector  v( Element x,  Element y,  Element z ) {
-        
-        Vector  v( V::ZERO );
-        
-        v(X) = x;
-        v(Y) = y;
-        v(Z) = z;
-        
-        return v;
-    }
-    
-    
-    /**
-     * @brief xNgtargetsaffineōWϊB
-     *///---------------------------------------------------------------------------
-    inline void  transform( const Matrix& affine,  Vector& target ) {
-        
-        target = prod( affine, target + V::W_UNIT );
-    }
-    
-    
-    /**
-     * @brief x,y,zꂼAa{,b{,c{sԂB
-     *///---------------------------------------------------------------------------
-    inline Matrix  scale( Element a,  Element b,  Element c ) {
-        
-        Matrix  m( M::IDENTITY );
-        
-        m(0,0) = a;
-        m(1,1) = b;
-        m(2,2) = c;
-        
-        return m;
-    }
-    
-    
-    /**
-     * @brief tosړsԂB
-     *///---------------------------------------------------------------------------
-    inline Matrix  translate( const Vector &to ) {
-        
-        Matrix  m( M::IDENTITY );
-        
-        m(0,3) = to(X);
-        m(1,3) = to(Y);
-        m(2,3) = to(Z);
-        
-        return m;
-    }
-    
-    
-    /**
-     * @brief axis  deg]sԂB
-     *///---------------------------------------------------------------------------
-    Matrix  rotate( Element deg,  const Vector& axis ) {
-        
-        Matrix  m( M::IDENTITY );
-        
-        Element  sinValue = std::sin( toRad(deg) );
-        Element  cosValue = std::cos( toRad(deg) );
-        
-        for ( int i=X; i<=Z; i++ ) {
-            
-            for ( int j=X; j<=Z; j++ ) {
-                
-                m(i,j) = axis(i) * axis(j) * (1-cosValue);
-            }
-            
-            m(i,i) += cosValue;
-        }
-        
-        m(0,1) -= axis(Z) * sinValue,  m(0,2) += axis(Y) * sinValue;
-        m(1,0) += axis(Z) * sinValue,  m(1,2) -= axis(X) * sinValue;
-        m(2,0) -= axis(Y) * sinValue,  m(2,1) += axis(X) * sinValue;
-        
-        return m;
-    }
-    
-    
-    /**
-     * @brief axis  direction ̕ degfό`sԂB
-     *///---------------------------------------------------------------------------
-    Matrix  shear( Element deg,  const Vector& axis,  const Vector& direction ) {
-        
-        Matrix  m( M::IDENTITY );
-        
-        Element  sinValue = std::sin( toRad(deg) );
-        
-        for ( int i=X; i<=Z; i++ ) {
-            
-            for ( int j=X; j<=Z; j++ ) {
-                
-                if (i!=j) {
-                    
-                    m(i,j) = direction(i) * axis(j) * sinValue;
-                }
-            }
-        }
-        
-        return m;
-    }
-    
-    
-    /**
-     * @brief A Ax=b B
-     *///---------------------------------------------------------------------------
-    Vector& solve( Matrix& A,  Vector& b ) {
-        
-        permutation_matrix<>  pm( A.size1() );
-        
-        lu_factorize (A,pm);
-        lu_substitute(A,pm,b);
-        
-        return b;
-    }
-    
-    
-    /**
-     *
-     * @brief IvVǗNXB
-     *
-     *///---------------------------------------------------------------------------
-    class Option {
-        
-      public:
-        
-        Option( const std::string& section_ ) : section( section_ ) {}
-        
-        
-        /**
-         * @brief init@CkeywlǂݍށB
-         *///---------------------------------------------------------------------------
-        int  get( const std::string& key ) const {
-            
-            return  GetPrivateProfileInt( this->section.c_str(), key.c_str(), 1, PATH.c_str() );
-        }
-        
-      private:
-        
-        /**
-         * @brief init@C̃pXݒ肷B
-         *///---------------------------------------------------------------------------
-        static std::string  initialize( void ) {
-            
-            char  path[64];
-            
-            GetCurrentDirectory( 64, path );
-            
-            return  std::string(path) + "\\option.ini";
-        }
-        
-        static const std::string  PATH;
-                     std::string  section;
-    };
-    
-    const std::string  Option::PATH( Option::initialize() );
-    
-    
-    /**
-     *
-     * @brief őlƍŏl̊i[B
-     *
-     *///---------------------------------------------------------------------------
-    class MinMax {
-        
-      public:
-        
-        enum { INNER, UPPER, LOWER };
-        
-        /**
-         * @brief ŏlEől̏B
-         *///---------------------------------------------------------------------------
-        void  initialize( void ) {
-            
-            this->min =  ELEMENT_EXTREAM_VALUE;
-            this->max = -ELEMENT_EXTREAM_VALUE;
-        }
-        
-        
-        /**
-         * @brief ANZbTB
-         *///---------------------------------------------------------------------------
-        Element  getMin( void ) const { return this->min; }
-        Element  getMax( void ) const { return this->max; }
-        
-        
-        /**
-         * @brief valueŏlEőlǂ肵AXVB
-         *///---------------------------------------------------------------------------
-        int  assess( Element value ) {
-            
-            int  state = MinMax::INNER;
-            
-            if ( this->min > value ) { this->min = value;  state = MinMax::UPPER; }
-            if ( this->max < value ) { this->max = value;  state = MinMax::LOWER; }
-            
-            return  state;
-        }
-        
-        
-        /**
-         * @brief ŏlEől͈̔͂̎擾B
-         *///---------------------------------------------------------------------------
-        Element  getRange( void ) const {
-            
-            return  this->max - this->min;
-        }
-        
-        
-        /**
-         * @brief ŏlEől̒Ԓl̎擾B
-         *///---------------------------------------------------------------------------
-        Element  getMiddlePoint( void ) const {
-            
-            return  ( this->max + this->min ) / 2;
-        }
-        
-      private:
-        
-        Element  min;
-        Element  max;
-    };
-    
-    
-    /**
-     *
-     * @brief x,y,zꂼ̍ŏlEőlǗNXB
-     *
-     *///---------------------------------------------------------------------------
-    class MinMaxManager {
-        
-      public:
-        
-        /**
-         * @brief objectx,y,zꂼ̍ŏlEőlݒ肷B
-         *///---------------------------------------------------------------------------
-        void  set( const VertexMatrix& object ) {
-            
-            this->x.initialize();
-            this->y.initialize();
-            this->z.initialize();
-            
-            dualForEach( object.begin1(), object.end1(), (
-                
-                bind( &MinMax::assess, &this->x, bind(V::CONST_X,_1) ),
-                bind( &MinMax::assess, &this->y, bind(V::CONST_Y,_1) ),
-                bind( &MinMax::assess, &this->z, bind(V::CONST_Z,_1) )
-            ));
-        }
-        
-        
-        MinMax  x;
-        MinMax  y;
-        MinMax  z;
-    };
-    
-    
-    /**
-     *
-     * @brief AtBsǗNXB 
-     *
-     *///---------------------------------------------------------------------------
-    class AffineManager {
-        
-      public:
-        
-        enum {
-            
-            FOR_X_AXIS,
-            FOR_Y_AXIS,
-            FOR_Z_AXIS,
-            FOR_XY_GRID,
-            FOR_XZ_GRID,
-            FOR_YZ_GRID,
-            FOR_GRAPH,
-        };
-        
-        
-        AffineManager( const Option& option_,  const MinMaxManager*  minmaxManager_) :
-            
-            option( option_),  minmaxManager( minmaxManager_)
-        {}
-        
-        
-        /**
-         * @brief eOtvfp̃AtBsԂB
-         *///---------------------------------------------------------------------------
-        Matrix  get( int target ) const {
-            
-            switch( target ) {
-                
-              case FOR_X_AXIS:   return  this->forXAxis();
-              case FOR_Y_AXIS:   return  this->forYAxis();
-              case FOR_Z_AXIS:   return  this->forZAxis();
-              case FOR_XZ_GRID:  return  this->forXzGrid();
-              case FOR_GRAPH:    return  this->forGraph();
-              default:           return  this->common();
-                
-            }
-        }
-        
-      private:
-        
-        /**
-         * @brief ʂ̃AtBsB
-         *///---------------------------------------------------------------------------
-        Matrix  common( void ) const {
-            
-            return  prod( this->projection(),
-                
-                prod<Matrix>( this->horizontal(), this->shift() )
-            );
-        }
-        
-        
-        /**
-         * @brief xp̃AtBsB
-         *///---------------------------------------------------------------------------
-        Matrix  forXAxis( void ) const {
-            
-            return  prod( this->common(),
-                
-                this->selectMatrix(
-                    
-                    M::IDENTITY,
-                    prod( translate( V::Y_UNIT ), scale( 1,-1,1 ) )
-                )
-            );
-        }
-        
-        
-        /**
-         * @brief yp̃AtBsB
-         *///---------------------------------------------------------------------------
-        Matrix  forYAxis( void ) const {
-            
-            return  prod( this->common(), translate( V::X_UNIT ) );
-        }
-        
-        
-        /**
-         * @brief zp̃AtBsB
-         *///---------------------------------------------------------------------------
-        Matrix  forZAxis( void ) const {
-            
-            return  prod( this->common(),
-                
-                this->selectMatrix(
-                    
-                    M::IDENTITY,
-                    prod( translate( V::X_UNIT ), rotate( 90, V::Z_UNIT ) )
-                )
-            );
-        }
-        
-        
-        /**
-         * @brief xyObhp̃AtBsB
-         *///---------------------------------------------------------------------------
-        Matrix  forXzGrid( void ) const {
-            
-            return  prod( this->common(),
-                
-                this->selectMatrix( translate( V::Y_UNIT ), M::IDENTITY )
-            );
-        }
-        
-        
-        /**
-         * @brief Otp̃AtBsB
-         *///---------------------------------------------------------------------------
-        Matrix  forGraph( void ) const {
-            
-            return  prod( this->common(),
-                
-                prod<Matrix>( this->regularize(), this->toOrigin() )
-            );
-        }
-        
-        
-        /**
-         * @brief esԂB
-         *///---------------------------------------------------------------------------
-        Matrix  projection( void ) const {
-            
-            Matrix  m( M::IDENTITY );
-            
-            m(2,2) = 0;
-            m(0,2) = -std::cos( toRad(45) );
-            m(1,2) = -std::sin( toRad(45) );
-            
-            return  m;
-        }
-        
-        
-        /**
-         * @brief 𐅕ɂB
-         *///---------------------------------------------------------------------------
-        Matrix  horizontal( void ) const {
-            
-            return  prod( rotate( -90, V::X_UNIT ),
-                
-                selectMatrix( M::IDENTITY, rotate( -90, V::Z_UNIT ) )
-            );
-        }
-        
-        
-        /**
-         * @brief ẍړB
-         *///---------------------------------------------------------------------------
-        Matrix  shift( void ) const {
-            
-            return  selectMatrix( M::IDENTITY, translate( -V::X_UNIT ) );
-        }
-        
-        
-        /**
-         * @brief _ɈړB
-         *///---------------------------------------------------------------------------
-        Matrix  toOrigin( void ) const {
-            
-            return  translate(
-                
-                v( -this->minmaxManager->x.getMin(),
-                   -this->minmaxManager->y.getMin(),
-                   -this->minmaxManager->z.getMin() )
-            );
-        }
-        
-        
-        /**
-         * @brief XP[𐳋KB
-         *///---------------------------------------------------------------------------
-        Matrix  regularize( void ) const {
-            
-            return  scale(
-                
-                1.0 / this->getScaleRange( "x", this->minmaxManager->x ),
-                1.0 / this->getScaleRange( "y", this->minmaxManager->y ),
-                0.5 / this->getScaleRange( "z", this->minmaxManager->z )
-            );
-        }
-        
-        
-        /**
-         * @brief XP[擾B
-         *///---------------------------------------------------------------------------
-        Element  getScaleRange( const std::string& key,  const MinMax& minmax ) const {
-            
-            std::string  section( key + "Axis" );
-            
-            return  Option(section).get("isFix") ?
-                
-                minmax.getRange() : Option(section).get("maxValue");
-        }
-        
-        
-        /**
-         * @brief ̈ႢɂAtBs̑IB
-         *///---------------------------------------------------------------------------
-        const Matrix&  selectMatrix( const Matrix& caseX,  const Matrix& caseY ) const {
-            
-            return  this->option.get("horizontalAxis") ? caseY : caseX;
-        }
-        
-        
-        Option                option;
-        const MinMaxManager*  minmaxManager;
-    };
-}
-#endif
+/**
+ * 
+ * @file   Utility.h
+ * @author 村田 裕一
+ * @brief  。
+ * 
+ *///---------------------------------------------------------------------------
+#ifndef     INCLUDED_UTILITY_H
+#define     INCLUDED_UTILITY_H
+
+
+#include    <string>
+#include    <vector>
+#include    <map>
+#include    <algorithm>
+#include    <fstream>
+#include    <cmath>
+#include    <cctype>
+#include    <cstdlib>
+#include    <boost/function.hpp>
+#include    <boost/shared_ptr.hpp>
+#include    "Thread.h"
+#include    "Arena.h"
+
+#ifdef      _WIN32
+#include    <windows.h>
+#else
+#include    <sys/stat.h>
+#endif
+
+
+namespace Ploter {
+    
+    using namespace boost;
+    
+    
+    typedef double                 Element;
+    typedef unsigned int           Index;
+    typedef unsigned long          Generation;
+    
+    
+    const Element  ELEMENT_EXTREAM_VALUE = 1.79769313486232e308;
+    
+    
+    /**
+     * @brief ベクトルの要素の指標を表す値。
+     *///---------------------------------------------------------------------------
+    enum { X,Y,Z,W };
+    
+    
+    /**
+     * @brief 4次元ベクトル。要素の並びはx,y,z,w。
+     *        集成体なので、定数は静的に初期化され、演算でヒープを使わない。
+     *///---------------------------------------------------------------------------
+    struct Vec4 {
+        
+        Element &        operator ()( Index k )       { return this->element[k]; }
+        const Element &  operator ()( Index k ) const { return this->element[k]; }
+        
+        Element  element[4];
+    };
+    
+    
+    /**
+     * @brief 4x4行列。element[行][列]。
+     *///---------------------------------------------------------------------------
+    struct Mat4 {
+        
+        Element &        operator ()( Index r,  Index c )       { return this->element[r][c]; }
+        const Element &  operator ()( Index r,  Index c ) const { return this->element[r][c]; }
+        
+        Element  element[4][4];
+    };
+    
+    /**
+     * @brief 画面上の点。要素の並びはx,y。
+     *///---------------------------------------------------------------------------
+    struct Point2 {
+        
+        Element &        operator ()( Index k )       { return this->element[k]; }
+        const Element &  operator ()( Index k ) const { return this->element[k]; }
+        
+        Element  element[2];
+    };
+    
+    
+    /**
+     * @brief 画面のx,yだけを求めるアフィン変換。4x4行列のx,y行を取り出したもの。
+     *        投影でz行は0になり、w行は(0,0,0,1)のままなので、残りの行は使わない。
+     *///---------------------------------------------------------------------------
+    struct Affine2 {
+        
+        Element &        operator ()( Index r,  Index c )       { return this->element[r][c]; }
+        const Element &  operator ()( Index r,  Index c ) const { return this->element[r][c]; }
+        
+        Element  element[2][4];
+    };
+    
+    typedef Vec4                  Vector;
+    typedef Mat4                  Matrix;
+    typedef std::vector<Vector>   VertexList;
+    typedef std::vector<Point2>   PointArray;
+    typedef std::vector<Element>  ElementArray;
+    
+    /** 区間[first,second]とその列。陰線処理の一時的な列はFrameArenaから確保する。 */
+    typedef std::pair<Element,Element>                 Range;
+    typedef std::vector< Range, ArenaAllocator<Range> >  RangeList;
+    
+    
+    /**
+     * @brief ベクトルの演算。
+     *///---------------------------------------------------------------------------
+    inline Vec4  operator +( const Vec4& a,  const Vec4& b ) {
+        
+        Vec4  r = {{ a(X)+b(X), a(Y)+b(Y), a(Z)+b(Z), a(W)+b(W) }};
+        
+        return r;
+    }
+    
+    inline Vec4  operator -( const Vec4& a,  const Vec4& b ) {
+        
+        Vec4  r = {{ a(X)-b(X), a(Y)-b(Y), a(Z)-b(Z), a(W)-b(W) }};
+        
+        return r;
+    }
+    
+    inline Vec4  operator -( const Vec4& a ) {
+        
+        Vec4  r = {{ -a(X), -a(Y), -a(Z), -a(W) }};
+        
+        return r;
+    }
+    
+    inline Vec4  operator *( Element k,  const Vec4& a ) {
+        
+        Vec4  r = {{ k*a(X), k*a(Y), k*a(Z), k*a(W) }};
+        
+        return r;
+    }
+    
+    inline Vec4  operator *( const Vec4& a,  Element k ) {
+        
+        return k * a;
+    }
+    
+    inline Vec4  operator /( const Vec4& a,  Element k ) {
+        
+        Vec4  r = {{ a(X)/k, a(Y)/k, a(Z)/k, a(W)/k }};
+        
+        return r;
+    }
+    
+    
+    /**
+     * @brief 行列とベクトルの積。
+     *///---------------------------------------------------------------------------
+    inline Vec4  operator *( const Mat4& m,  const Vec4& a ) {
+        
+        Vec4  r;
+        
+        for ( int i=X; i<=W; i++ ) {
+            
+            r(i) = m(i,X)*a(X) + m(i,Y)*a(Y) + m(i,Z)*a(Z) + m(i,W)*a(W);
+        }
+        
+        return r;
+    }
+    
+    
+    /**
+     * @brief 行列の積。
+     *///---------------------------------------------------------------------------
+    inline Mat4  operator *( const Mat4& a,  const Mat4& b ) {
+        
+        Mat4  r;
+        
+        for ( int i=X; i<=W; i++ ) {
+            
+            for ( int j=X; j<=W; j++ ) {
+                
+                r(i,j) = a(i,X)*b(X,j) + a(i,Y)*b(Y,j) + a(i,Z)*b(Z,j) + a(i,W)*b(W,j);
+            }
+        }
+        
+        return r;
+    }
+    
+    
+    /**
+     * @brief 行列mを画面のx,yだけを求めるアフィン変換にする。
+     *///---------------------------------------------------------------------------
+    inline Affine2  toScreen( const Mat4& m ) {
+        
+        Affine2  a = {{ { m(X,X), m(X,Y), m(X,Z), m(X,W) },
+                        { m(Y,X), m(Y,Y), m(Y,Z), m(Y,W) } }};
+        
+        return a;
+    }
+    
+    
+    /**
+     * @brief 点aを画面へ写す。aのwは無視し、1として扱う。
+     *///---------------------------------------------------------------------------
+    inline Point2  operator *( const Affine2& m,  const Vec4& a ) {
+        
+        Point2  r = {{ m(X,X)*a(X) + m(X,Y)*a(Y) + m(X,Z)*a(Z) + m(X,W),
+                       m(Y,X)*a(X) + m(Y,Y)*a(Y) + m(Y,Z)*a(Z) + m(Y,W) }};
+        
+        return r;
+    }
+    
+    
+    /**
+     * @brief ベクトル・行列に関する定数郡。
+     *///---------------------------------------------------------------------------
+    namespace V {
+        
+        const Vector  ZERO   = {{ 0,0,0,0 }};
+        const Vector  X_UNIT = {{ 1,0,0,0 }};
+        const Vector  Y_UNIT = {{ 0,1,0,0 }};
+        const Vector  Z_UNIT = {{ 0,0,1,0 }};
+        const Vector  W_UNIT = {{ 0,0,0,1 }};
+    }
+    namespace M {
+        
+        const Matrix  ZERO     = {{ { 0,0,0,0 }, { 0,0,0,0 }, { 0,0,0,0 }, { 0,0,0,0 } }};
+        const Matrix  IDENTITY = {{ { 1,0,0,0 }, { 0,1,0,0 }, { 0,0,1,0 }, { 0,0,0,1 } }};
+        
+        /** x軸周りに-90°回転する行列。 */
+        const Matrix  ROTATE_X_M90 = {{ { 1, 0, 0, 0 },
+                                        { 0, 0, 1, 0 },
+                                        { 0,-1, 0, 0 },
+                                        { 0, 0, 0, 1 } }};
+        
+        /** z軸周りに-90°回転する行列。 */
+        const Matrix  ROTATE_Z_M90 = {{ { 0, 1, 0, 0 },
+                                        {-1, 0, 0, 0 },
+                                        { 0, 0, 1, 0 },
+                                        { 0, 0, 0, 1 } }};
+        
+        /** z軸周りに90°回転する行列。 */
+        const Matrix  ROTATE_Z_90  = {{ { 0,-1, 0, 0 },
+                                        { 1, 0, 0, 0 },
+                                        { 0, 0, 1, 0 },
+                                        { 0, 0, 0, 1 } }};
+        
+        /** z軸を45°の方向に投影する行列。0.7071...はcos45°=sin45°。zは奥行き(大きいほど手前)として残す。 */
+        const Matrix  PROJECTION   = {{ { 1, 0,-0.70710678118654752440, 0 },
+                                        { 0, 1,-0.70710678118654752440, 0 },
+                                        { 0, 0, 1,                      0 },
+                                        { 0, 0, 0,                      1 } }};
+    }
+    
+    
+    /**
+     * @brief 新しい世代を発行する。世代は入力が変わったことを表し、発行ごとに異なる値になる。
+     *        0はどの世代でもないことを表す。どのスレッドから呼んでもよい。
+     *///---------------------------------------------------------------------------
+    inline Generation  newGeneration( void ) {
+        
+        static volatile long  last = 0;
+        
+        return  static_cast<Generation>( fetchAndIncrement(last) + 1 );
+    }
+    
+    
+    /**
+     * @brief ファイルpathの更新を検出するための値を取得する。取得できない場合は0を返す。
+     *        最終更新時刻とサイズから作る。時刻の単位は、Windowsでは100ns、LinuxとmacOSではナノ秒、それ以外では秒。
+     *///---------------------------------------------------------------------------
+    inline unsigned long long  getFileStamp( const char * path ) {
+        
+      #ifdef _WIN32
+        
+        WIN32_FILE_ATTRIBUTE_DATA  data;
+        
+        if ( ! GetFileAttributesEx( path, GetFileExInfoStandard, &data ) ) { return 0; }
+        
+        unsigned long long  time = ( static_cast<unsigned long long>( data.ftLastWriteTime.dwHighDateTime ) << 32 ) | data.ftLastWriteTime.dwLowDateTime;
+        unsigned long long  size = ( static_cast<unsigned long long>( data.nFileSizeHigh ) << 32 ) | data.nFileSizeLow;
+        
+      #else
+        
+        struct stat  data;
+        
+        if ( stat( path, &data ) != 0 ) { return 0; }
+        
+      #if   defined(__linux__)
+        unsigned long long  time = static_cast<unsigned long long>( data.st_mtim.tv_sec ) * 1000000000ULL + data.st_mtim.tv_nsec;
+      #elif defined(__APPLE__)
+        unsigned long long  time = static_cast<unsigned long long>( data.st_mtimespec.tv_sec ) * 1000000000ULL + data.st_mtimespec.tv_nsec;
+      #else
+        unsigned long long  time = static_cast<unsigned long long>( data.st_mtime );
+      #endif
+        
+        unsigned long long  size = static_cast<unsigned long long>( data.st_size );
+        
+      #endif
+        
+        return  time ^ ( size << 40 );
+    }
+    
+    
+    /**
+     * @brief 度からラジアンへの変換。 
+     *///---------------------------------------------------------------------------
+    inline double  toRad( double deg ) {
+        
+        return deg/180 * M_PI;
+    }
+    
+    
+    /**
+     * @brief 格子状のz値を行優先で連続した領域に格納するクラス。
+     *        x,yは列・行の番号そのものなので格納しない。
+     *        ファイルをマップした領域を読み込み専用で参照することもできる。
+     *///---------------------------------------------------------------------------
+    class GridStore {
+        
+      public:
+        
+        enum { ALIGNMENT = 32 };
+        
+        GridStore(void) : memory(0), data(0), rowNumber(0), columnNumber(0) {}
+        
+        GridStore( const GridStore & source ) : memory(0), data(0), rowNumber(0), columnNumber(0) {
+            
+            this->assign(source);
+        }
+        
+        ~GridStore(void) { delete [] this->memory; }
+        
+        GridStore &  operator =( const GridStore & source ) {
+            
+            this->assign(source);
+            
+            return *this;
+        }
+        
+        /**
+         * @brief rowNumber_行columnNumber_列の領域を確保する。値は不定。
+         *///---------------------------------------------------------------------------
+        void  resize( std::size_t rowNumber_,  std::size_t columnNumber_) {
+            
+            if ( this->memory == 0 || this->getSize() != rowNumber_ * columnNumber_ ) {
+                
+                delete [] this->memory;
+                
+                this->memory = new char[ rowNumber_ * columnNumber_ * sizeof(Element) + GridStore::ALIGNMENT ];
+                this->data   = reinterpret_cast<Element *>(
+                    
+                    this->memory + GridStore::ALIGNMENT - reinterpret_cast<std::size_t>(this->memory) % GridStore::ALIGNMENT
+                );
+            }
+            
+            this->owner.reset();
+            
+            this->rowNumber    = rowNumber_;
+            this->columnNumber = columnNumber_;
+        }
+        
+        /**
+         * @brief ownerが保持する領域dataを、rowNumber_行columnNumber_列のz値として読み込み専用で参照する。
+         *///---------------------------------------------------------------------------
+        void  attach( const Element * data_,  std::size_t rowNumber_,  std::size_t columnNumber_,  shared_ptr<void> owner_) {
+            
+            delete [] this->memory;
+            
+            this->memory       = 0;
+            this->data         = const_cast<Element *>(data_);
+            this->owner        = owner_;
+            this->rowNumber    = rowNumber_;
+            this->columnNumber = columnNumber_;
+        }
+        
+        /**
+         * @brief sourceの値を複写する。
+         *///---------------------------------------------------------------------------
+        void  assign( const GridStore & source ) {
+            
+            if ( this == &source ) { return; }
+            
+            this->resize( source.rowNumber, source.columnNumber );
+            
+            std::copy( source.begin(), source.end(), this->begin() );
+        }
+        
+        /**
+         * @brief 内容を交換する。
+         *///---------------------------------------------------------------------------
+        void  swap( GridStore & target ) {
+            
+            std::swap( this->memory,       target.memory       );
+            std::swap( this->data,         target.data         );
+            std::swap( this->rowNumber,    target.rowNumber    );
+            std::swap( this->columnNumber, target.columnNumber );
+            
+            this->owner.swap( target.owner );
+        }
+        
+        /**
+         * @brief アクセッサ。書き込みは自身で確保した領域に限る。
+         *///---------------------------------------------------------------------------
+        std::size_t      getRowNumber   (void) const { return this->rowNumber;                      }
+        std::size_t      getColumnNumber(void) const { return this->columnNumber;                   }
+        std::size_t      getSize        (void) const { return this->rowNumber * this->columnNumber; }
+        
+        Element *        begin(void)       { return this->data;                   }
+        Element *        end  (void)       { return this->data + this->getSize(); }
+        const Element *  begin(void) const { return this->data;                   }
+        const Element *  end  (void) const { return this->data + this->getSize(); }
+        
+        Element *        row( Index j )       { return this->data + j * this->columnNumber; }
+        const Element *  row( Index j ) const { return this->data + j * this->columnNumber; }
+        
+        Element &        operator ()( Index j,  Index i )       { return this->data[ j * this->columnNumber + i ]; }
+        const Element &  operator ()( Index j,  Index i ) const { return this->data[ j * this->columnNumber + i ]; }
+        
+      private:
+        
+        char *            memory;
+        Element *         data;
+        std::size_t       rowNumber;
+        std::size_t       columnNumber;
+        shared_ptr<void>  owner;
+    };
+    
+    
+    /**
+     * @brief ベクトルv(x,y,z)の生成。
+     *///---------------------------------------------------------------------------
+    inline Vector  v( Element x,  Element y,  Element z ) {
+        
+        Vector  v = {{ x,y,z,0 }};
+        
+        return v;
+    }
+    
+    
+    /**
+     * @brief x軸,y軸,z軸をそれぞれ、a倍,b倍,c倍する行列を返す。
+     *///---------------------------------------------------------------------------
+    inline Matrix  scale( Element a,  Element b,  Element c ) {
+        
+        Matrix  m( M::IDENTITY );
+        
+        m(0,0) = a;
+        m(1,1) = b;
+        m(2,2) = c;
+        
+        return m;
+    }
+    
+    
+    /**
+     * @brief toだけ平行移動する行列を返す。
+     *///---------------------------------------------------------------------------
+    inline Matrix  translate( const Vector &to ) {
+        
+        Matrix  m( M::IDENTITY );
+        
+        m(0,3) = to(X);
+        m(1,3) = to(Y);
+        m(2,3) = to(Z);
+        
+        return m;
+    }
+    
+    
+    /**
+     *
+     * @brief iniファイルを読み込んだ内容。読み込んだ後は変更しない。
+     *        セクション名・キー名の大文字と小文字は区別しない。値の後の';'以降は注釈として除く。
+     *        描画のたびに参照するgraphセクションの値は、読み込んだ時に型付きの値にしておく。
+     *
+     *///---------------------------------------------------------------------------
+    class OptionSnapshot {
+        
+      public:
+        
+        /**
+         * @brief graphセクションの値。キーが無い場合の値は、isで始まるキーが1、それ以外が0。
+         *///---------------------------------------------------------------------------
+        struct GraphSettings {
+            
+            int  isHiddenLine;
+            int  hiddenLineMethod;
+            int  hiddenLineThreads;     //  キーが無い場合は1。
+            int  isDrawXPolyLines;
+            int  isDrawYPolyLines;
+            int  isRegularizeX;
+            int  isRegularizeY;
+            int  isLogScale;
+            int  scanLineDensity;
+            int  simplifyTolerance;
+            int  decimationSpacing;
+            int  lodVertexBudget;
+            int  frameArenaSize;
+        };
+        
+        
+        /**
+         * @brief pathが指すiniファイルを読み込む。読み込めない場合は空になる。
+         *///---------------------------------------------------------------------------
+        explicit OptionSnapshot( const std::string& path ) {
+            
+            std::ifstream  file( path.c_str() );
+            std::string    line;
+            std::string    section;
+            
+            while ( std::getline( file, line ) ) {
+                
+                line = OptionSnapshot::trim( line );
+                
+                if ( line.empty() || line[0] == ';' || line[0] == '#' ) { continue; }
+                
+                if ( line[0] == '[' ) {
+                    
+                    section = OptionSnapshot::trim( line.substr( 1, line.find(']') - 1 ) );
+                    
+                    continue;
+                }
+                
+                std::string::size_type  equal = line.find('=');
+                
+                if ( equal == std::string::npos ) { continue; }
+                
+                std::string  value = line.substr( equal + 1 );
+                
+                value = OptionSnapshot::trim( value.substr( 0, value.find(';') ) );
+                
+                this->values[ OptionSnapshot::makeKey( section, line.substr( 0, equal ) ) ] = value;
+            }
+            
+            this->parse();
+        }
+        
+        
+        /**
+         * @brief sectionのkeyが指す値の文字列をvalueに格納する。キーが無い場合はfalseを返す。
+         *///---------------------------------------------------------------------------
+        bool  find( const std::string& section,  const std::string& key,  std::string& value ) const {
+            
+            std::map<std::string, std::string>::const_iterator  it = this->values.find( OptionSnapshot::makeKey( section, key ) );
+            
+            if ( it == this->values.end() ) { return false; }
+            
+            value = it->second;
+            
+            return true;
+        }
+        
+        
+        /**
+         * @brief 型ごとの値の取得。キーが無い場合はdefaultValueを返す。
+         *        整数はGetPrivateProfileIntと同じく、先頭の数字の並びだけを読む。
+         *///---------------------------------------------------------------------------
+        int  getInt( const std::string& section,  const std::string& key,  int defaultValue ) const {
+            
+            std::string  value;
+            
+            return  this->find( section, key, value ) ? static_cast<int>( std::strtol( value.c_str(), 0, 10 ) ) : defaultValue;
+        }
+        
+        double  getDouble( const std::string& section,  const std::string& key,  double defaultValue ) const {
+            
+            std::string  value;
+            
+            return  this->find( section, key, value ) ? std::strtod( value.c_str(), 0 ) : defaultValue;
+        }
+        
+        std::string  getString( const std::string& section,  const std::string& key,  const std::string& defaultValue ) const {
+            
+            std::string  value;
+            
+            return  this->find( section, key, value ) ? value : defaultValue;
+        }
+        
+        
+        /**
+         * @brief sectionのkeyの値をvalueにする。公開する前の写しを組み立てる場合に使う。
+         *///---------------------------------------------------------------------------
+        void  set( const std::string& section,  const std::string& key,  const std::string& value ) {
+            
+            this->values[ OptionSnapshot::makeKey( section, key ) ] = value;
+            
+            this->parse();
+        }
+        
+        
+        /**
+         * @brief graphセクションの型付きの値。
+         *///---------------------------------------------------------------------------
+        const GraphSettings &  getGraph( void ) const { return  this->graph; }
+        
+      private:
+        
+        /**
+         * @brief graphセクションの値を型付きの値にする。
+         *///---------------------------------------------------------------------------
+        void  parse( void ) {
+            
+            GraphSettings &  g = this->graph;
+            
+            g.isHiddenLine      = this->getInt( "graph", "isHiddenLine",      1 );
+            g.hiddenLineMethod  = this->getInt( "graph", "hiddenLineMethod",  0 );
+            g.hiddenLineThreads = this->getInt( "graph", "hiddenLineThreads", 1 );
+            g.isDrawXPolyLines  = this->getInt( "graph", "isDrawXPolyLines",  1 );
+            g.isDrawYPolyLines  = this->getInt( "graph", "isDrawYPolyLines",  1 );
+            g.isRegularizeX     = this->getInt( "graph", "isRegularizeX",     1 );
+            g.isRegularizeY     = this->getInt( "graph", "isRegularizeY",     1 );
+            g.isLogScale        = this->getInt( "graph", "isLogScale",        1 );
+            g.scanLineDensity   = this->getInt( "graph", "scanLineDensity",   0 );
+            g.simplifyTolerance = this->getInt( "graph", "simplifyTolerance", 0 );
+            g.decimationSpacing = this->getInt( "graph", "decimationSpacing", 0 );
+            g.lodVertexBudget   = this->getInt( "graph", "lodVertexBudget",   0 );
+            g.frameArenaSize    = this->getInt( "graph", "frameArenaSize",    0 );
+        }
+        
+        /**
+         * @brief 前後の空白を除く。
+         *///---------------------------------------------------------------------------
+        static std::string  trim( const std::string& text ) {
+            
+            std::string::size_type  begin = text.find_first_not_of(" \t\r\n");
+            std::string::size_type  end   = text.find_last_not_of (" \t\r\n");
+            
+            return  ( begin == std::string::npos ) ? std::string() : text.substr( begin, end - begin + 1 );
+        }
+        
+        /**
+         * @brief セクション名とキー名から、大文字と小文字を区別しない検索用のキーを作る。
+         *///---------------------------------------------------------------------------
+        static std::string  makeKey( const std::string& section,  const std::string& key ) {
+            
+            std::string  result = OptionSnapshot::trim(section) + '\n' + OptionSnapshot::trim(key);
+            
+            for ( std::string::iterator  it = result.begin();  it != result.end();  it++ ) {
+                
+                *it = static_cast<char>( std::tolower( static_cast<unsigned char>(*it) ) );
+            }
+            
+            return result;
+        }
+        
+        std::map<std::string, std::string>  values;
+        GraphSettings                       graph;
+    };
+    
+    
+    /**
+     *
+     * @brief オプションを管理するクラス。
+     *        iniファイルは更新された時だけ読み込み、描画の開始時にその時点の写しを採用する。
+     *        描画中は同じ写しを参照するので、途中で更新されても1回の描画の中では値が変わらない。
+     *
+     *///---------------------------------------------------------------------------
+    class Option {
+        
+      public:
+        
+        Option( const std::string& section_ ) : section( section_ ) {}
+        
+        
+        /**
+         * @brief keyが指す整数値を返す。キーが無い場合は1を返す。
+         *///---------------------------------------------------------------------------
+        int  get( const std::string& key ) const {
+            
+            return  Option::getSnapshot().getInt( this->section, key, 1 );
+        }
+        
+        
+        /**
+         * @brief 型ごとの値の取得。キーが無い場合はdefaultValueを返す。
+         *///---------------------------------------------------------------------------
+        int          getInt   ( const std::string& key,  int                defaultValue ) const { return  Option::getSnapshot().getInt   ( this->section, key, defaultValue ); }
+        double       getDouble( const std::string& key,  double             defaultValue ) const { return  Option::getSnapshot().getDouble( this->section, key, defaultValue ); }
+        std::string  getString( const std::string& key,  const std::string& defaultValue ) const { return  Option::getSnapshot().getString( this->section, key, defaultValue ); }
+        
+        
+        /**
+         * @brief 採用している写しのgraphセクションの型付きの値。文字列の検索をしないので、描画のたびに参照してよい。
+         *///---------------------------------------------------------------------------
+        static const OptionSnapshot::GraphSettings &  getGraph( void ) { return  Option::getSnapshot().getGraph(); }
+        
+        
+        /**
+         * @brief iniファイルが更新されていれば読み込み直し、新しい写しを公開する。公開した場合はtrueを返す。
+         *        どのスレッドから呼んでもよい。
+         *///---------------------------------------------------------------------------
+        static bool  reload( void ) {
+            
+            unsigned long long  stamp = Option::getStamp();
+            
+            {
+                Lock  lock( Option::mutex );
+                
+                if ( Option::latest != 0 && stamp == Option::stamp ) { return false; }
+            }
+            
+            shared_ptr<const OptionSnapshot>  snapshot( new OptionSnapshot( Option::PATH ) );
+            
+            Lock  lock( Option::mutex );
+            
+            Option::latest           = snapshot;
+            Option::stamp            = stamp;
+            Option::latestGeneration = newGeneration();
+            
+            return true;
+        }
+        
+        
+        /**
+         * @brief iniファイルの代わりにsnapshotを最新の写しとして公開する。
+         *        iniファイルが次に更新されるまで、reloadはこの写しを置き換えない。
+         *///---------------------------------------------------------------------------
+        static void  publish( const OptionSnapshot& snapshot ) {
+            
+            shared_ptr<const OptionSnapshot>  copy( new OptionSnapshot(snapshot) );
+            unsigned long long                stamp = Option::getStamp();
+            
+            Lock  lock( Option::mutex );
+            
+            Option::latest           = copy;
+            Option::stamp            = stamp;
+            Option::latestGeneration = newGeneration();
+        }
+        
+        
+        /**
+         * @brief 最新の写しを採用し、オプションの世代を返す。描画の開始時に呼ぶ。
+         *///---------------------------------------------------------------------------
+        static Generation  refresh( void ) {
+            
+            Option::reload();
+            
+            Lock  lock( Option::mutex );
+            
+            Option::current    = Option::latest;
+            Option::generation = Option::latestGeneration;
+            
+            return  Option::generation;
+        }
+        
+        
+        /**
+         * @brief オプションの現在の世代を返す。
+         *///---------------------------------------------------------------------------
+        static Generation  getGeneration( void ) {
+            
+            return  Option::generation;
+        }
+        
+      private:
+        
+        /**
+         * @brief 採用している写しを返す。まだ採用していない場合は読み込む。
+         *///---------------------------------------------------------------------------
+        static const OptionSnapshot&  getSnapshot( void ) {
+            
+            if ( Option::current == 0 ) { Option::refresh(); }
+            
+            return  *Option::current;
+        }
+        
+        /**
+         * @brief iniファイルの更新を検出するための値を取得する。取得できない場合は0を返す。
+         *///---------------------------------------------------------------------------
+        static unsigned long long  getStamp( void ) {
+            
+            return  getFileStamp( PATH.c_str() );
+        }
+        
+        /**
+         * @brief iniファイルのパスを設定する。
+         *///---------------------------------------------------------------------------
+        static std::string  initialize( void ) {
+            
+          #ifdef _WIN32
+            
+            char  path[MAX_PATH];
+            
+            GetCurrentDirectory( MAX_PATH, path );
+            
+            return  std::string(path) + "\\option.ini";
+            
+          #else
+            
+            char  path[4096];
+            
+            return  std::string( getcwd( path, sizeof(path) ) ? path : "." ) + "/option.ini";
+            
+          #endif
+        }
+        
+        static const std::string                       PATH;
+        static       Mutex                             mutex;
+        static       shared_ptr<const OptionSnapshot>  latest;
+        static       Generation                        latestGeneration;
+        static       unsigned long long                stamp;
+        static       shared_ptr<const OptionSnapshot>  current;
+        static       Generation                        generation;
+                     std::string                       section;
+    };
+    
+    const std::string                 Option::PATH( Option::initialize() );
+    Mutex                             Option::mutex;
+    shared_ptr<const OptionSnapshot>  Option::latest;
+    Generation                        Option::latestGeneration = 0;
+    unsigned long long                Option::stamp            = 0;
+    shared_ptr<const OptionSnapshot>  Option::current;
+    Generation                        Option::generation       = 0;
+    
+    
+    /**
+     *
+     * @brief iniファイルの更新を別のスレッドで監視するクラス。
+     *        更新を見つけると新しい写しを公開し、通知関数を呼ぶ。写しを採用するのは次の描画の開始時。
+     *
+     *///---------------------------------------------------------------------------
+    class OptionWatcher : noncopyable {
+        
+      public:
+        
+        typedef void (*Callback)( void * context );
+        
+        OptionWatcher(void) : isRunning(0) {}
+        ~OptionWatcher(void) { this->stop(); }
+        
+        
+        /**
+         * @brief interval[ms]ごとにiniファイルを調べ、更新されていればcallback(context)を呼ぶ。
+         *        通知関数は監視用のスレッドで呼ばれる。
+         *///---------------------------------------------------------------------------
+        bool  start( unsigned int interval_,  Callback callback_,  void * context_) {
+            
+            this->interval  = interval_;
+            this->callback  = callback_;
+            this->context   = context_;
+            this->isRunning = 1;
+            
+            if ( ! this->thread.start( &OptionWatcher::run, this ) ) { this->isRunning = 0; }
+            
+            return  this->isRunning != 0;
+        }
+        
+        
+        /**
+         * @brief 監視を止め、スレッドの終了を待つ。
+         *///---------------------------------------------------------------------------
+        void  stop(void) {
+            
+            this->isRunning = 0;
+            this->thread.join();
+        }
+        
+      private:
+        
+        /**
+         * @brief 監視用のスレッドの処理。
+         *///---------------------------------------------------------------------------
+        static void  run( void * watcher ) {
+            
+            OptionWatcher *  self = static_cast<OptionWatcher *>(watcher);
+            
+            while ( self->isRunning ) {
+                
+                sleepMilliseconds( self->interval );
+                
+                if ( self->isRunning && Option::reload() ) { self->callback( self->context ); }
+            }
+        }
+        
+        Thread         thread;
+        unsigned int   interval;
+        Callback       callback;
+        void *         context;
+        volatile long  isRunning;
+    };
+    
+    
+    /**
+     *
+     * @brief 最大値と最小値の格納。
+     *
+     *///---------------------------------------------------------------------------
+    class MinMax {
+        
+      public:
+        
+        enum { INNER, UPPER, LOWER };
+        
+        /**
+         * @brief 最小値・最大値の初期化。
+         *///---------------------------------------------------------------------------
+        void  initialize( void ) {
+            
+            this->min =  ELEMENT_EXTREAM_VALUE;
+            this->max = -ELEMENT_EXTREAM_VALUE;
+        }
+        
+        
+        /**
+         * @brief アクセッサ。
+         *///---------------------------------------------------------------------------
+        Element  getMin( void ) const { return this->min; }
+        Element  getMax( void ) const { return this->max; }
+        
+        
+        /**
+         * @brief 最小値・最大値を設定する。
+         *///---------------------------------------------------------------------------
+        void  set( Element min_,  Element max_) {
+            
+            this->min = min_;
+            this->max = max_;
+        }
+        
+        
+        /**
+         * @brief valueが最小値・最大値かどうかを査定し、更新する。
+         *///---------------------------------------------------------------------------
+        int  assess( Element value ) {
+            
+            int  state = MinMax::INNER;
+            
+            if ( this->min > value ) { this->min = value;  state = MinMax::UPPER; }
+            if ( this->max < value ) { this->max = value;  state = MinMax::LOWER; }
+            
+            return  state;
+        }
+        
+        
+        /**
+         * @brief 最小値・最大値の範囲の取得。
+         *///---------------------------------------------------------------------------
+        Element  getRange( void ) const {
+            
+            return  this->max - this->min;
+        }
+        
+        
+        /**
+         * @brief 最小値・最大値の中間値の取得。
+         *///---------------------------------------------------------------------------
+        Element  getMiddlePoint( void ) const {
+            
+            return  ( this->max + this->min ) / 2;
+        }
+        
+      private:
+        
+        Element  min;
+        Element  max;
+    };
+    
+    
+    /**
+     *
+     * @brief x,y,zそれぞれの最小値・最大値を管理するクラス。
+     *
+     *///---------------------------------------------------------------------------
+    class MinMaxManager {
+        
+      public:
+        
+        MinMaxManager(void) : generation(0) {}
+        
+        /**
+         * @brief objectのx,y,zそれぞれの最小値・最大値を設定する。
+         *        x,yは列・行の番号なので、zだけを走査する。
+         *///---------------------------------------------------------------------------
+        void  set( const GridStore& object ) {
+            
+            this->setGrid( object );
+            
+            for ( const Element * z = object.begin();  z != object.end();  z++ ) {
+                
+                this->z.assess(*z);
+            }
+        }
+        
+        
+        /**
+         * @brief x,yの範囲を格子objectの大きさから設定し、zを初期化する。
+         *///---------------------------------------------------------------------------
+        void  setGrid( const GridStore& object ) {
+            
+            this->touch();
+            
+            this->x.initialize();
+            this->y.initialize();
+            this->z.initialize();
+            
+            if ( object.getSize() == 0 ) { return; }
+            
+            this->x.set( 0, static_cast<Element>( object.getColumnNumber() - 1 ) );
+            this->y.set( 0, static_cast<Element>( object.getRowNumber   () - 1 ) );
+        }
+        
+        
+        /**
+         * @brief 値を変更したことを記録する。
+         *///---------------------------------------------------------------------------
+        void  touch( void ) {
+            
+            this->generation = newGeneration();
+        }
+        
+        
+        /**
+         * @brief 値の世代を返す。
+         *///---------------------------------------------------------------------------
+        Generation  getGeneration( void ) const {
+            
+            return  this->generation;
+        }
+        
+        
+        MinMax      x;
+        MinMax      y;
+        MinMax      z;
+        
+      private:
+        
+        Generation  generation;
+    };
+    
+    
+    /**
+     *
+     * @brief アフィン行列を管理するクラス。 
+     *
+     *///---------------------------------------------------------------------------
+    class AffineManager {
+        
+      public:
+        
+        enum {
+            
+            FOR_X_AXIS,
+            FOR_Y_AXIS,
+            FOR_Z_AXIS,
+            FOR_XY_GRID,
+            FOR_XZ_GRID,
+            FOR_YZ_GRID,
+            FOR_GRAPH,
+            TARGET_NUMBER
+        };
+        
+        
+        AffineManager( const Option& option_,  const MinMaxManager*  minmaxManager_) :
+            
+            option( option_),  minmaxManager( minmaxManager_),  optionGeneration(0),  rangeGeneration(0)
+        {
+            
+            std::fill( this->isCached, this->isCached + TARGET_NUMBER, false );
+        }
+        
+        
+        /**
+         * @brief 各グラフ要素用のアフィン行列を返す。
+         *        オプションと最小値・最大値が前回と同じ世代なら、前回求めた行列を返す。
+         *///---------------------------------------------------------------------------
+        const Matrix&  get( int target ) const {
+            
+            if ( this->optionGeneration != Option::getGeneration() || this->rangeGeneration != this->minmaxManager->getGeneration() ) {
+                
+                this->optionGeneration = Option::getGeneration();
+                this->rangeGeneration  = this->minmaxManager->getGeneration();
+                
+                std::fill( this->isCached, this->isCached + TARGET_NUMBER, false );
+            }
+            
+            if ( ! this->isCached[target] ) {
+                
+                this->matrices[target] = this->make(target);
+                this->isCached[target] = true;
+            }
+            
+            return  this->matrices[target];
+        }
+        
+      private:
+        
+        /**
+         * @brief 各グラフ要素用のアフィン行列を求める。
+         *///---------------------------------------------------------------------------
+        Matrix  make( int target ) const {
+            
+            switch( target ) {
+                
+              case FOR_X_AXIS:   return  this->forXAxis();
+              case FOR_Y_AXIS:   return  this->forYAxis();
+              case FOR_Z_AXIS:   return  this->forZAxis();
+              case FOR_XZ_GRID:  return  this->forXzGrid();
+              case FOR_GRAPH:    return  this->forGraph();
+              default:           return  this->common();
+                
+            }
+        }
+        
+        /**
+         * @brief 共通のアフィン行列。
+         *///---------------------------------------------------------------------------
+        Matrix  common( void ) const {
+            
+            return  this->projection() * ( this->horizontal() * this->shift() );
+        }
+        
+        
+        /**
+         * @brief x軸用のアフィン行列。
+         *///---------------------------------------------------------------------------
+        Matrix  forXAxis( void ) const {
+            
+            return  this->common() * this->selectMatrix(
+                
+                M::IDENTITY,
+                translate( V::Y_UNIT ) * scale( 1,-1,1 )
+            );
+        }
+        
+        
+        /**
+         * @brief y軸用のアフィン行列。
+         *///---------------------------------------------------------------------------
+        Matrix  forYAxis( void ) const {
+            
+            return  this->common() * translate( V::X_UNIT );
+        }
+        
+        
+        /**
+         * @brief z軸用のアフィン行列。
+         *///---------------------------------------------------------------------------
+        Matrix  forZAxis( void ) const {
+            
+            return  this->common() * this->selectMatrix(
+                
+                M::IDENTITY,
+                translate( V::X_UNIT ) * M::ROTATE_Z_90
+            );
+        }
+        
+        
+        /**
+         * @brief xyグリッド用のアフィン行列。
+         *///---------------------------------------------------------------------------
+        Matrix  forXzGrid( void ) const {
+            
+            return  this->common() * this->selectMatrix( translate( V::Y_UNIT ), M::IDENTITY );
+        }
+        
+        
+        /**
+         * @brief グラフ用のアフィン行列。
+         *///---------------------------------------------------------------------------
+        Matrix  forGraph( void ) const {
+            
+            return  this->common() * ( this->regularize() * this->toOrigin() );
+        }
+        
+        
+        /**
+         * @brief 投影行列を返す。
+         *///---------------------------------------------------------------------------
+        const Matrix&  projection( void ) const {
+            
+            return  M::PROJECTION;
+        }
+        
+        
+        /**
+         * @brief 軸を水平にする。
+         *///---------------------------------------------------------------------------
+        Matrix  horizontal( void ) const {
+            
+            return  M::ROTATE_X_M90 * this->selectMatrix( M::IDENTITY, M::ROTATE_Z_M90 );
+        }
+        
+        
+        /**
+         * @brief x軸の移動。
+         *///---------------------------------------------------------------------------
+        Matrix  shift( void ) const {
+            
+            return  this->selectMatrix( M::IDENTITY, translate( -V::X_UNIT ) );
+        }
+        
+        
+        /**
+         * @brief 原点に移動。
+         *///---------------------------------------------------------------------------
+        Matrix  toOrigin( void ) const {
+            
+            return  translate(
+                
+                v( -this->minmaxManager->x.getMin(),
+                   -this->minmaxManager->y.getMin(),
+                   -this->minmaxManager->z.getMin() )
+            );
+        }
+        
+        
+        /**
+         * @brief スケールを正規化。
+         *///---------------------------------------------------------------------------
+        Matrix  regularize( void ) const {
+            
+            return  scale(
+                
+                1.0 / this->getScaleRange( "x", this->minmaxManager->x ),
+                1.0 / this->getScaleRange( "y", this->minmaxManager->y ),
+                0.5 / this->getScaleRange( "z", this->minmaxManager->z )
+            );
+        }
+        
+        
+        /**
+         * @brief スケールを取得。
+         *///---------------------------------------------------------------------------
+        Element  getScaleRange( const std::string& key,  const MinMax& minmax ) const {
+            
+            std::string  section( key + "Axis" );
+            
+            return  Option(section).get("isFix") ?
+                
+                minmax.getRange() : Option(section).get("maxValue");
+        }
+        
+        
+        /**
+         * @brief 水平軸の違いによるアフィン行列の選択。
+         *///---------------------------------------------------------------------------
+        const Matrix&  selectMatrix( const Matrix& caseX,  const Matrix& caseY ) const {
+            
+            return  this->option.get("horizontalAxis") ? caseY : caseX;
+        }
+        
+        
+        Option                option;
+        const MinMaxManager*  minmaxManager;
+        mutable Matrix        matrices[TARGET_NUMBER];
+        mutable bool          isCached[TARGET_NUMBER];
+        mutable Generation    optionGeneration;
+        mutable Generation    rangeGeneration;
+    };
+}
+#endif
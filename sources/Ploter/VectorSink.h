@@ -0,0 +1,495 @@
+/**
+ * @file   VectorSink.h
+ * @author 村田 裕一
+ * @brief  線分をSVG・PDF形式のファイルに書き出す描画先を定義したファイル。
+ *///---------------------------------------------------------------------------
+#ifndef  INCLUDED_VECTOR_SINK_H
+#define  INCLUDED_VECTOR_SINK_H
+
+#include  <vector>
+#include  <string>
+#include  <fstream>
+#include  <cstdio>
+#include  <cmath>
+#include  <algorithm>
+#include  "RenderSink.h"
+
+namespace Ploter {
+    
+    /**
+     * @brief 点が同じか、同じ直線上にあるとみなす距離[画素]。
+     *///---------------------------------------------------------------------------
+    const Element  VECTOR_TOLERANCE = 0.01;
+    
+    
+    /**
+     * @brief 線分を図形としてファイルに書き出す描画先の基底クラス。
+     *        線分は受け取った順にそのままファイルへ書き、メモリには溜めない。
+     *        実線では、前の線分の終点から始まる線分を同じ折れ線につなぎ、同じ向きに続く線分は1本にまとめる。
+     *        破線の模様は線分ごとに始点から数えるので、破線はつながない。
+     *        座標の単位は画素で、beginFrameごとにファイルを作り直す。
+     *///---------------------------------------------------------------------------
+    class VectorRenderSink : public RenderSink {
+        
+      public:
+        
+        /**
+         * @brief 幅width_・高さheight_[画素]の図をファイルfileName_に書き出す描画先を生成する。
+         *///---------------------------------------------------------------------------
+        VectorRenderSink( const std::string & fileName_,  int width_,  int height_ ) :
+            
+            width( width_), height( height_), fileName( fileName_), viewportX(0), viewportY(0),
+            viewportSize( std::min( width_, height_ ) ), minimum(0), scale(1), isFailed(false)
+        {}
+        
+        virtual ~VectorRenderSink(void) {}
+        
+        /**
+         * @brief 書き出しに失敗していないかどうか。
+         *///---------------------------------------------------------------------------
+        bool  isGood(void) const { return ! this->isFailed; }
+        
+        /**
+         * @brief 図の左下(x,y)から1辺sizeの正方形に描く。単位は出力する図の座標。
+         *///---------------------------------------------------------------------------
+        void  setViewport( int x,  int y,  int size ) {
+            
+            this->viewportX    = x;
+            this->viewportY    = y;
+            this->viewportSize = size;
+        }
+        
+        /**
+         * @brief ファイルを作り直し、背景をbackgroundで塗る。
+         *///---------------------------------------------------------------------------
+        void  beginFrame( const RGBA & background,  Element minimum_,  Element maximum_) {
+            
+            this->minimum = minimum_;
+            this->scale   = ( maximum_ > minimum_ ) ? this->viewportSize / ( maximum_ - minimum_ ) : 0;
+            
+            this->file.close();
+            this->file.clear();
+            this->file.open( this->fileName.c_str(), std::ios::binary );
+            
+            this->isFailed = ! this->file;
+            
+            this->writeHeader(background);
+        }
+        
+        /**
+         * @brief 線分を折れ線につないでから書き出す。
+         *///---------------------------------------------------------------------------
+        void  drawLines( const PointArray & points,  const LineStyle & style ) {
+            
+            if ( points.size() < 2 ) { return; }
+            
+            this->beginStyle(style);
+            
+            bool    isJoinable = style.stipple == LineStyle::SOLID;
+            bool    isOpen     = false;
+            Point2  start      = this->toPixel( points[0] );
+            Point2  end        = start;
+            
+            for ( std::size_t k=0;  k+1 < points.size();  k += 2 ) {
+                
+                Point2  a = this->toPixel( points[k  ] );
+                Point2  b = this->toPixel( points[k+1] );
+                
+                if ( isJoinable && isOpen && isNear( a, end ) ) {
+                    
+                    if (   isNear( end, b )              ) { continue; }
+                    if ( ! isCollinear( start, end, b ) ) { this->lineTo(end);  start = end; }
+                    
+                    end = b;
+                    continue;
+                }
+                
+                if ( isOpen ) { this->lineTo(end);  this->endPath(); }
+                
+                this->moveTo(a);
+                
+                start  = a;
+                end    = b;
+                isOpen = true;
+            }
+            
+            this->lineTo(end);
+            this->endPath();
+            
+            this->endStyle();
+        }
+        
+        /**
+         * @brief ファイルを閉じる。
+         *///---------------------------------------------------------------------------
+        void  endFrame(void) {
+            
+            this->writeFooter();
+            
+            this->isFailed = this->isFailed || ! this->file.good();
+            
+            this->file.close();
+        }
+        
+      protected:
+        
+        /**
+         * @brief 値を小数点以下2桁までの短い文字列にする。
+         *///---------------------------------------------------------------------------
+        static std::string  format( double value ) {
+            
+            char  buffer[64];
+            
+            std::sprintf( buffer, "%.2f", std::floor( value * 100 + 0.5 ) / 100 );
+            
+            std::string  text( buffer );
+            
+            text.erase( text.find_last_not_of('0') + 1 );
+            
+            if ( text[ text.size() - 1 ] == '.' ) { text.erase( text.size() - 1 ); }
+            if ( text == "-0"                   ) { text = "0"; }
+            
+            return  text;
+        }
+        
+        /**
+         * @brief 破線の模様を、実線から始まる線と隙間の長さ[画素]の列lengthsと、始点での模様の位置phaseにする。
+         *        模様は下位のビットから1画素ずつ使う。
+         *///---------------------------------------------------------------------------
+        static void  toDash( unsigned short stipple,  std::vector<int> & lengths,  int & phase ) {
+            
+            lengths.clear();
+            phase = 0;
+            
+            if ( stipple == 0 ) { lengths.push_back(0);  lengths.push_back(16);  return; }
+            
+            int  first = 0;
+            
+            while ( !( stipple >> first & 1 ) ) { first++; }
+            
+            for ( int k=0;  k < 16;  k++ ) {
+                
+                bool  isOn = ( stipple >> ( ( first + k ) % 16 ) & 1 ) != 0;
+                
+                if ( lengths.size() % 2 == ( isOn ? 0 : 1 ) ) { lengths.push_back(0); }
+                
+                lengths.back()++;
+            }
+            
+            if ( lengths.size() % 2 == 1 ) { lengths.push_back(0); }
+            
+            while ( lengths.size() % 4 == 0 && std::equal( lengths.begin(), lengths.begin() + lengths.size() / 2, lengths.begin() + lengths.size() / 2 ) ) {
+                
+                lengths.resize( lengths.size() / 2 );
+            }
+            
+            phase = ( 16 - first ) % 16;
+        }
+        
+        /**
+         * @brief 色を0～255の整数にする。
+         *///---------------------------------------------------------------------------
+        static int  toByte( double value ) {
+            
+            return  static_cast<int>( std::max( 0.0, std::min( 1.0, value ) ) * 255 + 0.5 );
+        }
+        
+        virtual void  writeHeader( const RGBA & background ) = 0;
+        virtual void  writeFooter( void                    ) = 0;
+        virtual void  beginStyle ( const LineStyle & style ) = 0;
+        virtual void  endStyle   ( void                    ) = 0;
+        virtual void  moveTo     ( const Point2 & point    ) = 0;
+        virtual void  lineTo     ( const Point2 & point    ) = 0;
+        virtual void  endPath    ( void                    ) = 0;
+        
+        std::ofstream  file;
+        int            width;
+        int            height;
+        
+      private:
+        
+        /**
+         * @brief 表示範囲の座標を、左下を原点とする画素の座標に直す。
+         *///---------------------------------------------------------------------------
+        Point2  toPixel( const Point2 & point ) const {
+            
+            Point2  pixel;
+            
+            pixel(X) = this->viewportX + ( point(X) - this->minimum ) * this->scale;
+            pixel(Y) = this->viewportY + ( point(Y) - this->minimum ) * this->scale;
+            
+            return  pixel;
+        }
+        
+        /**
+         * @brief 点aと点bが同じとみなせるかどうか。
+         *///---------------------------------------------------------------------------
+        static bool  isNear( const Point2 & a,  const Point2 & b ) {
+            
+            return  std::fabs( a(X) - b(X) ) <= VECTOR_TOLERANCE && std::fabs( a(Y) - b(Y) ) <= VECTOR_TOLERANCE;
+        }
+        
+        /**
+         * @brief aからmiddleを通ってbへ向かう折れ線を、aからbへの1本の線分とみなせるかどうか。
+         *///---------------------------------------------------------------------------
+        static bool  isCollinear( const Point2 & a,  const Point2 & middle,  const Point2 & b ) {
+            
+            Element  dx1 = middle(X) - a(X),  dy1 = middle(Y) - a(Y);
+            Element  dx2 = b(X) - middle(X),  dy2 = b(Y) - middle(Y);
+            Element  dx  = b(X) - a(X),       dy  = b(Y) - a(Y);
+            Element  length = std::sqrt( dx*dx + dy*dy );
+            
+            return  dx1*dx2 + dy1*dy2 > 0 && std::fabs( dx*dy1 - dy*dx1 ) <= VECTOR_TOLERANCE * length;
+        }
+        
+        std::string  fileName;
+        int          viewportX;
+        int          viewportY;
+        int          viewportSize;
+        Element      minimum;
+        Element      scale;
+        bool         isFailed;
+    };
+    
+    /**
+     * @brief SVG形式で書き出す描画先。描き方ごとにグループにまとめ、折れ線を1つのpath要素にする。
+     *///---------------------------------------------------------------------------
+    class SvgRenderSink : public VectorRenderSink {
+        
+      public:
+        
+        SvgRenderSink( const std::string & fileName_,  int width_,  int height_ ) : VectorRenderSink( fileName_, width_, height_ ) {}
+        
+      private:
+        
+        void  writeHeader( const RGBA & background ) {
+            
+            this->file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                       << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"" << this->width << "\" height=\"" << this->height
+                       << "\" viewBox=\"0 0 " << this->width << " " << this->height << "\">\n"
+                       << "<rect width=\"100%\" height=\"100%\" fill=\"" << toColor(background)
+                       << "\" fill-opacity=\"" << format( background.a ) << "\"/>\n";
+        }
+        
+        void  writeFooter(void) {
+            
+            this->file << "</svg>\n";
+        }
+        
+        void  beginStyle( const LineStyle & style ) {
+            
+            this->file << "<g fill=\"none\" stroke=\"" << toColor( style.color ) << "\" stroke-opacity=\"" << format( style.color.a )
+                       << "\" stroke-width=\"1\" stroke-linecap=\"butt\" stroke-linejoin=\"round\"";
+            
+            if ( ! style.isSmooth ) { this->file << " shape-rendering=\"crispEdges\""; }
+            
+            if ( style.stipple != LineStyle::SOLID ) {
+                
+                std::vector<int>  lengths;
+                int               phase;
+                
+                toDash( style.stipple, lengths, phase );
+                
+                this->file << " stroke-dasharray=\"";
+                
+                for ( std::size_t k=0;  k < lengths.size();  k++ ) { this->file << ( k ? "," : "" ) << lengths[k]; }
+                
+                this->file << "\" stroke-dashoffset=\"" << phase << "\"";
+            }
+            
+            this->file << ">\n";
+        }
+        
+        void  endStyle(void) {
+            
+            this->file << "</g>\n";
+        }
+        
+        void  moveTo( const Point2 & point ) {
+            
+            this->file << "<path d=\"M" << format( point(X) ) << " " << format( this->height - point(Y) );
+        }
+        
+        void  lineTo( const Point2 & point ) {
+            
+            this->file << " " << format( point(X) ) << " " << format( this->height - point(Y) );
+        }
+        
+        void  endPath(void) {
+            
+            this->file << "\"/>\n";
+        }
+        
+        /**
+         * @brief 色を#rrggbbの形式にする。
+         *///---------------------------------------------------------------------------
+        static std::string  toColor( const RGBA & color ) {
+            
+            char  buffer[8];
+            
+            std::sprintf( buffer, "#%02x%02x%02x", toByte( color.r ), toByte( color.g ), toByte( color.b ) );
+            
+            return  buffer;
+        }
+    };
+    
+    
+    /**
+     * @brief PDF形式で書き出す描画先。1ページの内容を1つのストリームとして順に書き、
+     *        長さと不透明度の設定は、オブジェクトの位置の表とともに最後に書く。
+     *///---------------------------------------------------------------------------
+    class PdfRenderSink : public VectorRenderSink {
+        
+      public:
+        
+        PdfRenderSink( const std::string & fileName_,  int width_,  int height_ ) : VectorRenderSink( fileName_, width_, height_ ) {}
+        
+      private:
+        
+        /**
+         * @brief オブジェクトの番号。
+         *///---------------------------------------------------------------------------
+        enum { CATALOG = 1, PAGES, PAGE, CONTENTS, LENGTH, RESOURCES, OBJECT_NUMBER };
+        
+        void  writeHeader( const RGBA & background ) {
+            
+            this->offsets.assign( OBJECT_NUMBER, 0 );
+            this->alphas .clear();
+            
+            this->file << "%PDF-1.4\n%\xE2\xE3\xCF\xD3\n";
+            
+            this->beginObject(CATALOG);
+            this->file << "<< /Type /Catalog /Pages " << PAGES << " 0 R >>\nendobj\n";
+            
+            this->beginObject(PAGES);
+            this->file << "<< /Type /Pages /Kids [" << PAGE << " 0 R] /Count 1 >>\nendobj\n";
+            
+            this->beginObject(PAGE);
+            this->file << "<< /Type /Page /Parent " << PAGES << " 0 R /MediaBox [0 0 " << this->width << " " << this->height << "]"
+                       << " /Contents " << CONTENTS << " 0 R /Resources " << RESOURCES << " 0 R >>\nendobj\n";
+            
+            this->beginObject(CONTENTS);
+            this->file << "<< /Length " << LENGTH << " 0 R >>\nstream\n";
+            
+            this->streamBegin = this->file.tellp();
+            
+            this->file << "q /" << this->getAlphaName( background.a ) << " gs " << toColor( background ) << " rg 0 0 "
+                       << this->width << " " << this->height << " re f Q\n";
+        }
+        
+        void  writeFooter(void) {
+            
+            std::streamoff  length = this->file.tellp() - this->streamBegin;
+            
+            this->file << "endstream\nendobj\n";
+            
+            this->beginObject(LENGTH);
+            this->file << length << "\nendobj\n";
+            
+            this->beginObject(RESOURCES);
+            this->file << "<< /ExtGState <<";
+            
+            for ( std::size_t k=0;  k < this->alphas.size();  k++ ) {
+                
+                this->file << " /A" << k << " << /CA " << format( this->alphas[k] ) << " /ca " << format( this->alphas[k] ) << " >>";
+            }
+            
+            this->file << " >> >>\nendobj\n";
+            
+            std::streamoff  xref = this->file.tellp();
+            
+            this->file << "xref\n0 " << OBJECT_NUMBER << "\n0000000000 65535 f \n";
+            
+            for ( int k=1;  k < OBJECT_NUMBER;  k++ ) {
+                
+                char  buffer[32];
+                
+                std::sprintf( buffer, "%010ld 00000 n \n", static_cast<long>( this->offsets[k] ) );
+                
+                this->file << buffer;
+            }
+            
+            this->file << "trailer\n<< /Size " << OBJECT_NUMBER << " /Root " << CATALOG << " 0 R >>\nstartxref\n" << xref << "\n%%EOF\n";
+        }
+        
+        void  beginStyle( const LineStyle & style ) {
+            
+            this->file << "q /" << this->getAlphaName( style.color.a ) << " gs " << toColor( style.color ) << " RG 1 w 0 J 1 j";
+            
+            if ( style.stipple != LineStyle::SOLID ) {
+                
+                std::vector<int>  lengths;
+                int               phase;
+                
+                toDash( style.stipple, lengths, phase );
+                
+                this->file << " [";
+                
+                for ( std::size_t k=0;  k < lengths.size();  k++ ) { this->file << ( k ? " " : "" ) << lengths[k]; }
+                
+                this->file << "] " << phase << " d";
+            }
+            
+            this->file << "\n";
+        }
+        
+        void  endStyle(void) {
+            
+            this->file << "S Q\n";
+        }
+        
+        void  moveTo( const Point2 & point ) {
+            
+            this->file << format( point(X) ) << " " << format( point(Y) ) << " m";
+        }
+        
+        void  lineTo( const Point2 & point ) {
+            
+            this->file << " " << format( point(X) ) << " " << format( point(Y) ) << " l";
+        }
+        
+        void  endPath(void) {
+            
+            this->file << "\n";
+        }
+        
+        /**
+         * @brief 番号numberのオブジェクトを書き始め、その位置を覚える。
+         *///---------------------------------------------------------------------------
+        void  beginObject( int number ) {
+            
+            this->offsets[number] = this->file.tellp();
+            
+            this->file << number << " 0 obj\n";
+        }
+        
+        /**
+         * @brief 不透明度alphaを設定する名前。初めての不透明度なら、最後に書く設定に加える。
+         *///---------------------------------------------------------------------------
+        std::string  getAlphaName( double alpha ) {
+            
+            std::size_t  k = std::find( this->alphas.begin(), this->alphas.end(), alpha ) - this->alphas.begin();
+            
+            if ( k == this->alphas.size() ) { this->alphas.push_back(alpha); }
+            
+            char  buffer[16];
+            
+            std::sprintf( buffer, "A%lu", static_cast<unsigned long>(k) );
+            
+            return  buffer;
+        }
+        
+        /**
+         * @brief 色を0～1の3つの値にする。
+         *///---------------------------------------------------------------------------
+        static std::string  toColor( const RGBA & color ) {
+            
+            return  format( color.r ) + " " + format( color.g ) + " " + format( color.b );
+        }
+        
+        std::vector<std::streamoff>  offsets;
+        std::vector<double>          alphas;
+        std::streamoff               streamBegin;
+    };
+}
+#endif
@@ -1,31 +1,31 @@
-//-----------------------------------------
-//             BCCForm Ver 2.41
-//   Header File for Resource Script File
-//   Copyright (c) February 2002 by ysama
-//-----------------------------------------
-//---------------------
-//  _CAO\[X
-//---------------------
-
-//---------------------
-//  j[\[X
-//---------------------
-// j[ IDM_MENU
-#define	IDM_OPEN		100
-#define	IDM_EXIT		101
-
-//---------------------
-//  C[W\[X
-//---------------------
-
-//---------------------
-//  XgOe[u
-//---------------------
-
-//--------------------
-//  ANZ[^[
-//--------------------
-
-//------------------
-//  @[W
-//------------------
+//-----------------------------------------
+//             BCCForm Ver 2.41
+//   Header File for Resource Script File
+//   Copyright (c) February 2002 by ysama
+//-----------------------------------------
+//---------------------
+//  ダイアログリソース
+//---------------------
+
+//---------------------
+//  メニューリソース
+//---------------------
+// メニュー IDM_MENU
+#define	IDM_OPEN		100
+#define	IDM_EXIT		101
+
+//---------------------
+//  イメージリソース
+//---------------------
+
+//---------------------
+//  ストリングテーブル
+//---------------------
+
+//--------------------
+//  アクセラレーター
+//--------------------
+
+//------------------
+//  ヴァージョン情報
+//------------------
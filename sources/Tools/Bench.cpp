@@ -0,0 +1,1165 @@
+/**
+ *
+ * @file   Bench.cpp
+ * @author 村田 裕一
+ * @brief  読み込みと描画の各段階の所要時間を測り、表にして出力する。
+ *         データは大きさを指定して合成するので、どの環境でも同じ条件で測れる。
+ *
+ *///---------------------------------------------------------------------------
+#include    <cstdio>
+#include    <cstdlib>
+#include    <cstring>
+#include    <string>
+#include    <vector>
+#include    <fstream>
+#include    <sstream>
+#include    <iterator>
+#include    <algorithm>
+#include    <cmath>
+#include    "../Ploter/Loader.h"
+#include    "../Ploter/Ploter.h"
+#include    "../Ploter/Rasterizer.h"
+#include    "../Ploter/Pyramid.h"
+
+#ifndef     _WIN32
+#include    <sys/time.h>
+#endif
+
+
+namespace {
+    
+    /**
+     *
+     * @brief 経過時間を測る。
+     *
+     *///---------------------------------------------------------------------------
+    class Stopwatch {
+        
+      public:
+        
+        Stopwatch( void )  :  mStart( now() )  {}
+        
+        
+        void  restart( void ) {
+            
+            mStart = now();
+        }
+        
+        
+        double  getSeconds( void ) const {
+            
+            return  now() - mStart;
+        }
+        
+      private:
+        
+        static double  now( void ) {
+            
+          #ifdef _WIN32
+            
+            LARGE_INTEGER  count;        //  カウンタの値。
+            LARGE_INTEGER  frequency;    //  カウンタの周波数。
+            
+            QueryPerformanceCounter  ( &count     );
+            QueryPerformanceFrequency( &frequency );
+            
+            return  static_cast<double>( count.QuadPart ) / frequency.QuadPart;
+            
+          #else
+            
+            timeval  time;    //  現在の時刻。
+            
+            gettimeofday( &time,  0 );
+            
+            return  time.tv_sec  +  time.tv_usec * 1e-6;
+            
+          #endif
+        }
+        
+        double    mStart;    //  測り始めた時刻[秒]。
+    };
+    
+    
+    const int    IMAGE_SIZE  = 1024;    //  描画する画面の大きさ[画素]。3dgRenderの既定値と同じ。
+    const int    REPEAT      = 5;       //  1つの条件で描く回数。最も短い時間を採る。
+    const int    RASTER_SIZE = 2048;    //  rasterで描く画像の大きさ[画素]。
+    
+    
+    /**
+     *
+     * @brief size行size列の格子を合成する。なだらかな起伏に、孤立した山と谷を散らす。
+     *        log目盛でも使えるように、値は全て正にする。
+     *
+     *///---------------------------------------------------------------------------
+    void  makeGrid( std::size_t  size,   Ploter::GridStore&  store ) {
+        
+        store.resize( size, size );
+        
+        for ( std::size_t  j = 0;  j < size;  j++ ) {
+            
+            Ploter::Element*    z = store.row( static_cast<Ploter::Index>(j) );
+            double              y = static_cast<double>(j) / size;
+            
+            for ( std::size_t  i = 0;  i < size;  i++ ) {
+                
+                double    x = static_cast<double>(i) / size;
+                
+                z[i]  =  2.0  +  std::sin( 13.0 * x ) * std::cos( 11.0 * y )  +  0.3 * std::sin( 110.0 * x  +  77.0 * y );
+                
+                if ( ( j * 7919  +  i * 104729 ) % 10007 == 0 ) {  z[i] = ( i % 2 ) ? 4.5 : 0.2;  }
+            }
+        }
+    }
+    
+    
+    /**
+     *
+     * @brief storeを空白区切りのテキスト形式でpathに書き込む。
+     *
+     *///---------------------------------------------------------------------------
+    bool  writeTextGrid( const char*  path,   const Ploter::GridStore&  store ) {
+        
+        std::FILE*    file = std::fopen( path,  "w" );
+        
+        if ( file == 0 ) {  return  false;  }
+        
+        for ( std::size_t  j = 0;  j < store.getRowNumber();  j++ ) {
+            
+            const Ploter::Element*    z = store.row( static_cast<Ploter::Index>(j) );
+            
+            for ( std::size_t  i = 0;  i < store.getColumnNumber();  i++ ) {
+                
+                std::fprintf( file,  "%10.6f",  z[i] );
+            }
+            
+            std::fputc( '\n',  file );
+        }
+        
+        return  std::fclose( file ) == 0;
+    }
+    
+    
+    /**
+     *
+     * @brief 以前のGraph::setと同じ方法でpathを読み込む。比べるための基準。
+     *        全ての行を文字列として読み込み、行ごとにistringstreamで列数を数えてから値を読む。
+     *
+     *///---------------------------------------------------------------------------
+    bool  readByStream( const char*  path,   Ploter::GridStore&  store ) {
+        
+        typedef std::istream_iterator<Ploter::Element>    DataStreamIterator;
+        
+        std::ifstream               ifs( path );
+        std::string                 buffer;
+        std::vector<std::string>    data;
+        
+        while ( std::getline( ifs, buffer ) ) {
+            
+            data.push_back( buffer );
+        }
+        
+        if ( data.empty() ) {  return  false;  }
+        
+        std::istringstream    header( data[0] );
+        std::size_t           columnNumber = std::distance( DataStreamIterator( header ),  DataStreamIterator() );
+        
+        store.resize( data.size(),  columnNumber );
+        
+        for ( std::size_t  j = 0;  j < data.size();  j++ ) {
+            
+            std::istringstream    ds( data[j] );
+            DataStreamIterator    k( ds );
+            
+            for ( std::size_t  i = 0;  i < columnNumber;  i++,  k++ ) {
+                
+                if ( k == DataStreamIterator() ) {  return  false;  }
+                
+                store( static_cast<Ploter::Index>(j),  static_cast<Ploter::Index>(i) ) = *k;
+            }
+        }
+        
+        return  true;
+    }
+    
+    
+    /**
+     *
+     * @brief 受け取った線分を数え、座標からハッシュ値を求める描画先。
+     *        描かないので、陰線処理までの時間を測れる。ハッシュ値が等しければ同じ線分を描いたとみなす。
+     *
+     *///---------------------------------------------------------------------------
+    class CountingRenderSink : public Ploter::RenderSink {
+        
+      public:
+        
+        CountingRenderSink( void )  :  mSegmentNumber( 0 ),  mHash( 0 )  {}
+        
+        
+        void  setViewport( int,  int,  int )  {}
+        
+        
+        void  beginFrame( const Ploter::RGBA&,  Ploter::Element,  Ploter::Element ) {
+            
+            mSegmentNumber = 0;
+            mHash          = 14695981039346656037ULL;
+        }
+        
+        
+        void  drawLines( const Ploter::PointArray&  points,   const Ploter::LineStyle& ) {
+            
+            mSegmentNumber += points.size() / 2;
+            
+            for ( std::size_t  k = 0;  k < points.size();  k++ ) {
+                
+                for ( int  i = 0;  i < 2;  i++ ) {
+                    
+                    unsigned long long    word;
+                    
+                    std::memcpy( &word,  &points[k].element[i],  sizeof( word ) );
+                    
+                    mHash  =  ( mHash ^ word ) * 1099511628211ULL;
+                }
+            }
+        }
+        
+        
+        void  endFrame( void )  {}
+        
+        
+        std::size_t           getSegmentNumber( void ) const {  return  mSegmentNumber;  }
+        unsigned long long    getHash         ( void ) const {  return  mHash;           }
+        
+      private:
+        
+        std::size_t           mSegmentNumber;    //  線分の数。
+        unsigned long long    mHash;             //  座標を64ビットずつ混ぜたFNV-1a形式のハッシュ値。
+    };
+    
+    
+    /**
+     *
+     * @brief 1つの条件で描いた結果。
+     *
+     *///---------------------------------------------------------------------------
+    struct FrameResult {
+        
+        double                seconds;          //  1回の描画の最短時間[秒]。
+        std::size_t           segmentNumber;    //  描いた線分の数。
+        unsigned long long    hash;             //  描いた線分のハッシュ値。
+        std::size_t           arenaPeak;        //  最後の描画での陰線処理の一時領域の最大使用量[バイト]。
+        std::size_t           edgeNumber;       //  陰線処理に渡した線分の数。
+    };
+    
+    
+    /**
+     *
+     * @brief 整数を文字列にする。
+     *
+     *///---------------------------------------------------------------------------
+    std::string  toString( int  value ) {
+        
+        char    buffer[32];
+        
+        std::sprintf( buffer,  "%d",  value );
+        
+        return  buffer;
+    }
+    
+    
+    /**
+     *
+     * @brief optionsを公開してから、pathのグラフをCountingRenderSinkにREPEAT回描く。
+     *        毎回公開し直してオプションの世代を進めるので、頂点の操作から陰線処理までを毎回やり直す。
+     *
+     *///---------------------------------------------------------------------------
+    FrameResult  measureFrame( const char*  path,   const Ploter::OptionSnapshot&  options ) {
+        
+        boost::shared_ptr<CountingRenderSink>    sink( new CountingRenderSink );
+        Ploter::Ploter                           ploter;
+        FrameResult                              result = { 0,  0,  0,  0,  0 };
+        
+        Ploter::Option::publish( options );
+        
+        ploter.setSink( sink );
+        ploter.set    ( path );
+        ploter.resize ( IMAGE_SIZE,  IMAGE_SIZE );
+        
+        for ( int  k = 0;  k < REPEAT;  k++ ) {
+            
+            Ploter::Option::publish( options );
+            
+            Stopwatch    stopwatch;
+            
+            ploter.draw();
+            
+            double    seconds = stopwatch.getSeconds();
+            
+            if ( k == 0 || seconds < result.seconds ) {  result.seconds = seconds;  }
+        }
+        
+        result.segmentNumber = sink->getSegmentNumber();
+        result.hash          = sink->getHash();
+        result.arenaPeak     = ploter.getArenaPeak();
+        result.edgeNumber    = ploter.getEdgeNumber();
+        
+        return  result;
+    }
+    
+    
+    /**
+     *
+     * @brief optionsを公開してから、pathのグラフを1回描き、走査線の帯ごとに査定した点の数を返す。
+     *
+     *///---------------------------------------------------------------------------
+    std::vector<std::size_t>  measureStripLoads( const char*  path,   const Ploter::OptionSnapshot&  options ) {
+        
+        boost::shared_ptr<CountingRenderSink>    sink( new CountingRenderSink );
+        Ploter::Ploter                           ploter;
+        
+        Ploter::Option::publish( options );
+        
+        ploter.setSink( sink );
+        ploter.set    ( path );
+        ploter.resize ( IMAGE_SIZE,  IMAGE_SIZE );
+        ploter.draw   ();
+        
+        return  ploter.getStripLoads();
+    }
+    
+    
+    /**
+     *
+     * @brief グラフのフラグの全ての組み合わせ。組み合わせごとに1回の描画の時間と描いた線分の数を出力する。
+     *        フラグは隠線処理、水平な軸、log目盛、x軸方向・y軸方向の正規化の5つ。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchFlags( const char*  path ) {
+        
+        static const char*    NAMES[][2] = {
+            { "graph",   "isHiddenLine"   },
+            { "affine",  "horizontalAxis" },
+            { "graph",   "isLogScale"     },
+            { "graph",   "isRegularizeX"  },
+            { "graph",   "isRegularizeY"  },
+        };
+        
+        const int    FLAG_NUMBER = sizeof( NAMES ) / sizeof( NAMES[0] );
+        
+        std::printf( "flags: 隠線処理・水平な軸・log目盛・x正規化・y正規化の組み合わせ\n" );
+        std::printf( "%-8s %10s %12s %18s\n",  "フラグ",  "frame[ms]",  "線分",  "ハッシュ値" );
+        
+        for ( int  mask = 0;  mask < ( 1 << FLAG_NUMBER );  mask++ ) {
+            
+            Ploter::OptionSnapshot    options( "option.ini" );
+            std::string               flags;
+            
+            for ( int  k = 0;  k < FLAG_NUMBER;  k++ ) {
+                
+                int    value = ( mask >> k ) & 1;
+                
+                options.set( NAMES[k][0],  NAMES[k][1],  toString( value ) );
+                
+                flags += value ? '1' : '0';
+            }
+            
+            FrameResult    result = measureFrame( path,  options );
+            
+            std::printf( "%-8s %10.1f %12lu %18llx\n",  flags.c_str(),  result.seconds * 1000,  static_cast<unsigned long>( result.segmentNumber ),  result.hash );
+        }
+    }
+    
+    
+    /**
+     *
+     * @brief オプションの1つのキーの値を変えた条件。
+     *
+     *///---------------------------------------------------------------------------
+    struct Variant {
+        
+        const char*    label;      //  表に出す名前。
+        const char*    section;    //  セクション名。
+        const char*    key;        //  キー名。
+        const char*    value;      //  値。
+    };
+    
+    
+    /**
+     *
+     * @brief pathsの各グラフを、baseの1つのキーをvariantsの条件ごとに変えて描く。1回の描画の時間・線分の数・ハッシュ値と、
+     *        最初の条件に対する速さの比、最初の条件と同じ線分を描いたかどうか、1回の描画での陰線処理の一時領域の最大使用量、
+     *        陰線処理に渡した線分の数と、最初の条件に対するその減り方の比を出力する。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchVariants( const char*  title,   const std::vector<std::string>&  paths,   const Ploter::OptionSnapshot&  base,
+                         const Variant*  variants,   std::size_t  variantNumber ) {
+        
+        std::printf( "%s\n",  title );
+        std::printf( "%-24s %-12s %10s %8s %12s %18s %4s %10s %12s %8s\n",  "ファイル",  "条件",  "frame[ms]",  "比",  "線分",  "ハッシュ値",  "一致",  "arena[KB]",  "入力線分",  "削減" );
+        
+        for ( std::size_t  k = 0;  k < paths.size();  k++ ) {
+            
+            FrameResult    first = { 0,  0,  0,  0,  0 };
+            
+            for ( std::size_t  v = 0;  v < variantNumber;  v++ ) {
+                
+                Ploter::OptionSnapshot    options( base );
+                
+                options.set( variants[v].section,  variants[v].key,  variants[v].value );
+                
+                FrameResult    result = measureFrame( paths[k].c_str(),  options );
+                
+                if ( v == 0 ) {  first = result;  }
+                
+                std::printf( "%-24s %-12s %10.1f %8.2f %12lu %18llx %4s %10lu %12lu %8.1f\n",
+                             paths[k].c_str(),  variants[v].label,  result.seconds * 1000,  first.seconds / result.seconds,
+                             static_cast<unsigned long>( result.segmentNumber ),  result.hash,  ( result.hash == first.hash ) ? "yes" : "no",
+                             static_cast<unsigned long>( result.arenaPeak / 1024 ),  static_cast<unsigned long>( result.edgeNumber ),
+                             static_cast<double>( first.edgeNumber ) / std::max( result.edgeNumber,  std::size_t( 1 ) ) );
+            }
+        }
+    }
+    
+    
+    /**
+     *
+     * @brief 隠線処理の方法。走査線・区分線形の水平線・zバッファを比べる。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchHorizon( const std::vector<std::string>&  paths ) {
+        
+        static const Variant    VARIANTS[] = {
+            { "走査線",    "graph",  "hiddenLineMethod",  "0" },
+            { "水平線",    "graph",  "hiddenLineMethod",  "1" },
+            { "zバッファ", "graph",  "hiddenLineMethod",  "2" },
+        };
+        
+        benchVariants( "horizon: 隠線処理の方法",  paths,  Ploter::OptionSnapshot( "option.ini" ),  VARIANTS,  sizeof( VARIANTS ) / sizeof( VARIANTS[0] ) );
+    }
+    
+    
+    /**
+     *
+     * @brief 走査線による隠線処理の帯の数。帯ごとのスレッドの数を変え、1つの場合と同じ線分を描くかを調べる。
+     *        このプロセッサの数も出力する。プロセッサが帯より少ないと帯の数だけ速くはならないので、
+     *        帯ごとに査定した点の数と、その合計と最大の比も出力する。この比が、帯の数だけプロセッサがある場合の速さの比の上限になる。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchStrips( const std::vector<std::string>&  paths ) {
+        
+        static const Variant    VARIANTS[] = {
+            { "1スレッド",   "graph",  "hiddenLineThreads",  "1"  },
+            { "2スレッド",   "graph",  "hiddenLineThreads",  "2"  },
+            { "4スレッド",   "graph",  "hiddenLineThreads",  "4"  },
+            { "8スレッド",   "graph",  "hiddenLineThreads",  "8"  },
+            { "16スレッド",  "graph",  "hiddenLineThreads",  "16" },
+            { "32スレッド",  "graph",  "hiddenLineThreads",  "32" },
+        };
+        
+        Ploter::OptionSnapshot    base( "option.ini" );
+        char                      title[128];
+        
+        base.set( "graph",  "isHiddenLine",      "1" );
+        base.set( "graph",  "hiddenLineMethod",  "0" );
+        
+        std::sprintf( title,  "strips: 走査線の帯の数 (プロセッサの数:%lu)",  static_cast<unsigned long>( Ploter::getProcessorNumber() ) );
+        
+        benchVariants( title,  paths,  base,  VARIANTS,  sizeof( VARIANTS ) / sizeof( VARIANTS[0] ) );
+        
+        std::printf( "strips: 帯ごとに査定した点の数\n" );
+        std::printf( "%-24s %-12s %4s %12s %12s %8s  %s\n",  "ファイル",  "条件",  "帯",  "合計",  "最大",  "上限比",  "帯ごと" );
+        
+        for ( std::size_t  k = 0;  k < paths.size();  k++ ) {
+            
+            for ( std::size_t  v = 0;  v < sizeof( VARIANTS ) / sizeof( VARIANTS[0] );  v++ ) {
+                
+                Ploter::OptionSnapshot    options( base );
+                
+                options.set( VARIANTS[v].section,  VARIANTS[v].key,  VARIANTS[v].value );
+                
+                std::vector<std::size_t>  loads = measureStripLoads( paths[k].c_str(),  options );
+                std::size_t               total = 0,  maximum = 0;
+                std::string               parts;
+                char                      part[32];
+                
+                for ( std::size_t  s = 0;  s < loads.size();  s++ ) {
+                    
+                    std::sprintf( part,  ( s > 0 ) ? " %lu" : "%lu",  static_cast<unsigned long>( loads[s] ) );
+                    
+                    total   += loads[s];
+                    maximum  = std::max( maximum,  loads[s] );
+                    parts   += part;
+                }
+                
+                std::printf( "%-24s %-12s %4lu %12lu %12lu %8.2f  %s\n",
+                             paths[k].c_str(),  VARIANTS[v].label,  static_cast<unsigned long>( loads.size() ),
+                             static_cast<unsigned long>( total ),  static_cast<unsigned long>( maximum ),
+                             ( maximum > 0 ) ? static_cast<double>( total ) / maximum : 1.0,  loads.empty() ? "-" : parts.c_str() );
+            }
+        }
+    }
+    
+    
+    /**
+     *
+     * @brief 陰線処理の前にポリラインを間引く許容誤差。隠線処理の方法ごとに、線分の減り方と1回の描画の時間を比べる。
+     *        走査線は1画素に1本置く。頂点ごとに置くと、細かい格子では間引いても走査線と残す点がメモリに収まらない。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchSimplify( const std::vector<std::string>&  paths ) {
+        
+        static const Variant    VARIANTS[] = {
+            { "間引かない",  "graph",  "simplifyTolerance",  "0"  },
+            { "0.2画素",     "graph",  "simplifyTolerance",  "2"  },
+            { "0.5画素",     "graph",  "simplifyTolerance",  "5"  },
+            { "1画素",       "graph",  "simplifyTolerance",  "10" },
+        };
+        
+        static const char*    METHODS[][2] = {
+            { "0",  "simplify: ポリラインを間引く許容誤差 (走査線)"    },
+            { "1",  "simplify: ポリラインを間引く許容誤差 (水平線)"    },
+            { "2",  "simplify: ポリラインを間引く許容誤差 (zバッファ)" },
+        };
+        
+        for ( std::size_t  k = 0;  k < sizeof( METHODS ) / sizeof( METHODS[0] );  k++ ) {
+            
+            Ploter::OptionSnapshot    base( "option.ini" );
+            
+            base.set( "graph",  "isHiddenLine",      "1"           );
+            base.set( "graph",  "hiddenLineMethod",  METHODS[k][0] );
+            base.set( "graph",  "scanLineDensity",   "1"           );
+            
+            benchVariants( METHODS[k][1],  paths,  base,  VARIANTS,  sizeof( VARIANTS ) / sizeof( VARIANTS[0] ) );
+        }
+    }
+    
+    
+    /**
+     *
+     * @brief 画素の列のFNV-1a形式のハッシュ値。
+     *
+     *///---------------------------------------------------------------------------
+    unsigned long long  hashPixels( const std::vector<unsigned char>&  pixels ) {
+        
+        unsigned long long    hash = 14695981039346656037ULL;
+        
+        for ( std::size_t  k = 0;  k < pixels.size();  k++ ) {
+            
+            hash  =  ( hash ^ pixels[k] ) * 1099511628211ULL;
+        }
+        
+        return  hash;
+    }
+    
+    
+    /**
+     *
+     * @brief SoftwareRenderSinkに描き、描画先の中で掛かった時間と線分の数を数える描画先。
+     *        描画全体の時間から引けば、頂点の操作と陰線処理に掛かった時間が分かる。
+     *
+     *///---------------------------------------------------------------------------
+    class TimingRenderSink : public Ploter::RenderSink {
+        
+      public:
+        
+        TimingRenderSink( int  size,   std::size_t  threadNumber )  :  mRaster( size,  size,  threadNumber ),  mSeconds( 0 ),  mSegmentNumber( 0 )  {}
+        
+        
+        void  setViewport( int  x,   int  y,   int  size ) {
+            
+            mRaster.setViewport( x,  y,  size );
+        }
+        
+        
+        void  beginFrame( const Ploter::RGBA&  background,   Ploter::Element  minimum,   Ploter::Element  maximum ) {
+            
+            Stopwatch    stopwatch;
+            
+            mRaster.beginFrame( background,  minimum,  maximum );
+            
+            mSeconds       = stopwatch.getSeconds();
+            mSegmentNumber = 0;
+        }
+        
+        
+        void  drawLines( const Ploter::PointArray&  points,   const Ploter::LineStyle&  style ) {
+            
+            Stopwatch    stopwatch;
+            
+            mRaster.drawLines( points,  style );
+            
+            mSeconds       += stopwatch.getSeconds();
+            mSegmentNumber += points.size() / 2;
+        }
+        
+        
+        void  endFrame( void ) {
+            
+            Stopwatch    stopwatch;
+            
+            mRaster.endFrame();
+            
+            mSeconds += stopwatch.getSeconds();
+        }
+        
+        
+        double                getSeconds      ( void ) const {  return  mSeconds;                       }
+        std::size_t           getSegmentNumber( void ) const {  return  mSegmentNumber;                 }
+        unsigned long long    getHash         ( void ) const {  return  hashPixels( mRaster.getPixels() );  }
+        
+      private:
+        
+        Ploter::SoftwareRenderSink    mRaster;           //  実際に描く描画先。
+        double                        mSeconds;          //  描画先の中で掛かった時間[秒]。
+        std::size_t                   mSegmentNumber;    //  受け取った線分の数。
+    };
+    
+    
+    /**
+     *
+     * @brief storeの格子を斜めから見たポリラインを、SoftwareRenderSinkに直接描く。
+     *        スレッドの数と滑らかにするかどうかを変え、線分の速さと、1スレッドの場合と同じ画像になるかを出力する。
+     *        ポリラインは描く前に作るので、描画先の中の時間だけを測る。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchRasterLines( const Ploter::GridStore&  store ) {
+        
+        static const std::size_t    THREADS[] = { 1,  2,  4,  8 };
+        
+        const std::size_t    THREAD_NUMBER = sizeof( THREADS ) / sizeof( THREADS[0] );
+        
+        std::size_t    rowNumber    = store.getRowNumber();
+        std::size_t    columnNumber = store.getColumnNumber();
+        
+        std::printf( "raster: %lux%luの格子を%dx%dの画像に直接描く (プロセッサの数:%lu)\n",
+                     static_cast<unsigned long>( rowNumber ),  static_cast<unsigned long>( columnNumber ),  RASTER_SIZE,  RASTER_SIZE,
+                     static_cast<unsigned long>( Ploter::getProcessorNumber() ) );
+        std::printf( "%-8s %-10s %12s %12s %10s %18s %4s\n",  "線",  "スレッド",  "線分",  "raster[ms]",  "M線分/s",  "ハッシュ値",  "一致" );
+        
+        for ( int  smooth = 1;  smooth >= 0;  smooth-- ) {
+            
+            Ploter::LineStyle     style( Ploter::RGBA( 0.0, 0.0, 0.0, 0.7 ),  Ploter::LineStyle::SOLID,  smooth != 0 );
+            unsigned long long    first = 0;
+            
+            for ( std::size_t  t = 0;  t < THREAD_NUMBER;  t++ ) {
+                
+                Ploter::SoftwareRenderSink    sink( RASTER_SIZE,  RASTER_SIZE,  THREADS[t] );
+                Ploter::PointArray            points;
+                std::size_t                   segmentNumber = 0;
+                double                        seconds       = 0;
+                
+                sink.setViewport( 0,  0,  RASTER_SIZE );
+                sink.beginFrame ( Ploter::RGBA( 1.0, 1.0, 1.0, 1.0 ),  0,  1.1 );
+                
+                for ( int  direction = 0;  direction < 2;  direction++ ) {
+                    
+                    std::size_t    lineNumber  = direction ? columnNumber : rowNumber;
+                    std::size_t    pointNumber = direction ? rowNumber    : columnNumber;
+                    
+                    for ( std::size_t  n = 0;  n < lineNumber;  n++ ) {
+                        
+                        points.clear();
+                        
+                        for ( std::size_t  m = 0;  m + 1 < pointNumber;  m++ ) {
+                            
+                            for ( std::size_t  e = m;  e <= m + 1;  e++ ) {
+                                
+                                std::size_t       j = direction ? e : n,  i = direction ? n : e;
+                                double            x = static_cast<double>(i) / columnNumber,  y = static_cast<double>(j) / rowNumber;
+                                Ploter::Point2    point;
+                                
+                                point( Ploter::X ) = 0.1  +  0.6 * x  +  0.3 * y;
+                                point( Ploter::Y ) = 0.1  +  0.3 * y  +  0.15 * store( static_cast<Ploter::Index>(j),  static_cast<Ploter::Index>(i) );
+                                
+                                points.push_back( point );
+                            }
+                        }
+                        
+                        Stopwatch    stopwatch;
+                        
+                        sink.drawLines( points,  style );
+                        
+                        seconds       += stopwatch.getSeconds();
+                        segmentNumber += points.size() / 2;
+                    }
+                }
+                
+                Stopwatch    stopwatch;
+                
+                sink.endFrame();
+                
+                seconds += stopwatch.getSeconds();
+                
+                unsigned long long    hash = hashPixels( sink.getPixels() );
+                
+                if ( t == 0 ) {  first = hash;  }
+                
+                std::printf( "%-8s %-10lu %12lu %12.1f %10.2f %18llx %4s\n",
+                             smooth ? "滑らか" : "ギザギザ",  static_cast<unsigned long>( THREADS[t] ),  static_cast<unsigned long>( segmentNumber ),
+                             seconds * 1000,  segmentNumber / seconds * 1e-6,  hash,  ( hash == first ) ? "yes" : "no" );
+            }
+        }
+    }
+    
+    
+    /**
+     *
+     * @brief pathのグラフをRASTER_SIZEの画像に描く。読み込みと、隠線処理と間引きの条件ごとの1回の描画の時間を出力する。
+     *        描画の時間は頂点の操作と陰線処理の分と、描画先の中の分に分ける。スレッドの数はプロセッサの数にする。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchRasterFrames( const std::vector<std::string>&  paths ) {
+        
+        struct Condition {
+            
+            const char*    label;                //  表に出す名前。
+            const char*    isHiddenLine;         //  graph.isHiddenLineの値。
+            const char*    decimationSpacing;    //  graph.decimationSpacingの値。
+        };
+        
+        static const Condition    CONDITIONS[] = {
+            { "隠線なし",       "0",  "0" },
+            { "隠線なし間引き", "0",  "1" },
+            { "水平線",         "1",  "0" },
+            { "水平線間引き",   "1",  "1" },
+        };
+        
+        std::printf( "raster: %dx%dの画像に描く1回の描画 (隠線処理は区分線形の水平線)\n",  RASTER_SIZE,  RASTER_SIZE );
+        std::printf( "%-24s %-16s %10s %10s %10s %10s %12s %18s\n",  "ファイル",  "条件",  "load[ms]",  "frame[ms]",  "陰線[ms]",  "raster[ms]",  "線分",  "ハッシュ値" );
+        
+        for ( std::size_t  k = 0;  k < paths.size();  k++ ) {
+            
+            for ( std::size_t  c = 0;  c < sizeof( CONDITIONS ) / sizeof( CONDITIONS[0] );  c++ ) {
+                
+                Ploter::OptionSnapshot    options( "option.ini" );
+                
+                options.set( "graph",  "isHiddenLine",       CONDITIONS[c].isHiddenLine      );
+                options.set( "graph",  "hiddenLineMethod",   "1"                             );
+                options.set( "graph",  "decimationSpacing",  CONDITIONS[c].decimationSpacing );
+                options.set( "graph",  "lodVertexBudget",    "0"                             );
+                
+                Ploter::Option::publish( options );
+                
+                boost::shared_ptr<TimingRenderSink>    sink( new TimingRenderSink( RASTER_SIZE,  0 ) );
+                Ploter::Ploter                         ploter;
+                Stopwatch                              stopwatch;
+                
+                ploter.setSink( sink );
+                
+                if ( ! ploter.set( paths[k].c_str() ) ) {
+                    
+                    std::printf( "%-24s 読み込めません。\n",  paths[k].c_str() );
+                    
+                    break;
+                }
+                
+                double    loadTime = stopwatch.getSeconds();
+                
+                ploter.resize( RASTER_SIZE,  RASTER_SIZE );
+                
+                Ploter::Option::publish( options );
+                
+                stopwatch.restart();
+                
+                ploter.draw();
+                
+                double    frameTime = stopwatch.getSeconds();
+                
+                std::printf( "%-24s %-16s %10.1f %10.1f %10.1f %10.1f %12lu %18llx\n",
+                             paths[k].c_str(),  CONDITIONS[c].label,  loadTime * 1000,  frameTime * 1000,  ( frameTime - sink->getSeconds() ) * 1000,
+                             sink->getSeconds() * 1000,  static_cast<unsigned long>( sink->getSegmentNumber() ),  sink->getHash() );
+            }
+        }
+    }
+    
+    
+    /**
+     *
+     * @brief ファイルの大きさ[MB]。
+     *
+     *///---------------------------------------------------------------------------
+    double  getMegaBytes( const char*  path ) {
+        
+        std::ifstream    ifs( path,  std::ios::binary | std::ios::ate );
+        
+        return  ifs  ?  static_cast<double>( ifs.tellg() ) / ( 1024 * 1024 )  :  0;
+    }
+    
+    
+    /**
+     *
+     * @brief テキスト形式の読み込み。以前の方法とGridLoaderの所要時間と速度を比べ、値が一致するかを調べる。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchLoad( const std::vector<std::string>&  paths ) {
+        
+        std::printf( "load: テキスト形式の読み込み\n" );
+        std::printf( "%-24s %9s %12s %12s %10s %10s %8s %s\n",  "ファイル",  "MB",  "行x列",  "stream[s]",  "MB/s",  "mmap[s]",  "MB/s",  "一致" );
+        
+        for ( std::size_t  k = 0;  k < paths.size();  k++ ) {
+            
+            const char*          path = paths[k].c_str();
+            double               size = getMegaBytes( path );
+            Ploter::GridStore    expected;
+            Ploter::GridStore    actual;
+            Stopwatch            stopwatch;
+            
+            if ( ! readByStream( path,  expected ) ) {
+                
+                std::printf( "%-24s 読み込めません。\n",  path );
+                
+                continue;
+            }
+            
+            double    streamTime = stopwatch.getSeconds();
+            
+            stopwatch.restart();
+            
+            Ploter::GridLoader    loader;
+            bool                  isRead = loader.open( path )  &&  loader.read( actual );
+            double                mmapTime = stopwatch.getSeconds();
+            
+            bool    isSame = isRead
+                          && actual.getSize() == expected.getSize()
+                          && std::equal( actual.begin(),  actual.end(),  expected.begin() );
+            
+            char    shape[32];
+            
+            std::sprintf( shape,  "%lux%lu",  static_cast<unsigned long>( expected.getRowNumber() ),  static_cast<unsigned long>( expected.getColumnNumber() ) );
+            
+            std::printf( "%-24s %9.1f %12s %12.3f %10.1f %10.3f %8.1f %s\n",
+                         path,  size,  shape,  streamTime,  size / streamTime,  mmapTime,  size / mmapTime,  isSame ? "yes" : "NO" );
+        }
+    }
+    
+    
+    /**
+     *
+     * @brief 別のスレッドでploterを1段細かくする。3dGraphが細かくする時と同じ。
+     *
+     *///---------------------------------------------------------------------------
+    struct RefineTask {
+        
+        static void  run( void*  task ) {
+            
+            RefineTask*    self = static_cast<RefineTask*>( task );
+            
+            self->isRefined = self->ploter->prepareRefine();
+        }
+        
+        const Ploter::Ploter*    ploter;       //  細かくするプロッタ。
+        bool                     isRefined;    //  1段細かくしたか。
+    };
+    
+    
+    /**
+     *
+     * @brief lodVertexBudgetをbudget[千頂点]にして、pathのグラフをzバッファの隠線処理で描く。
+     *        最初の描画と、元の格子か画面の解像度に達するまで1段ずつ細かくした各描画の時間と線分の数を出力する。
+     *        細かくする段は3dGraphと同じく、陰線処理までを別のスレッドで行い、描画だけを呼び出したスレッドで行う。
+     *
+     *///---------------------------------------------------------------------------
+    void  measureRefine( const char*  label,   const char*  path,   int  budget ) {
+        
+        Ploter::OptionSnapshot    options( "option.ini" );
+        
+        options.set( "graph",  "isHiddenLine",      "1"                );
+        options.set( "graph",  "hiddenLineMethod",  "2"                );
+        options.set( "graph",  "lodVertexBudget",   toString( budget ) );
+        
+        Ploter::Option::publish( options );
+        
+        boost::shared_ptr<CountingRenderSink>    sink( new CountingRenderSink );
+        Ploter::Ploter                           ploter;
+        Stopwatch                                stopwatch;
+        
+        ploter.setSink( sink );
+        ploter.set    ( path );
+        ploter.resize ( IMAGE_SIZE,  IMAGE_SIZE );
+        
+        double    seconds = stopwatch.getSeconds();
+        
+        std::printf( "%-12s %-10s %10.1f %10.1f %12lu\n",  label,  "最初",  seconds * 1000,  seconds * 1000,  static_cast<unsigned long>( sink->getSegmentNumber() ) );
+        
+        for ( int  step = 1;  ;  step++ ) {
+            
+            RefineTask       task = {  &ploter,  false  };
+            Ploter::Thread   thread;
+            
+            stopwatch.restart();
+            
+            thread.start( &RefineTask::run,  &task );
+            thread.join ();
+            
+            if ( ! task.isRefined ) {  break;  }
+            
+            double    refineTime = stopwatch.getSeconds();
+            
+            stopwatch.restart();
+            
+            ploter.draw();
+            
+            double    drawTime = stopwatch.getSeconds();
+            
+            std::printf( "%-12s %-10s %10.1f %10.1f %12lu\n",  label,  ( toString( step ) + "段目" ).c_str(),
+                         ( refineTime + drawTime ) * 1000,  drawTime * 1000,  static_cast<unsigned long>( sink->getSegmentNumber() ) );
+        }
+    }
+    
+    
+    /**
+     *
+     * @brief ピラミッドによる段階的な描画。3dgConvertと同じくキャッシュファイルを書き出し、
+     *        元の格子・キャッシュから読み込んだピラミッド・メモリ上で作ったピラミッドで、最初の描画と細かくする各段の時間を比べる。
+     *        データファイルを書き換えた後にキャッシュファイルを使わないことも確かめる。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchLod( const char*  path,   const Ploter::GridStore&  store ) {
+        
+        const int    BUDGET = 250;    //  最初に描く格子の頂点数の上限[千頂点]。
+        
+        Ploter::GridPyramid    pyramid;
+        Stopwatch              stopwatch;
+        
+        pyramid.build( store,  0 );
+        
+        double    buildTime = stopwatch.getSeconds();
+        
+        std::string    cachePath = Ploter::GridPyramid::getCachePath( path );
+        
+        if ( ! pyramid.save( path ) ) {
+            
+            std::printf( "ファイルに書き込めません。 -- %s\n",  cachePath.c_str() );
+            
+            return;
+        }
+        
+        bool    isFresh = Ploter::GridPyramid().load( path,  store );
+        
+        std::printf( "lod: ピラミッドによる段階的な描画 (%lux%lu、zバッファ、上限%d千頂点)\n",
+                     static_cast<unsigned long>( store.getRowNumber() ),  static_cast<unsigned long>( store.getColumnNumber() ),  BUDGET );
+        std::printf( "ピラミッドの作成 %.1f ms、%lu段、キャッシュ %.1f MB\n",
+                     buildTime * 1000,  static_cast<unsigned long>( pyramid.getLevelNumber() ),  getMegaBytes( cachePath.c_str() ) );
+        std::printf( "%-12s %-10s %10s %10s %12s\n",  "条件",  "描画",  "frame[ms]",  "UI[ms]",  "線分" );
+        
+        measureRefine( "元の格子",    path,  0      );
+        measureRefine( "キャッシュ",  path,  BUDGET );
+        
+        Ploter::writeBinaryGrid( path,  store );
+        
+        bool    isStale = ! Ploter::GridPyramid().load( path,  store );
+        
+        measureRefine( "作り直し",    path,  BUDGET );
+        
+        std::printf( "キャッシュの検証: 書き出した直後に使う %s、データファイルを書き換えた後に使わない %s\n",  isFresh ? "yes" : "NO",  isStale ? "yes" : "NO" );
+        
+        std::remove( cachePath.c_str() );
+    }
+    
+    
+    /**
+     *
+     * @brief 格子の座標変換。頂点を1つずつ4x4行列で写す方法(行ごとの関数を作る前の方法)と、
+     *        行ごとの各関数とtransformの時間を比べ、スカラ演算と同じ結果になるかを出力する。
+     *
+     *///---------------------------------------------------------------------------
+    void  benchTransform( const Ploter::GridStore&  store ) {
+        
+        using  Ploter::Element;
+        using  Ploter::Index;
+        
+        Ploter::Matrix    affine  = Ploter::translate( Ploter::v( 0.1, 0.1, 0 ) )
+                                  * Ploter::scale( 0.6 / store.getColumnNumber(),  0.3 / store.getRowNumber(),  0.15 );
+        
+        affine( Ploter::X, Ploter::Y ) = 0.3 / store.getRowNumber();
+        
+        const Ploter::Affine2    screen = Ploter::toScreen( affine );
+        
+        std::size_t    rowNumber    = store.getRowNumber();
+        std::size_t    columnNumber = store.getColumnNumber();
+        std::size_t    vertexNumber = store.getSize();
+        
+        
+        struct Kernel {
+            
+            const char*                name;       //  表に出す名前。
+            Ploter::TransformKernel    kernel;     //  行ごとの関数。0ならtransformを使う。
+            bool                       isUsable;   //  このCPUで使えるか。
+        };
+        
+        int    simd = Ploter::detectSimd();
+        
+        const Kernel    KERNELS[] = {
+            {  "スカラ",         &Ploter::transformRowScalar,  true                          },
+          #ifdef PLOTER_USE_SSE2
+            {  "SSE2",           &Ploter::transformRowSse2,    simd >= Ploter::SIMD_SSE2     },
+            {  "SSE2(直接)",     &Ploter::transformRowStream,  simd >= Ploter::SIMD_SSE2     },
+          #endif
+          #ifdef PLOTER_USE_AVX
+            {  "AVX",            &Ploter::transformRowAvx,     simd >= Ploter::SIMD_AVX      },
+          #endif
+            {  "transform",      0,                            true                          },
+        };
+        
+        const std::size_t    KERNEL_NUMBER = sizeof( KERNELS ) / sizeof( KERNELS[0] );
+        
+        
+        std::printf( "transform: %lux%luの格子の座標変換 (SIMD:%s)\n",
+                     static_cast<unsigned long>( rowNumber ),  static_cast<unsigned long>( columnNumber ),
+                     ( simd == Ploter::SIMD_AVX ) ? "AVX" : ( simd == Ploter::SIMD_SSE2 ) ? "SSE2" : "なし" );
+        std::printf( "%-16s %12s %12s %8s %4s\n",  "方法",  "時間[ms]",  "M頂点/s",  "倍率",  "一致" );
+        
+        double    baseTime = 1e30;
+        
+        {
+            Ploter::VertexList    vertices( vertexNumber );
+            
+            for ( std::size_t  j = 0;  j < rowNumber;  j++ ) {
+                
+                for ( std::size_t  i = 0;  i < columnNumber;  i++ ) {
+                    
+                    vertices[ j * columnNumber + i ] = Ploter::v( static_cast<Element>(i),  static_cast<Element>(j),  store( static_cast<Index>(j),  static_cast<Index>(i) ) );
+                }
+            }
+            
+            for ( int  r = 0;  r < REPEAT;  r++ ) {
+                
+                Stopwatch    stopwatch;
+                
+                for ( std::size_t  k = 0;  k < vertexNumber;  k++ ) {  vertices[k] = affine * ( vertices[k] + Ploter::V::W_UNIT );  }
+                
+                baseTime = std::min( baseTime,  stopwatch.getSeconds() );
+                
+                for ( std::size_t  k = 0;  k < vertexNumber;  k++ ) {  vertices[k]( Ploter::W ) = 0;  }
+            }
+            
+            std::printf( "%-16s %12.1f %12.1f %8.2f %4s\n",  "頂点ごと",  baseTime * 1000,  vertexNumber / baseTime * 1e-6,  1.0,  "-" );
+        }
+        
+        Ploter::PointArray    expected;
+        Ploter::PointArray    points( vertexNumber );
+        
+        for ( std::size_t  n = 0;  n < KERNEL_NUMBER;  n++ ) {
+            
+            if ( ! KERNELS[n].isUsable ) {  continue;  }
+            
+            double    seconds = 1e30;
+            
+            for ( int  r = 0;  r < REPEAT;  r++ ) {
+                
+                Stopwatch    stopwatch;
+                
+                if ( KERNELS[n].kernel ) {
+                    
+                    for ( std::size_t  j = 0;  j < rowNumber;  j++ ) {
+                        
+                        KERNELS[n].kernel( screen,  0,  static_cast<Element>(j),  store.row( static_cast<Index>(j) ),  columnNumber,  &points[ j * columnNumber ] );
+                    }
+                    
+                  #ifdef PLOTER_USE_SSE2
+                    _mm_sfence();
+                  #endif
+                }
+                else {
+                    
+                    Ploter::transform( affine,  store,  points );
+                }
+                
+                seconds = std::min( seconds,  stopwatch.getSeconds() );
+            }
+            
+            if ( n == 0 ) {  expected = points;  }
+            
+            bool    isSame = ( std::memcmp( &expected[0],  &points[0],  vertexNumber * sizeof( Ploter::Point2 ) ) == 0 );
+            
+            std::printf( "%-16s %12.1f %12.1f %8.2f %4s\n",
+                         KERNELS[n].name,  seconds * 1000,  vertexNumber / seconds * 1e-6,  baseTime / seconds,  isSame ? "yes" : "no" );
+        }
+    }
+}
+
+
+/**
+ *
+ * @brief メイン関数。
+ *
+ *///---------------------------------------------------------------------------
+int  main( int  argumentNumber,   char**  arguments ) {
+    
+    if ( argumentNumber < 2 ) {
+        
+        std::fprintf( stderr,  "使い方 : 3dgBench 項目(load|flags|horizon|strips|arena|simplify|raster|lod|transform) [格子の大きさ(既定値:loadは2000、simplify・raster・lod・transformは4096、それ以外は200)] [データファイル...]\n" );
+        
+        return  1;
+    }
+    
+    
+    std::string                 item = arguments[1];
+    std::size_t                 size = ( argumentNumber > 2 )  ?  std::atoi( arguments[2] )  :  ( item == "load" ) ? 2000 : ( item == "simplify" || item == "raster" || item == "lod" || item == "transform" ) ? 4096 : 200;
+    std::vector<std::string>    paths( arguments + std::min( argumentNumber, 3 ),  arguments + argumentNumber );
+    
+    if ( size < 2 ) {
+        
+        std::fprintf( stderr,  "格子の大きさが不正です。 -- %s\n",  arguments[2] );
+        
+        return  1;
+    }
+    
+    
+    Ploter::GridStore    store;
+    
+    makeGrid( size,  store );
+    
+    
+    if ( item == "load" ) {
+        
+        const char*    textPath = "3dgBench.txt";
+        
+        if ( ! writeTextGrid( textPath,  store ) ) {
+            
+            std::fprintf( stderr,  "ファイルに書き込めません。 -- %s\n",  textPath );
+            
+            return  1;
+        }
+        
+        paths.insert( paths.begin(),  textPath );
+        
+        benchLoad( paths );
+        
+        std::remove( textPath );
+    }
+    else if ( item == "transform" ) {
+        
+        benchTransform( store );
+    }
+    else if ( item == "flags" || item == "horizon" || item == "strips" || item == "arena" || item == "simplify" || item == "raster" || item == "lod" ) {
+        
+        const char*    binaryPath = "3dgBench.3dg";
+        
+        if ( ! Ploter::writeBinaryGrid( binaryPath,  store ) ) {
+            
+            std::fprintf( stderr,  "ファイルに書き込めません。 -- %s\n",  binaryPath );
+            
+            return  1;
+        }
+        
+        paths.insert( paths.begin(),  binaryPath );
+        
+        if      ( item == "flags"    ) {  benchFlags       ( binaryPath );  }
+        else if ( item == "horizon"  ) {  benchHorizon     ( paths      );  }
+        else if ( item == "strips"   ) {  benchStrips      ( paths      );  }
+        else if ( item == "arena"    ) {  benchHorizon     ( paths      );  benchStrips( paths );  }
+        else if ( item == "simplify" ) {  benchSimplify    ( paths      );  }
+        else if ( item == "raster"   ) {  benchRasterLines ( store      );  benchRasterFrames( paths );  }
+        else if ( item == "lod"      ) {  benchLod         ( binaryPath,  store );  }
+        
+        std::remove( binaryPath );
+    }
+    else {
+        
+        std::fprintf( stderr,  "項目が不正です。 -- %s\n",  item.c_str() );
+        
+        return  1;
+    }
+    
+    return  0;
+}
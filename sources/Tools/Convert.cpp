@@ -0,0 +1,71 @@
+/**
+ * 
+ * @file   Convert.cpp
+ * @author 村田 裕一
+ * @brief  テキスト形式のデータファイルをバイナリ形式(.3dg)に変換する。
+ *         段階的に描くためのピラミッドも、キャッシュファイル(.3dg.lod)に書き出す。
+ *         キャッシュファイルには書き出した.3dgの更新時刻とサイズを記録し、.3dgを書き換えると使われなくなる。
+ * 
+ *///---------------------------------------------------------------------------
+#include    <cstdio>
+#include    "../Ploter/Loader.h"
+#include    "../Ploter/Pyramid.h"
+
+
+/**
+ *
+ * @brief メイン関数。
+ *
+ *///---------------------------------------------------------------------------
+int  main( int  argumentNumber,   char**  arguments ) {
+    
+    if ( argumentNumber != 3 ) {
+        
+        std::fprintf( stderr,  "使い方 : 3dgConvert 入力ファイル(*.txt) 出力ファイル(*.3dg)\n" );
+        
+        return  1;
+    }
+    
+    
+    Ploter::GridLoader    loader;
+    
+    if ( ! loader.open( arguments[1] ) ) {
+        
+        std::fprintf( stderr,  "データファイルを読み込めません。 -- %s\n",  arguments[1] );
+        
+        return  1;
+    }
+    
+    
+    Ploter::GridStore    store;
+    
+    if ( ! loader.read( store ) ) {
+        
+        std::fprintf( stderr,  "データファイルの形式が不正です。 -- %s\n",  arguments[1] );
+        
+        return  1;
+    }
+    
+    
+    if ( ! Ploter::writeBinaryGrid( arguments[2],  store ) ) {
+        
+        std::fprintf( stderr,  "ファイルに書き込めません。 -- %s\n",  arguments[2] );
+        
+        return  1;
+    }
+    
+    
+    Ploter::GridPyramid    pyramid;
+    std::string            cachePath = Ploter::GridPyramid::getCachePath( arguments[2] );
+    
+    pyramid.build( store,  0 );
+    
+    if ( pyramid.getLevelNumber() > 1 && ! pyramid.save( arguments[2] ) ) {
+        
+        std::fprintf( stderr,  "ファイルに書き込めません。 -- %s\n",  cachePath.c_str() );
+        
+        return  1;
+    }
+    
+    return  0;
+}
@@ -0,0 +1,76 @@
+/**
+ * 
+ * @file   Render.cpp
+ * @author 村田 裕一
+ * @brief  ウィンドウを使わずにグラフを描き、PNG・PPM形式の画像か、SVG・PDF形式の図に書き込む。
+ * 
+ *///---------------------------------------------------------------------------
+#include    <cstdio>
+#include    <cstdlib>
+#include    "../Ploter/Ploter.h"
+#include    "../Ploter/Rasterizer.h"
+#include    "../Ploter/VectorSink.h"
+#include    "../Ploter/ImageFile.h"
+
+
+/**
+ *
+ * @brief メイン関数。
+ *
+ *///---------------------------------------------------------------------------
+int  main( int  argumentNumber,   char**  arguments ) {
+    
+    if ( argumentNumber < 3 || argumentNumber > 5 ) {
+        
+        std::fprintf( stderr,  "使い方 : 3dgRender データファイル 出力ファイル(*.png|*.ppm|*.svg|*.pdf) [画像の大きさ(既定値:1024)] [スレッド数(既定値:0=プロセッサ数)]\n" );
+        
+        return  1;
+    }
+    
+    int          size         = ( argumentNumber > 3 ) ? std::atoi( arguments[3] ) : 1024;
+    std::size_t  threadNumber = ( argumentNumber > 4 ) ? std::atoi( arguments[4] ) : 0;
+    
+    if ( size <= 0 ) {
+        
+        std::fprintf( stderr,  "画像の大きさが不正です。 -- %s\n",  arguments[3] );
+        
+        return  1;
+    }
+    
+    
+    std::string                                    extension = Ploter::getExtension( arguments[2] );
+    boost::shared_ptr<Ploter::SoftwareRenderSink>  raster;
+    boost::shared_ptr<Ploter::VectorRenderSink>    figure;
+    
+    if      ( extension == ".svg" ) { figure.reset( new Ploter::SvgRenderSink( arguments[2], size, size ) );       }
+    else if ( extension == ".pdf" ) { figure.reset( new Ploter::PdfRenderSink( arguments[2], size, size ) );       }
+    else                            { raster.reset( new Ploter::SoftwareRenderSink( size, size, threadNumber ) ); }
+    
+    
+    Ploter::Ploter  ploter;
+    
+    if ( raster ) { ploter.setSink( raster ); }
+    else          { ploter.setSink( figure ); }
+    
+    if ( ! ploter.set( arguments[1] ) ) {
+        
+        std::fprintf( stderr,  "データファイルを読み込めません。 -- %s\n",  arguments[1] );
+        
+        return  1;
+    }
+    
+    ploter.resize( size, size );
+    
+    while ( ploter.refine() ) {}    //  段階的に細かくする場合は、最後まで細かくしてから書き込む。
+    
+    
+    if ( raster ? ! Ploter::writeImage( arguments[2],  raster->getWidth(),  raster->getHeight(),  raster->getPixels() )
+                : ! figure->isGood() ) {
+        
+        std::fprintf( stderr,  "ファイルに書き込めません。 -- %s\n",  arguments[2] );
+        
+        return  1;
+    }
+    
+    return  0;
+}